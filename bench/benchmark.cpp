@@ -0,0 +1,70 @@
+#include "benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+
+namespace Benchmark {
+
+BenchmarkRunner::BenchmarkRunner(double const minimumDurationInMS, uint32_t const minimumRepetitions) :
+  minimumDurationInMS(minimumDurationInMS), minimumRepetitions(std::max(1u, minimumRepetitions))
+{
+}
+
+void BenchmarkRunner::run(BenchmarkCase const& benchmarkCase, std::function<void()> const& function, std::function<void()> const& setup)
+{
+  if (setup) {
+    setup();
+  }
+  function();
+
+  std::vector<double> times{};
+  double totalTime = 0.0;
+
+  while (times.size() < minimumRepetitions || totalTime < minimumDurationInMS) {
+    if (setup) {
+      setup();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    function();
+    auto time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    times.push_back(time);
+    totalTime += time;
+  }
+
+  std::sort(times.begin(), times.end());
+  auto median = times[times.size() / 2];
+
+  results.emplace_back(BenchmarkResult{
+    benchmarkCase,
+    static_cast<uint32_t>(times.size()),
+    times.front(),
+    median,
+    (median > 0.0) ? 1000.0 * benchmarkCase.numberOfDataPoints / median : 0.0
+  });
+
+  std::cerr << benchmarkCase.name << " (data points: " << benchmarkCase.numberOfDataPoints << ", inputs: " << benchmarkCase.numberOfInputs <<
+               ", outputs: " << benchmarkCase.numberOfOutputs << ", layers: " << benchmarkCase.numberOfLayers << ", nodes: " <<
+               benchmarkCase.numberOfNodesPerLayer << ") -- median: " << median << " ms, minimum: " << times.front() << " ms" << std::endl;
+}
+
+void BenchmarkRunner::saveResults(std::ostream& stream) const
+{
+  stream << std::setprecision(std::numeric_limits<double>::max_digits10);
+
+  for (auto const& [benchmarkCase, repetitions, minimumTimeInMS, medianTimeInMS, dataPointsPerSecond] : results) {
+    stream << "{\"benchmark\": \"" << benchmarkCase.name << "\", \"dataPoints\": " << benchmarkCase.numberOfDataPoints <<
+              ", \"inputs\": " << benchmarkCase.numberOfInputs << ", \"outputs\": " << benchmarkCase.numberOfOutputs <<
+              ", \"layers\": " << benchmarkCase.numberOfLayers << ", \"nodes\": " << benchmarkCase.numberOfNodesPerLayer <<
+              ", \"repetitions\": " << repetitions << ", \"minimumTimeInMS\": " << minimumTimeInMS << ", \"medianTimeInMS\": " << medianTimeInMS <<
+              ", \"dataPointsPerSecond\": " << dataPointsPerSecond << "}\n";
+  }
+
+  stream.flush();
+}
+
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Benchmark {
+
+/*
+ * Name and dimensions of one measured case. Dimensions which do not apply to the benchmark are 0.
+ */
+class BenchmarkCase
+{
+public:
+  std::string name;
+  uint64_t numberOfDataPoints;
+  uint32_t numberOfInputs;
+  uint32_t numberOfOutputs;
+  uint32_t numberOfLayers;
+  uint32_t numberOfNodesPerLayer;
+};
+
+class BenchmarkResult
+{
+public:
+  BenchmarkCase benchmarkCase;
+  uint32_t repetitions;
+  double minimumTimeInMS;
+  double medianTimeInMS;
+  double dataPointsPerSecond; // based on the median time
+};
+
+class BenchmarkRunner
+{
+public:
+  /*
+   * Constructor of the BenchmarkRunner class.
+   * Every case is repeated until it ran at least the given number of times and the measured times sum up to the given duration.
+   */
+  BenchmarkRunner(double minimumDurationInMS, uint32_t minimumRepetitions);
+
+public:
+  /*
+   * Measures the given function. The setup function runs before every repetition and is not measured.
+   * One additional repetition before the measurement warms up the caches and the allocator.
+   */
+  void run(BenchmarkCase const& benchmarkCase, std::function<void()> const& function, std::function<void()> const& setup = {});
+  /*
+   * Writes all results as JSON lines (one object per case) to the given stream.
+   */
+  void saveResults(std::ostream& stream) const;
+
+private:
+  double minimumDurationInMS;
+  uint32_t minimumRepetitions;
+  std::vector<BenchmarkResult> results {};
+};
+
+}
@@ -0,0 +1,160 @@
+#include "formatcheck.h"
+#include "Utilities/fileparser.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <sstream>
+
+namespace Benchmark {
+
+namespace {
+
+const char INVALID_VALUE_PREFIX[] = "x";
+
+// Values whose formatting depends on the switch between fixed and scientific notation, the rounding to 6 significant digits or the exponent range:
+const std::vector<TensorDataType> EDGE_VALUES = {
+  0.0, -0.0, 1.0, -1.0, 0.1, 0.5, 1.0 / 3.0, 2.0 / 3.0, 0.0001, -0.0001, 0.000099999951, 1e-5, 0.000123456789, 65536.0, 123455.5, 123456.0,
+  999999.5, 1234567.0, 9999995.0, 1.0000005, 9.9999995, 1e15, 1e16, 1e21, 1e100, 1.5e300, -2.5e-300, -1.23456789e-308,
+  std::numeric_limits<TensorDataType>::min(), std::numeric_limits<TensorDataType>::denorm_min(), std::numeric_limits<TensorDataType>::max(),
+  std::numeric_limits<TensorDataType>::lowest()
+};
+
+[[nodiscard]]
+std::string readFile(std::string const& filePath)
+{
+  std::ifstream file(filePath, std::ios::binary);
+  std::ostringstream content;
+  content << file.rdbuf();
+  return content.str();
+}
+
+/*
+ * Returns the data as the former FileParser::SaveData wrote it: every value formatted with operator<< and its default precision.
+ */
+[[nodiscard]]
+std::string formatWithStream(DataVector const& data, std::string const& fileHeader)
+{
+  std::ostringstream stream;
+  stream << fileHeader << "\n";
+
+  for (auto const& [inputTensor, outputTensor] : data) {
+    auto const inputs = inputTensor.to(TORCH_DATA_TYPE).contiguous();
+    auto const outputs = outputTensor.to(TORCH_DATA_TYPE).contiguous();
+    auto const* inputValues = inputs.data_ptr<TensorDataType>();
+    auto const* outputValues = outputs.data_ptr<TensorDataType>();
+
+    stream << inputValues[0];
+    for (int64_t i = 1; i < inputs.size(0); ++i) {
+      stream << ", " << inputValues[i];
+    }
+    for (int64_t i = 0; i < outputs.size(0); ++i) {
+      stream << ", " << outputValues[i];
+    }
+    stream << "\n";
+  }
+
+  return stream.str();
+}
+
+/*
+ * Returns data points with the given columns, every edge value is in every column once.
+ */
+[[nodiscard]]
+DataVector createEdgeValueFixture(int64_t const numberOfInputs, int64_t const numberOfOutputs)
+{
+  auto const numberOfColumns = numberOfInputs + numberOfOutputs;
+
+  DataVector fixture{};
+  for (size_t row = 0; row < EDGE_VALUES.size(); ++row) {
+    auto values = torch::empty({numberOfColumns}, TORCH_DATA_TYPE);
+    for (int64_t column = 0; column < numberOfColumns; ++column) {
+      values.data_ptr<TensorDataType>()[column] = EDGE_VALUES[(row + static_cast<size_t>(column)) % EDGE_VALUES.size()];
+    }
+    fixture.emplace_back(values.narrow(0, 0, numberOfInputs).clone(), values.narrow(0, numberOfInputs, numberOfOutputs).clone());
+  }
+
+  return fixture;
+}
+
+/*
+ * Returns the line with the given number (starting with 1) of the given text.
+ */
+[[nodiscard]]
+std::string lineOf(std::string const& text, size_t const lineNumber)
+{
+  std::istringstream stream(text);
+  std::string line;
+  for (size_t i = 0; i < lineNumber; ++i) {
+    if (!std::getline(stream, line)) {
+      return std::string();
+    }
+  }
+  return line;
+}
+
+}
+
+bool checkSavedDataFormat(DataVector const& data, std::string const& fileHeader, std::string const& filePath)
+{
+  if (data.empty()) {
+    return true;
+  }
+
+  auto const fixture = createEdgeValueFixture(data.front().first.size(0), data.front().second.size(0));
+  for (auto const* checkedData : {&data, &fixture}) {
+    Utilities::FileParser::SaveData(*checkedData, filePath, fileHeader);
+    auto const savedContent = readFile(filePath);
+    auto const expectedContent = formatWithStream(*checkedData, fileHeader);
+    if (savedContent == expectedContent) {
+      continue;
+    }
+
+    auto const difference = std::mismatch(savedContent.begin(), savedContent.end(), expectedContent.begin(), expectedContent.end());
+    auto const lineNumber = static_cast<size_t>(std::count(savedContent.begin(), difference.first, '\n')) + 1;
+    std::cerr << "Error: FileParser::SaveData differs from operator<< in line " << lineNumber << ":\n  saved:    " << lineOf(savedContent, lineNumber)
+              << "\n  expected: " << lineOf(expectedContent, lineNumber) << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool checkParseErrorLines(std::string const& filePath, uint32_t const numberOfInputs, uint32_t const numberOfOutputs)
+{
+  auto const content = readFile(filePath);
+  auto const headerEnd = content.find('\n');
+  if (headerEnd == std::string::npos || headerEnd + 1 == content.size()) {
+    std::cerr << "Error: " << filePath << " has no data lines." << std::endl;
+    return false;
+  }
+  auto const body = content.substr(headerEnd + 1);
+
+  std::vector<size_t> lineBegins{0};
+  for (auto end = body.find('\n'); end != std::string::npos && end + 1 < body.size(); end = body.find('\n', end + 1)) {
+    lineBegins.push_back(end + 1);
+  }
+
+  std::vector<uint32_t> columns(static_cast<size_t>(numberOfInputs) + numberOfOutputs);
+  std::iota(columns.begin(), columns.end(), 0);
+
+  for (auto const dataLine : {size_t(0), lineBegins.size() / 2, lineBegins.size() - 1}) {
+    auto invalidBody = body;
+    invalidBody.insert(lineBegins[dataLine], INVALID_VALUE_PREFIX);
+
+    Utilities::FileParser::ParseError error{};
+    auto const parsedData = Utilities::FileParser::ParseLines(invalidBody, 2, numberOfInputs, numberOfOutputs, columns, filePath, nullptr, &error);
+    auto const expectedLineNumber = dataLine + 2; // the file header is line 1
+    if (parsedData || error.first != expectedLineNumber) {
+      std::cerr << "Error: The invalid value in line " << expectedLineNumber << " of " << filePath << " was "
+                << (parsedData ? std::string("not reported.") : "reported in line " + std::to_string(error.first) + ".") << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Utilities/constants.h"
+
+namespace Benchmark {
+
+/*
+ * Returns true if FileParser::SaveData writes the given data byte for byte like the former writer, which formatted every value with operator<<.
+ * A fixture with edge values (signed zeros, rounding boundaries, subnormal and extreme values) of the same columns is checked as well.
+ * The given file path is overwritten. Prints the first differing line otherwise.
+ */
+[[nodiscard]]
+bool checkSavedDataFormat(DataVector const& data, std::string const& fileHeader, std::string const& filePath);
+/*
+ * Returns true if FileParser::ParseLines reports the line number (the file header is line 1) of an invalid value in the first, a middle
+ * and the last data line of the given saved data file. The middle and the last line are parsed by other threads if the file is large enough.
+ */
+[[nodiscard]]
+bool checkParseErrorLines(std::string const& filePath, uint32_t numberOfInputs, uint32_t numberOfOutputs);
+
+}
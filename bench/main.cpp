@@ -0,0 +1,229 @@
+#include "benchmark.h"
+#include "formatcheck.h"
+#include "syntheticdata.h"
+#include "NeuralNetwork/logic.h"
+#include "NeuralNetwork/networkanalyzer.h"
+#include "NeuralNetwork/neuralnetwork.h"
+#include "Utilities/dataprocessor.h"
+#include "Utilities/fileparser.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+const uint64_t DEFAULT_SEED = 42;
+const double MINIMUM_DURATION_IN_MS = 500.0;
+const uint32_t MINIMUM_REPETITIONS = 3;
+const uint32_t NUMBER_OF_LAYERS = 2;
+
+// A training epoch performs one optimizer step per data point, larger data sets take too long for a benchmark:
+const uint64_t MAXIMUM_TRAINING_DATA_POINTS = 10000;
+
+const std::string CLI_HELP_TEXT = {
+  std::string("List of possible commandline parameters:\n") +
+  "--help | -h           : Output this text message.\n" +
+  "--quick               : Only runs the smallest data set and network size.\n" +
+  "--seed <uint64>       : Sets the seed of the synthetic data and the network initialization. Default: " + std::to_string(DEFAULT_SEED) + "\n" +
+  "--threads X | -t X    : Sets the number of used threads to X. Default: " + std::to_string(torch::get_num_threads()) + "\n" +
+  "--out <filepath>      : Saves the results as JSON lines to the given file instead of the standard output.\n"
+};
+
+}
+
+int main(int argc, char* argv[])
+{
+  bool quick = false;
+  uint64_t seed = DEFAULT_SEED;
+  std::string outputFilePath{};
+
+  for (int i = 1; i < argc; ++i) {
+    std::string inputString(argv[i]);
+    try {
+      if (inputString == "--help" || inputString == "-h") {
+        std::cout << CLI_HELP_TEXT << std::endl;
+        return 0;
+      } else if (inputString == "--quick") {
+        quick = true;
+      } else if (inputString == "--seed" && i + 1 < argc) {
+        seed = std::stoull(argv[++i]);
+      } else if ((inputString == "--threads" || inputString == "-t") && i + 1 < argc) {
+        torch::set_num_threads(std::stoi(argv[++i]));
+      } else if (inputString == "--out" && i + 1 < argc) {
+        outputFilePath = argv[++i];
+      } else {
+        std::cout << "Unknown or incomplete commandline parameter: " << inputString << "\n" << CLI_HELP_TEXT << std::endl;
+        return 1;
+      }
+    } catch (std::exception const&) {
+      std::cout << "Could not parse the value of " << inputString << std::endl;
+      return 1;
+    }
+  }
+
+  auto const dataSizes = quick ? std::vector<uint64_t>{1000} : std::vector<uint64_t>{1000, 10000, 100000};
+  auto const dataWidths = quick ? std::vector<std::pair<uint32_t, uint32_t>>{{3, 1}} : std::vector<std::pair<uint32_t, uint32_t>>{{3, 1}, {8, 4}};
+  auto const networkWidths = quick ? std::vector<uint32_t>{32} : std::vector<uint32_t>{32, 128, 512};
+
+  auto const directory = std::filesystem::temp_directory_path() / ("NNApproximatorBench_" + std::to_string(seed));
+  std::filesystem::create_directories(directory);
+
+  Benchmark::BenchmarkRunner runner(MINIMUM_DURATION_IN_MS, MINIMUM_REPETITIONS);
+  bool checksPassed = true;
+
+  for (auto const numberOfDataPoints : dataSizes) {
+    for (auto const& dataWidth : dataWidths) {
+      auto const numberOfInputs = dataWidth.first;
+      auto const numberOfOutputs = dataWidth.second;
+      auto const data = Benchmark::generateSyntheticData(numberOfDataPoints, numberOfInputs, numberOfOutputs, seed);
+      auto const fileHeader = Benchmark::createFileHeader(numberOfInputs, numberOfOutputs);
+      auto const filePath = (directory / ("data_" + std::to_string(numberOfDataPoints) + "_" + std::to_string(numberOfInputs) + "_" +
+                                          std::to_string(numberOfOutputs) + ".csv")).string();
+      auto const dataCase = Benchmark::BenchmarkCase{"", numberOfDataPoints, numberOfInputs, numberOfOutputs, 0, 0};
+
+      // The output files must stay byte-compatible with the former operator<< writer and the parse errors must name the right lines:
+      checksPassed = Benchmark::checkSavedDataFormat(data, fileHeader, filePath) && checksPassed;
+      Utilities::FileParser::SaveData(data, filePath, fileHeader);
+      checksPassed = Benchmark::checkParseErrorLines(filePath, numberOfInputs, numberOfOutputs) && checksPassed;
+
+      // Data handling:
+      auto benchmarkCase = dataCase;
+      benchmarkCase.name = "FileParser::SaveData";
+      runner.run(benchmarkCase, [&]() { Utilities::FileParser::SaveData(data, filePath, fileHeader); });
+
+      benchmarkCase.name = "FileParser::ParseInputFile";
+      runner.run(benchmarkCase, [&]() {
+        std::string parsedFileHeader{};
+        auto parsedData = Utilities::FileParser::ParseInputFile(filePath, numberOfInputs, numberOfOutputs, parsedFileHeader);
+        if (!parsedData || parsedData->size() != numberOfDataPoints) {
+          std::cerr << "Error: The synthetic data file could not be parsed." << std::endl;
+        }
+      });
+
+      benchmarkCase.name = "FileParser::LoadInputData (with statistics)";
+      runner.run(benchmarkCase, [&]() {
+        Utilities::ProgramOptions loadOptions{};
+        loadOptions.InputDataFilePath = filePath;
+        loadOptions.NumberOfInputVariables = numberOfInputs;
+        loadOptions.NumberOfOutputVariables = numberOfOutputs;
+
+        std::string parsedFileHeader{};
+        Utilities::DataStatistics statistics{};
+        auto parsedData = Utilities::FileParser::LoadInputData(loadOptions, parsedFileHeader, statistics);
+        (void) parsedData;
+      });
+
+      MinMaxValues minMax{};
+      benchmarkCase.name = "DataProcessor::CalculateMinMax";
+      runner.run(benchmarkCase, [&]() { Utilities::DataProcessor::CalculateMinMax(data, minMax); });
+
+      DataVector normalizedData{};
+      benchmarkCase.name = "DataProcessor::Normalize";
+      runner.run(benchmarkCase, [&]() { Utilities::DataProcessor::Normalize(normalizedData, minMax, 0.0, 1.0); }, [&]() {
+        normalizedData.clear();
+        for (auto const& [inputTensor, outputTensor] : data) {
+          normalizedData.emplace_back(inputTensor.clone(), outputTensor.clone());
+        }
+      });
+
+      // The same data points as rows of two tensors (like the parsed data) are normalized at once:
+      DataVector batchNormalizedData{};
+      Utilities::Normalizer const inputNormalizer(minMax.first, 0.0, 1.0);
+      Utilities::Normalizer const outputNormalizer(minMax.second, 0.0, 1.0);
+      benchmarkCase.name = "DataProcessor::Normalize (rows of one tensor)";
+      runner.run(benchmarkCase, [&]() { Utilities::DataProcessor::Normalize(batchNormalizedData, inputNormalizer, outputNormalizer); }, [&]() {
+        batchNormalizedData.clear();
+        auto [inputs, outputs] = Utilities::DataProcessor::StackData(data);
+        auto inputRows = inputs.unbind(0);
+        auto outputRows = outputs.unbind(0);
+        for (size_t i = 0; i < inputRows.size(); ++i) {
+          batchNormalizedData.emplace_back(inputRows[i], outputRows[i]);
+        }
+      });
+
+      torch::Tensor normalizedInputs{};
+      torch::Tensor normalizedOutputs{};
+      std::tie(normalizedInputs, normalizedOutputs) = Utilities::DataProcessor::StackData(normalizedData);
+      torch::Tensor denormalizedOutputs{};
+      benchmarkCase.name = "DataProcessor::Denormalize";
+      runner.run(benchmarkCase, [&]() { Utilities::DataProcessor::Denormalize(denormalizedOutputs, minMax.second, 0.0, 1.0); },
+                 [&]() { denormalizedOutputs = normalizedOutputs.clone(); });
+
+      benchmarkCase.name = "Normalizer::denormalize (limited values)";
+      runner.run(benchmarkCase, [&]() { outputNormalizer.denormalize(denormalizedOutputs, true); },
+                 [&]() { denormalizedOutputs = normalizedOutputs.clone(); });
+
+      // Network:
+      for (auto const numberOfNodes : networkWidths) {
+        auto networkCase = dataCase;
+        networkCase.numberOfLayers = NUMBER_OF_LAYERS;
+        networkCase.numberOfNodesPerLayer = numberOfNodes;
+
+        torch::manual_seed(seed);
+        NeuralNetwork::Network network(numberOfInputs, numberOfOutputs, std::vector<uint32_t>(NUMBER_OF_LAYERS, numberOfNodes));
+
+        networkCase.name = "NetworkImpl::forward";
+        runner.run(networkCase, [&]() {
+          torch::NoGradGuard noGradGuard;
+          auto prediction = network->forward(normalizedInputs);
+          (void) prediction;
+        });
+
+        NeuralNetwork::NetworkAnalyzer analyzer(network, [&](torch::Tensor const&, torch::Tensor& outputTensor, bool limitValues) {
+          outputNormalizer.denormalize(outputTensor, limitValues);
+        }, [](torch::Tensor const&, torch::Tensor&) {});
+
+        networkCase.name = "NetworkAnalyzer::calculateMetrics";
+        runner.run(networkCase, [&]() {
+          auto metrics = analyzer.calculateMetrics(normalizedData);
+          (void) metrics;
+        });
+
+        if (numberOfDataPoints > MAXIMUM_TRAINING_DATA_POINTS) {
+          continue;
+        }
+
+        // One epoch of the default training (one optimizer step per data point) including the loss evaluation:
+        Utilities::ProgramOptions options{};
+        options.NumberOfInputVariables = numberOfInputs;
+        options.NumberOfOutputVariables = numberOfOutputs;
+        options.NumberOfLayers = NUMBER_OF_LAYERS;
+        options.NumberOfNodesPerLayer = numberOfNodes;
+        options.NumberOfThreads = torch::get_num_threads();
+        options.ShowProgressDuringTraining = false;
+        options.RNGSeed = seed;
+
+        DataVector trainingData{};
+        for (auto const& [inputTensor, outputTensor] : data) {
+          trainingData.emplace_back(inputTensor.clone(), outputTensor.clone());
+        }
+
+        NeuralNetwork::Logic logic{};
+        auto const statistics = Utilities::DataProcessor::CollectStatistics(trainingData);
+        if (!logic.prepareData(options, trainingData, statistics) || !logic.prepareTraining(options, trainingData)) {
+          std::cerr << "Error: The training could not be prepared." << std::endl;
+          continue;
+        }
+
+        networkCase.name = "Logic::train (one epoch)";
+        runner.run(networkCase, [&]() { logic.train(logic.numberOfTrainedEpochs() + 1, false); });
+      }
+    }
+  }
+
+  std::filesystem::remove_all(directory);
+
+  if (outputFilePath.empty()) {
+    runner.saveResults(std::cout);
+  } else {
+    std::ofstream outputFile(outputFilePath);
+    runner.saveResults(outputFile);
+  }
+
+  if (!checksPassed) {
+    std::cerr << "Error: At least one output format or parse error check failed." << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,59 @@
+#include "syntheticdata.h"
+
+#include <cmath>
+#include <random>
+
+namespace Benchmark {
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+}
+
+DataVector generateSyntheticData(uint64_t const numberOfDataPoints, uint32_t const numberOfInputs, uint32_t const numberOfOutputs, uint64_t const seed)
+{
+  std::mt19937_64 gen(seed);
+  std::uniform_real_distribution<TensorDataType> dis(0.0, 1.0);
+
+  DataVector data{};
+  data.reserve(numberOfDataPoints);
+
+  std::vector<TensorDataType> inputValues(numberOfInputs);
+  std::vector<TensorDataType> outputValues(numberOfOutputs);
+
+  for (uint64_t i = 0; i < numberOfDataPoints; ++i) {
+    for (auto& value : inputValues) {
+      value = dis(gen);
+    }
+
+    // Every output depends on all inputs with a different frequency:
+    for (uint32_t output = 0; output < numberOfOutputs; ++output) {
+      TensorDataType sum = 0.0;
+      for (uint32_t input = 0; input < numberOfInputs; ++input) {
+        sum += std::sin(PI * (input + 1) * (output + 1) * inputValues[input]);
+      }
+      outputValues[output] = 2.0 + sum / numberOfInputs;
+    }
+
+    data.emplace_back(torch::tensor(inputValues, TORCH_DATA_TYPE), torch::tensor(outputValues, TORCH_DATA_TYPE));
+  }
+
+  return data;
+}
+
+std::string createFileHeader(uint32_t const numberOfInputs, uint32_t const numberOfOutputs)
+{
+  std::string header{};
+
+  for (uint32_t i = 1; i <= numberOfInputs; ++i) {
+    header += ((i == 1) ? "x" : ", x") + std::to_string(i);
+  }
+  for (uint32_t i = 1; i <= numberOfOutputs; ++i) {
+    header += ", y" + std::to_string(i);
+  }
+
+  return header;
+}
+
+}
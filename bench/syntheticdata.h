@@ -0,0 +1,19 @@
+#pragma once
+
+#include "Utilities/constants.h"
+
+namespace Benchmark {
+
+/*
+ * Generates data points with uniformly distributed inputs in [0, 1] and smooth outputs (sums of sine functions) in [1, 3],
+ * so every scaling option can be applied to them. The same seed always results in the same data.
+ */
+[[nodiscard]]
+DataVector generateSyntheticData(uint64_t numberOfDataPoints, uint32_t numberOfInputs, uint32_t numberOfOutputs, uint64_t seed);
+/*
+ * Creates the header of a data file with the given number of input and output columns (x1, x2, ..., y1, y2, ...).
+ */
+[[nodiscard]]
+std::string createFileHeader(uint32_t numberOfInputs, uint32_t numberOfOutputs);
+
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "NeuralNetwork/neuralnetwork.h"
+#include "Utilities/constants.h"
+
+#include <limits>
+#include <optional>
+
+namespace NeuralNetwork {
+
+/*
+ * Everything besides the network and optimizer parameters which is needed to continue an interrupted training.
+ */
+class TrainingState
+{
+public:
+  uint32_t epoch = 0; // number of finished epochs
+  uint64_t elapsedTimeInMS = 0;
+  uint64_t numberOfDataPoints = 0;
+  uint64_t splitSeed = 0;
+  uint64_t shuffleSeed = 0;
+
+  double currentMeanError = 0.0;
+  double trainingPassMeanError = 0.0;
+  double exactMeanError = 0.0; // last exact mean squared error, which the stopping criteria compare (see --lossEvaluationInterval)
+  bool continueTraining = true;
+  uint32_t numberOfDeteriorationsInRow = 0;
+
+  double learnRate = 0.0;
+  std::vector<double> schedulerState {};
+
+  double bestValidationError = std::numeric_limits<double>::infinity();
+  uint32_t bestValidationEpoch = 0;
+  uint32_t numberOfValidationsWithoutImprovement = 0;
+  std::vector<torch::Tensor> bestNetworkState {};
+
+  std::string randomGeneratorState {};
+  ProgressVector progress {};
+};
+
+/*
+ * Saves the network and optimizer parameters together with the training state to a checkpoint in the given directory.
+ * The checkpoint is first written to a temporary file and then renamed, so an interrupted write never replaces the last valid checkpoint.
+ * Returns false if the checkpoint could not be written.
+ */
+bool saveCheckpoint(FilePath const& directory, Network const& network, torch::optim::Optimizer const& optimizer, TrainingState const& state);
+/*
+ * Loads the training state of the checkpoint in the given directory. Returns std::nullopt if there is no valid checkpoint.
+ */
+[[nodiscard]]
+std::optional<TrainingState> loadTrainingState(FilePath const& directory);
+/*
+ * Loads the network and optimizer parameters of the checkpoint in the given directory.
+ * The network must have the same configuration and data type as the network which was saved. Returns false on failure.
+ */
+[[nodiscard]]
+bool loadCheckpointParameters(FilePath const& directory, Network& network, torch::optim::Optimizer& optimizer);
+
+}
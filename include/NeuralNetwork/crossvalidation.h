@@ -0,0 +1,33 @@
+#pragma once
+
+#include "NeuralNetwork/logic.h"
+#include "Utilities/constants.h"
+#include "Utilities/programoptions.h"
+
+namespace NeuralNetwork {
+
+class CrossValidation
+{
+public:
+  /*
+   * Performs a K-fold cross-validation with the network options which the user set via the command line interface:
+   * - the input file is parsed, scaled and normalized once
+   * - the data points are assigned to K folds with the seed of the user, so the same seed always results in the same folds
+   * - K networks are trained concurrently (at most one per thread), each network is validated with one fold and trained with the other folds
+   *   (all networks share the tensors of the loaded data, stacked data is only stacked once)
+   * - the metrics of each fold and their mean and standard deviation are printed
+   */
+  [[nodiscard]]
+  bool performCrossValidation(Utilities::ProgramOptions const& options);
+
+private:
+  /*
+   * Prints the metrics of every fold and their mean and standard deviation.
+   */
+  void outputResults(std::vector<std::pair<NetworkMetrics, NetworkMetrics>> const& foldMetrics, std::vector<uint32_t> const& foldEpochs) const;
+
+private:
+  Utilities::ProgramOptions options {};
+};
+
+}
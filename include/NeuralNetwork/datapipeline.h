@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Utilities/constants.h"
+#include "Utilities/spscqueue.h"
+
+#include <atomic>
+#include <random>
+#include <thread>
+
+namespace NeuralNetwork {
+
+/*
+ * Returns the random number generator of the given epoch and stream (e.g. a worker). It only depends on its arguments,
+ * so a resumed training shuffles the data points in the same order as an uninterrupted one.
+ */
+[[nodiscard]]
+std::mt19937_64 epochGenerator(uint64_t seed, uint32_t epoch, uint32_t stream = 0);
+/*
+ * Returns the given rows (kLong) in the shuffled order of the given epoch and stream (see epochGenerator).
+ */
+[[nodiscard]]
+torch::Tensor epochPermutation(torch::Tensor const& rows, uint64_t seed, uint32_t epoch, uint32_t stream = 0);
+
+/*
+ * Assembles the training batches of every epoch on a background thread.
+ * The order of the data points is shuffled in every epoch (see epochPermutation).
+ */
+class DataPipeline
+{
+public:
+  /*
+   * Constructor which starts the background thread. The given tensors contain the training data points stacked row-wise.
+   * If training rows are given, only these rows are trained (e.g. the folds of a cross-validation share the tensors), otherwise all rows.
+   * Up to the given capacity of batches are assembled in advance, the first assembled epoch has the given epoch number.
+   */
+  DataPipeline(torch::Tensor const& inputs, torch::Tensor const& outputs, torch::Tensor const& trainingRows, int64_t batchSize, size_t capacity,
+               uint64_t seed, uint32_t firstEpoch);
+  /*
+   * Destructor which stops the background thread.
+   */
+  ~DataPipeline();
+
+  DataPipeline(DataPipeline const&) = delete;
+  DataPipeline& operator=(DataPipeline const&) = delete;
+
+public:
+  /*
+   * Returns the next batch (input and output tensor [rows, columns]) of the current epoch.
+   * Returns std::nullopt at the end of the epoch, the following call returns the first batch of the next epoch.
+   */
+  [[nodiscard]]
+  std::optional<std::pair<torch::Tensor, torch::Tensor>> next();
+
+private:
+  /*
+   * Runs on the background thread and assembles the batches of one epoch after another until the pipeline is stopped.
+   */
+  void produce();
+
+private:
+  torch::Tensor inputs;
+  torch::Tensor outputs;
+  torch::Tensor trainingRows;
+  int64_t batchSize;
+  uint64_t seed;
+  uint32_t firstEpoch;
+
+  // A batch with undefined tensors marks the end of an epoch:
+  Utilities::SpscQueue<std::pair<torch::Tensor, torch::Tensor>> queue;
+  std::atomic<bool> stopped {false};
+  std::thread producer {};
+};
+
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Utilities/programoptions.h"
+
+#include <limits>
+#include <optional>
+
+namespace NeuralNetwork {
+
+class LearnRateScheduler
+{
+public:
+  /*
+   * Constructor of the LearnRateScheduler class. Uses the schedule and its parameters which the user set via the command line interface.
+   */
+  explicit LearnRateScheduler(Utilities::ProgramOptions const& options);
+
+public:
+  /*
+   * Returns the learning rate for the given epoch [1, ..].
+   * The warmup increases the learning rate linearly, after that the selected schedule is applied.
+   * The plateau schedule uses the given mean squared error, which should be measured at the beginning of the epoch. Without a new
+   * measurement, the plateau state does not change, so its patience counts the measurements without improvement.
+   * Should be called exactly once per epoch.
+   */
+  [[nodiscard]]
+  double learnRateForEpoch(uint32_t epoch, std::optional<double> meanSquaredError);
+  /*
+   * Returns true if the learning rate can change during the training.
+   */
+  [[nodiscard]]
+  bool isActive() const;
+  /*
+   * Returns the internal state of the plateau schedule, so an interrupted training can be continued with restoreState.
+   */
+  [[nodiscard]]
+  std::vector<double> state() const;
+  /*
+   * Restores the internal state which was returned by state().
+   */
+  void restoreState(std::vector<double> const& state);
+
+public:
+  /*
+   * Sets the learning rate of all parameter groups of the given optimizer.
+   */
+  static void applyLearnRate(torch::optim::Optimizer& optimizer, double learnRate);
+
+private:
+  Utilities::LearnRateScheduleType schedule;
+  double baseLearnRate;
+  double minLearnRate;
+  double gamma;
+  uint32_t warmupEpochs;
+  uint32_t stepSize;
+  uint32_t patience;
+  uint32_t numberOfEpochs;
+
+  double plateauLearnRate;
+  double bestMeanSquaredError = std::numeric_limits<double>::infinity();
+  uint32_t evaluationsWithoutImprovement = 0;
+};
+
+}
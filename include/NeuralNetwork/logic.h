@@ -1,12 +1,39 @@
 #pragma once
 
+#include "NeuralNetwork/checkpoint.h"
+#include "NeuralNetwork/datapipeline.h"
+#include "NeuralNetwork/learnratescheduler.h"
 #include "NeuralNetwork/networkanalyzer.h"
 #include "NeuralNetwork/neuralnetwork.h"
+#include "NeuralNetwork/paralleltrainer.h"
+#include "NeuralNetwork/progressevaluator.h"
 #include "Utilities/constants.h"
+#include "Utilities/datastatistics.h"
+#include "Utilities/datastream.h"
+#include "Utilities/normalizer.h"
 #include "Utilities/programoptions.h"
+#include "Utilities/telemetry.h"
+
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <random>
 
 namespace NeuralNetwork {
 
+/*
+ * Training data which is stacked once and shared by several logics (e.g. the folds of a cross-validation or the trials of a sweep).
+ * The tensors [rows, columns] contain all data points, the training rows (kLong) select the data points which one logic trains.
+ * Without training rows, the logic selects the rows of its random validation split (or all rows without validation).
+ */
+class SharedTrainingData
+{
+public:
+  torch::Tensor inputs;
+  torch::Tensor outputs;
+  torch::Tensor trainingRows;
+};
+
 class Logic
 {
 public:
@@ -15,12 +42,147 @@ public:
    */
   [[nodiscard]]
   bool performUserRequest(Utilities::ProgramOptions const& options);
+  /*
+   * Trains the network on the input file without loading it completely (see --memoryBudget). The data is read in chunks in every pass:
+   * a first pass calculates the min/max values (if they are not known), every epoch streams the scaled and normalized chunks into the training.
+   * Only the training and the weights output are supported.
+   */
+  [[nodiscard]]
+  bool performStreamingRequest(Utilities::ProgramOptions const& options);
+  /*
+   * Scales and normalizes the given data in place as set in the options and converts it to the selected precision.
+   * The min/max values are kept for the denormalization. They are derived from the given statistics of the unscaled data if these were
+   * collected with the scaling threshold of the options, otherwise they are calculated from the data.
+   */
+  [[nodiscard]]
+  bool prepareData(Utilities::ProgramOptions const& options, DataVector& data, Utilities::DataStatistics const& statistics);
+  /*
+   * Takes over the scaling and normalization state of the given logic, which prepared the data for this logic.
+   * This way, the same prepared data can be used by multiple logics without scaling and normalizing it again.
+   */
+  void adoptDataPreparation(Logic const& preparedLogic);
+  /*
+   * Creates the network, splits the given (prepared) data into training and validation data and sets up the training.
+   * If a predefined split is given (e.g. a fold of a cross-validation), it is used instead of the random validation split.
+   * If shared training data is given, its rows are trained instead of stacking the training data again (its tensors contain the given data).
+   * If the user resumes a training, the state, network and optimizer parameters of the checkpoint are loaded.
+   * Returns false if the checkpoint could not be loaded.
+   */
+  [[nodiscard]]
+  bool prepareTraining(Utilities::ProgramOptions const& options, DataVector const& data,
+                       std::optional<std::pair<DataVector, DataVector>> predefinedSplit = std::nullopt,
+                       std::optional<SharedTrainingData> sharedData = std::nullopt);
+  /*
+   * Returns true if the training with the given options uses the training data stacked into two tensors (e.g. mini-batches or L-BFGS).
+   */
+  [[nodiscard]]
+  static bool trainsOnStackedData(Utilities::ProgramOptions const& options);
+  /*
+   * Trains the neural network until the given epoch. Can be called multiple times, every call continues the training of the previous one.
+   * If continueAfterLastEpoch is true, the training continues after the given epoch until the improvement gets less than epsilon.
+   * Returns false if the training was stopped (timeout, NaN or no improvement of the validation error) and can not be continued.
+   */
+  bool train(uint32_t lastEpoch, bool continueAfterLastEpoch);
+  /*
+   * Stops the background thread which assembles the batches until the next call of train (e.g. while a sweep trial waits for the next round).
+   */
+  void pauseTraining();
+  /*
+   * Restores the weights with the lowest validation error (if the user activated early stopping) and outputs the training statistics.
+   * The background thread of the batches is stopped.
+   */
+  void finishTraining();
+  /*
+   * Returns the mean squared error of the network on the training data. A streamed input file is read again.
+   */
+  [[nodiscard]]
+  double trainingMeanSquaredError();
+  /*
+   * Returns the mean squared error of the network on the validation data.
+   */
+  [[nodiscard]]
+  double validationMeanSquaredError();
+  /*
+   * Calculates the mean squared error and all R2 scores of the network on the training data.
+   */
+  [[nodiscard]]
+  NetworkMetrics calculateTrainingMetrics();
+  /*
+   * Calculates the mean squared error and all R2 scores of the network on the validation data.
+   */
+  [[nodiscard]]
+  NetworkMetrics calculateValidationMetrics();
+  /*
+   * Returns the trained network.
+   */
+  [[nodiscard]]
+  Network const& getNetwork() const;
+  /*
+   * Returns the number of finished training epochs.
+   */
+  [[nodiscard]]
+  uint32_t numberOfTrainedEpochs() const;
+  /*
+   * Returns true if the training was stopped because the validation error did not improve anymore (early stopping).
+   */
+  [[nodiscard]]
+  bool stoppedByValidation() const;
+  /*
+   * Saves the minimum and maximum values from the current training data to the filepath which the user defined.
+   * If the data got scaled, scaled min/max values are saved.
+   */
+  void saveMinMaxToFile() const;
 
 private:
   /*
-   * Trains the neural network with the given data. If the data vector is empty, no training is performed.
+   * Trains the neural network for one epoch with one optimizer step per data point.
+   * Returns the sum of the mean squared errors of all data points measured during the training pass.
+   */
+  double trainEpochPerRow(DataVector const& data, torch::optim::Optimizer& optimizer);
+  /*
+   * Trains the neural network for one epoch with one optimizer step per batch of the batch variable.
+   * Each batch is inferred at once, the loss is the sum of the mean squared errors of its data points.
+   * Returns the sum of the mean squared errors of all data points measured during the training pass.
+   */
+  double trainEpochBatchVariable(torch::optim::Optimizer& optimizer);
+  /*
+   * Trains the neural network for one epoch with one optimizer step per batch of the given pipeline (mini-batch or single data point).
+   * Returns the sum of the mean squared errors of all data points measured during the training pass.
+   */
+  double trainEpochPipeline(DataPipeline& pipeline, torch::optim::Optimizer& optimizer);
+  /*
+   * Trains the neural network for one epoch on the chunks of the given stream with one optimizer step per mini-batch (or data point).
+   * If the data is shuffled, the chunks are read in random order and the data points of every chunk are shuffled.
+   * Returns the sum of the mean squared errors of all data points measured during the training pass.
+   */
+  double trainEpochStreaming(Utilities::DataStream& dataStream, torch::optim::Optimizer& optimizer, uint32_t epoch);
+  /*
+   * Trains the neural network for one epoch with a single optimizer step on all data points.
+   * The loss is evaluated in a closure, so the optimizer (e.g. L-BFGS) can re-evaluate it multiple times per step.
+   * Returns the sum of the mean squared errors of all data points measured before the step.
+   */
+  double trainEpochFullBatch(torch::Tensor const& inputs, torch::Tensor const& outputs, torch::optim::Optimizer& optimizer);
+  /*
+   * Saves the weights, the optimizer and the given state of the last finished epoch to the checkpoint directory.
+   * Only the progress up to this epoch is saved. Prints a warning if the checkpoint could not be saved.
+   */
+  void writeCheckpoint(TrainingState& state);
+  /*
+   * Calculates the min/max values of the streamed data (or takes them from the min/max file or the dataset cache) and sets the scaling and
+   * normalization of the following passes.
+   */
+  [[nodiscard]]
+  bool prepareStreamingData();
+  /*
+   * Creates a network with the layer configuration and precision which the user selected.
+   */
+  [[nodiscard]]
+  Network createNetwork() const;
+  /*
+   * Creates the optimizer which the user selected for the given network parameters.
    */
-  void trainNetwork(DataVector const& data);
+  [[nodiscard]]
+  std::unique_ptr<torch::optim::Optimizer> createOptimizer(std::vector<torch::Tensor> const& parameters) const;
   /*
    * Starts the interactive mode where the user can input values via the console. Following actions are performed with these values:
    * - normalization and scaling (if needed)
@@ -46,24 +208,39 @@ private:
    */
   void saveDiffToFile(DataVector const& data, std::string const& outputPath, bool outputRelativeDifference);
   /*
-   * Saves the minimum and maximum values from the current training data to the filepath which the user defined.
-   * If the data got scaled, scaled min/max values are saved.
+   * Calculates the error statistics of the network and saves them as JSON to the file path which the user defined.
+   * If the data was split for validation, the statistics are saved for the training, validation and complete data.
    */
-  void saveMinMaxToFile() const;
+  void saveErrorReportToFile(std::pair<DataVector, DataVector> const& splitData, DataVector const& allData);
+  /*
+   * Creates the normalizers of the current min/max values. Must be called whenever the min/max values changed.
+   */
+  void createNormalizers();
   /*
-   * Denormalizes an input tensor.
+   * Normalizes (scaled) input and output tensors. Works on single data points and on batches (one data point per row).
+   * With an active mixed scaling, the threshold is compared with the input values before they are normalized.
+   */
+  void normalizeData(torch::Tensor& inputTensor, torch::Tensor& outputTensor) const;
+  /*
+   * Denormalizes an input tensor. Works on single data points and on batches (one data point per row).
    * If limitValues is true, the output is limited by the current min/max output values.
    */
-  void denormalizeInputTensor(torch::Tensor& tensor, bool limitValues = false);
+  void denormalizeInputTensor(torch::Tensor& tensor, bool limitValues = false) const;
   /*
-   * Denormalizes an output tensor.
+   * Denormalizes an output tensor. Works on single data points and on batches (one data point per row).
    * If limitValues is true, the output is limited by the current min/max output values.
    */
-  void denormalizeOutputTensor(torch::Tensor const& inputTensor, torch::Tensor& outputTensor, bool limitValues = false);
+  void denormalizeOutputTensor(torch::Tensor const& inputTensor, torch::Tensor& outputTensor, bool limitValues = false) const;
   /*
-   * Reverts the scaling on an output tensor.
+   * Reverts the scaling on an output tensor. Works on single data points and on batches (one data point per row).
    */
   void unscaleOutputTensor(torch::Tensor const& inputTensor, torch::Tensor& outputTensor) const;
+  /*
+   * Returns a mask which marks all data points of the given (normalized) input tensor that are below or equal the mixed scaling threshold.
+   * The mask can be broadcasted to the corresponding output tensor.
+   */
+  [[nodiscard]]
+  torch::Tensor mixedScalingMask(torch::Tensor const& inputTensor) const;
   /*
    * Checks if the given min/max values are valid --> min != max
    */
@@ -84,12 +261,39 @@ private:
 
   MixedMinMaxValues mixedScalingMinMax {};
 
+  // Normalizations of the min/max values (see createNormalizers), with an active mixed scaling the output normalizer is the one above the threshold:
+  Utilities::Normalizer inputNormalizer {};
+  Utilities::Normalizer outputNormalizer {};
+  Utilities::Normalizer belowThresholdOutputNormalizer {};
+
   std::string inputFileHeader {};
 
   ProgressVector trainingProgress {};
 
+  std::pair<DataVector, DataVector> splitData {};
+  std::unique_ptr<Utilities::DataStream> stream {nullptr}; // instead of the split data if the input file is streamed
+
   bool useBatchTraining = false;
-  BatchMap batchedTrainingData = BatchMap();
+  BatchVector batchedTrainingData = BatchVector();
+
+  TrainingState trainingState {};
+  bool trainingStopped = false;
+  bool validationStopped = false;
+  std::unique_ptr<torch::optim::Optimizer> optimizer {nullptr};
+  std::unique_ptr<LearnRateScheduler> scheduler {nullptr};
+  std::unique_ptr<ParallelTrainer> parallelTrainer {nullptr};
+  bool usePipeline = false;
+  std::unique_ptr<DataPipeline> pipeline {nullptr}; // only exists during the training
+  std::unique_ptr<ProgressEvaluator> progressEvaluator {nullptr};
+  torch::Tensor stackedInputs {};
+  torch::Tensor stackedOutputs {};
+  torch::Tensor trainingRows {}; // rows of the stacked tensors which are trained, undefined if all rows are trained
+  std::chrono::steady_clock::duration trainingDuration = std::chrono::steady_clock::duration::zero();
+  uint64_t numberOfTrainedSamples = 0;
+
+  std::mt19937_64 shuffleGenerator {};
+
+  Utilities::Telemetry telemetry {};
 };
 
 }
@@ -2,12 +2,26 @@
 
 #include "NeuralNetwork/neuralnetwork.h"
 #include "Utilities/constants.h"
+#include "Utilities/erroraccumulator.h"
 
 namespace NeuralNetwork {
 
+  /*
+   * The denormalization and unscaling functions work on single data points (shape [columns]) as well as
+   * on batches of data points (shape [rows, columns]). The output tensor is modified in place.
+   */
   using DenormalizeOutputTensorFunction = std::function<void(torch::Tensor const& inputTensor, torch::Tensor& outputTensor, bool limitValues)>;
   using UnscaleOutputTensorFunction = std::function<void(torch::Tensor const& inputTensor, torch::Tensor& outputTensor)>;
 
+  class NetworkMetrics
+  {
+  public:
+    double meanSquaredError;
+    std::vector<double> r2Score;
+    std::vector<double> r2ScoreAlternate;
+    std::vector<double> r2ScoreAlternateDenormalized;
+  };
+
   class NetworkAnalyzer
   {
   public:
@@ -18,6 +32,20 @@ namespace NeuralNetwork {
     explicit NetworkAnalyzer(Network& network, DenormalizeOutputTensorFunction denormalizationFunction, UnscaleOutputTensorFunction unscaleFunction);
 
   public:
+    /*
+     * Calculates the mean squared error and all R2 scores for the given data in a single batched pass without gradient tracking.
+     * The data is processed in chunks, so the memory usage does not depend on the size of the data.
+     * If calculateDenormalized is false, the denormalized R2 score is not calculated and left empty.
+     */
+    [[nodiscard]]
+    NetworkMetrics calculateMetrics(DataVector const& testData, bool calculateDenormalized = true);
+    /*
+     * Calculates the error statistics (MAE, max absolute and relative error, error quantiles) of all output columns
+     * for the normalized and the denormalized values in a single batched pass without gradient tracking.
+     * Each chunk of data points is accumulated in parallel with one accumulator per thread.
+     */
+    [[nodiscard]]
+    Utilities::ErrorReport calculateErrorReport(DataVector const& testData);
     /*
      * Calculates and returns the mean square error with the given data.
      */
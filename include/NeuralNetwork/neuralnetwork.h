@@ -2,6 +2,8 @@
 
 #include <torch/torch.h>
 
+#include "Utilities/constants.h"
+
 namespace NeuralNetwork {
 
 class NetworkImpl : public torch::nn::Module
@@ -11,8 +13,9 @@ public:
    * Constructor which creates a new neural network instance with the given number of input and output nodes.
    * Also using the given definition of the hidden layers. Each value in the hiddenLayers vector
    * defines a new hidden layer with the corresponding number of nodes.
+   * All parameters of the network use the given data type.
    */
-  NetworkImpl(uint32_t numberOfInputNodes, uint32_t numberOfOutputNode, std::vector<uint32_t> const& hiddenLayers);
+  NetworkImpl(uint32_t numberOfInputNodes, uint32_t numberOfOutputNode, std::vector<uint32_t> const& hiddenLayers, torch::ScalarType dataType = TORCH_DATA_TYPE);
 
 public:
   /*
@@ -25,7 +28,7 @@ private:
   /*
    * Adds a layer to the neural network with the given parameters.
    */
-  void addLayer(size_t layerNumber, uint32_t numberOfInputNodes, uint32_t numberOfOutputNodes);
+  void addLayer(size_t layerNumber, uint32_t numberOfInputNodes, uint32_t numberOfOutputNodes, torch::ScalarType dataType);
 
 private:
   std::vector<torch::nn::Sequential> layers{};
@@ -36,4 +39,23 @@ private:
  */
 TORCH_MODULE(Network);
 
+/*
+ * Saves the parameters of the network to the given file together with the data type (precision) they were trained in.
+ */
+void saveNetwork(Network const& network, FilePath const& filePath);
+/*
+ * Loads the parameters of the network from the given file and converts them to the current data type of the network.
+ * Returns the data type the parameters were trained in. Files without this information are treated as double precision.
+ */
+torch::ScalarType loadNetwork(Network& network, FilePath const& filePath);
+/*
+ * Returns a copy of all parameters and buffers of the network, which can be restored with restoreNetworkState.
+ */
+[[nodiscard]]
+std::vector<torch::Tensor> copyNetworkState(Network const& network);
+/*
+ * Overwrites the parameters and buffers of the network with the given state, which was created with copyNetworkState.
+ */
+void restoreNetworkState(Network& network, std::vector<torch::Tensor> const& state);
+
 }
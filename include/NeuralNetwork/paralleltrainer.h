@@ -0,0 +1,104 @@
+#pragma once
+
+#include "NeuralNetwork/neuralnetwork.h"
+#include "Utilities/constants.h"
+#include "Utilities/programoptions.h"
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace NeuralNetwork {
+
+using NetworkFactoryFunction = std::function<Network()>;
+using OptimizerFactoryFunction = std::function<std::unique_ptr<torch::optim::Optimizer>(std::vector<torch::Tensor> const& parameters)>;
+
+class ParallelTrainer
+{
+public:
+  /*
+   * Constructor of the ParallelTrainer class.
+   * Splits the stacked training data (one data point per row) into one shard per worker. If training rows are given, only these rows of the
+   * stacked tensors are trained (e.g. the folds of a cross-validation share the tensors), the batches are gathered from the shared tensors.
+   * The first worker trains the given network with the given optimizer, every other worker trains a replica which is created with the given factory functions.
+   * In all-reduce mode, the replicas own a copy of the parameters which is synchronized after every step.
+   * In Hogwild mode, the replicas share the parameters of the given network and every worker updates them without locking.
+   * The threads of the workers are started once and wait between the epochs.
+   */
+  ParallelTrainer(Network& network, torch::optim::Optimizer& optimizer, torch::Tensor const& inputs, torch::Tensor const& outputs,
+                  torch::Tensor const& trainingRows, Utilities::ProgramOptions const& options, NetworkFactoryFunction const& createNetwork,
+                  OptimizerFactoryFunction const& createOptimizer, uint64_t seed);
+  /*
+   * Destructor of the ParallelTrainer class. Stops and joins the worker threads.
+   */
+  ~ParallelTrainer();
+
+  ParallelTrainer(ParallelTrainer const&) = delete;
+  ParallelTrainer& operator=(ParallelTrainer const&) = delete;
+
+public:
+  /*
+   * Trains all workers for one epoch on their shard of the data. The first worker runs in the calling thread.
+   * The order of the data points only depends on the seed and the given epoch, so a resumed training visits them in the same order.
+   * Returns the sum of the mean squared errors of all data points measured during the training pass.
+   */
+  double trainEpoch(uint32_t epoch);
+  /*
+   * Sets the learning rate of the optimizers of all workers.
+   */
+  void setLearnRate(double learnRate);
+
+private:
+  /*
+   * One optimizer step per batch and worker, the workers synchronize twice per step. The gradients of all workers are averaged (weighted by the number of data points)
+   * into the gradients of the first worker, which performs the step and copies the new parameters to the replicas.
+   */
+  double trainEpochAllReduce(uint32_t epoch);
+  /*
+   * Every worker performs its own optimizer steps on the shared parameters.
+   */
+  double trainEpochHogwild(uint32_t epoch);
+  /*
+   * Returns the rows of the stacked tensors in the order in which the given worker visits the data points of its shard in the given epoch. The order is shuffled when mini-batches are used or the user activated shuffling.
+   */
+  [[nodiscard]]
+  torch::Tensor shardOrder(size_t worker, uint32_t epoch) const;
+  /*
+   * Runs the given function for every worker index and returns when all workers finished it. The first worker runs in the calling thread.
+   */
+  void runWorkers(std::function<void(size_t)> const& function);
+  /*
+   * Main loop of the thread of the given worker: waits for the next function of runWorkers until the trainer is destroyed.
+   */
+  void workerLoop(size_t worker);
+
+private:
+  struct Worker
+  {
+    Network network {nullptr};
+    torch::optim::Optimizer* optimizer = nullptr;
+    std::unique_ptr<torch::optim::Optimizer> ownedOptimizer {nullptr};
+    torch::Tensor rows {}; // rows of the stacked tensors in the shard of the worker
+  };
+
+  Utilities::ParallelModeType mode;
+  int64_t batchSize;
+  bool shuffle;
+  uint64_t seed;
+  torch::Tensor inputs;
+  torch::Tensor outputs;
+  std::vector<Worker> workers {};
+
+  std::vector<std::thread> threads {};
+  std::mutex mutex {};
+  std::condition_variable startCondition {};
+  std::condition_variable finishCondition {};
+  std::function<void(size_t)> const* task = nullptr;
+  uint64_t taskGeneration = 0;
+  size_t unfinishedWorkers = 0;
+  bool stopping = false;
+};
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "NeuralNetwork/networkanalyzer.h"
+#include "NeuralNetwork/neuralnetwork.h"
+#include "Utilities/constants.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace NeuralNetwork {
+
+/*
+ * Calculates the errors of the training progress on a background thread, so the training continues while the previous epoch is scored.
+ * Every evaluation uses a copy of the weights which was taken when the progress entry was created.
+ */
+class ProgressEvaluator
+{
+public:
+  /*
+   * Constructor which starts the background thread. The given network is only used by the background thread and gets the copied weights
+   * of every evaluation. The given data must not change while the evaluator exists.
+   */
+  ProgressEvaluator(Network network, DataVector const& data);
+  /*
+   * Destructor which finishes all queued evaluations and stops the background thread.
+   */
+  ~ProgressEvaluator();
+
+  ProgressEvaluator(ProgressEvaluator const&) = delete;
+  ProgressEvaluator& operator=(ProgressEvaluator const&) = delete;
+
+public:
+  /*
+   * Queues the calculation of the mean squared error and the R2 scores of the given progress entry with the given network state
+   * (see copyNetworkState). Blocks while the maximum number of evaluations is queued, so the copied weights do not pile up.
+   */
+  void evaluate(LearnProgressDataSet entry, std::vector<torch::Tensor> networkState);
+  /*
+   * Waits until all queued evaluations are finished and appends their progress entries in the order of their creation.
+   */
+  void collect(ProgressVector& progress);
+
+private:
+  void evaluateInBackground();
+
+private:
+  Network network;
+  NetworkAnalyzer analyzer;
+  DataVector const& data;
+
+  std::mutex mutex {};
+  std::condition_variable condition {};
+  std::deque<std::pair<LearnProgressDataSet, std::vector<torch::Tensor>>> queuedEvaluations {};
+  ProgressVector evaluatedEntries {};
+  bool evaluating = false;
+  bool stopped = false;
+  std::thread worker {};
+};
+
+}
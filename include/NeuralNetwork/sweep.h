@@ -0,0 +1,60 @@
+#pragma once
+
+#include "NeuralNetwork/logic.h"
+#include "Utilities/constants.h"
+#include "Utilities/programoptions.h"
+
+#include <memory>
+#include <optional>
+
+namespace NeuralNetwork {
+
+class Sweep
+{
+public:
+  /*
+   * Performs the hyperparameter sweep which the user defined in the sweep specification file:
+   * - the input file is parsed once and the data is scaled and normalized once per scaling mode of the sweep
+   * - every combination of the parameter values is a trial, all trials use the same seed (same validation split and initialization)
+   * - the trials are trained concurrently in rounds (successive halving): after every round only the better half of the trials continues
+   *   and the number of epochs of the next round doubles, until one trial is left or the number of epochs of --epochs is reached
+   *   (early stopped trials leave the rounds, but are ranked with their final error against the trials which finished the last round)
+   * - the ranked results are printed (and saved to --sweepOut), the weights of the best trial are saved to --outWeights
+   */
+  [[nodiscard]]
+  bool performSweep(Utilities::ProgramOptions const& options);
+
+private:
+  struct Trial
+  {
+    Utilities::ProgramOptions options {};
+    std::unique_ptr<Logic> logic {nullptr};
+    uint32_t numberOfRounds = 0; // number of rounds in which the trial was trained, trials are sorted out after every round
+    bool trainingStopped = false;
+    bool finished = false; // trained until the end or stopped early by the validation, ranked by its error against all finished trials
+    double error = 0.0; // error which is used for the ranking
+    SweepResult result {};
+  };
+
+  /*
+   * Creates the options of all trials (the Cartesian product of the parameter values in the sweep specification).
+   */
+  [[nodiscard]]
+  std::optional<std::vector<Utilities::ProgramOptions>> createTrialOptions(SweepSpecification const& specification) const;
+  /*
+   * Trains the given trials concurrently until the given epoch and evaluates their errors afterwards.
+   * If isLastRound is true, the trials continue after the given epoch until the improvement gets less than epsilon.
+   */
+  void trainTrials(std::vector<Trial*> const& trials, uint32_t lastEpoch, bool isLastRound);
+  /*
+   * Evaluates the errors of the given trial, which are used for the ranking.
+   * If trainingFinished is true, the training of the trial is finished first (e.g. the weights with the lowest validation error are restored).
+   */
+  void evaluateTrial(Trial& trial, bool trainingFinished) const;
+
+private:
+  Utilities::ProgramOptions options {};
+  std::vector<Trial> trials {};
+};
+
+}
@@ -1,11 +1,13 @@
 #pragma once
 
 #include <torch/torch.h>
+#include <optional>
 #include <vector>
 
 // Forward declarations:
 
 class LearnProgressDataSet;
+class SweepResult;
 
 // Type definitions & constants:
 
@@ -15,7 +17,7 @@ using TensorDataType = double;
 const torch::ScalarType TORCH_DATA_TYPE = torch::kDouble;
 
 using DataVector = std::vector<std::pair<torch::Tensor, torch::Tensor>>;
-using BatchMap = std::unordered_map<std::string, DataVector>;
+using BatchVector = std::vector<std::pair<torch::Tensor, torch::Tensor>>; // packed input and output tensors [rows, columns] of one batch per entry
 using MinMaxVector = std::vector<std::pair<TensorDataType, TensorDataType>>;
 using MinMaxValues = std::pair<MinMaxVector, MinMaxVector>;
 using MixedMinMaxValues = std::pair<MinMaxValues, MinMaxValues>;
@@ -23,6 +25,12 @@ using MixedMinMaxValues = std::pair<MinMaxValues, MinMaxValues>;
 using ProgressVector = std::vector<LearnProgressDataSet>;
 const std::string LEARN_PROGRESS_FILE_HEADER_FIRST_PART = "Epoch, MeanSquaredError, ElapsedTimeInMS";
 const std::string LEARN_PROGRESS_R2_SCORE_HEADER_PART = ", R2Score_";
+const std::string LEARN_PROGRESS_LEARN_RATE_HEADER_PART = ", LearnRate";
+
+using SweepSpecification = std::vector<std::pair<std::string, std::vector<std::string>>>; // parameter name and the values to try
+using SweepResultVector = std::vector<SweepResult>;
+const std::string SWEEP_RESULT_FILE_HEADER = "Rank, Layers, Nodes, LearnRate, Scaling, Optimizer, MiniBatch, Epochs, MeanSquaredError";
+const std::string SWEEP_RESULT_VALIDATION_HEADER_PART = ", ValidationMeanSquaredError";
 
 using FilePath = std::string;
 using TimeoutDuration = std::chrono::milliseconds;
@@ -36,6 +44,22 @@ public:
   std::vector<double> r2Score;
   double meanSquaredError;
   uint64_t elapsedTimeInMS;
+  double learnRate;
+};
+
+class SweepResult
+{
+public:
+  uint32_t rank;
+  uint32_t numberOfLayers;
+  uint32_t numberOfNodesPerLayer;
+  double learnRate;
+  std::string scaling;
+  std::string optimizer;
+  std::optional<uint32_t> miniBatchSize;
+  uint32_t epochs;
+  double meanSquaredError;
+  double validationMeanSquaredError;
 };
 
 // Helper functions:
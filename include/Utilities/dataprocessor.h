@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Utilities/constants.h"
+#include "Utilities/datastatistics.h"
+#include "Utilities/normalizer.h"
 
 namespace Utilities {
 
@@ -12,9 +14,14 @@ public:
    */
   static void CalculateMinMax(DataVector const& data, MinMaxValues& minMaxVectors);
   /*
-   * Calculates the minimum and maximum values from the given data with respect to an active mixed scaling.
+   * Calculates the minimum and maximum values from the given data with respect to an active mixed scaling (in one pass over the data).
    */
   static void CalculateMixedMinMax(DataVector const& data, uint32_t thresholdVariable, TensorDataType threshold, MixedMinMaxValues& mixedMinMaxValues);
+  /*
+   * Collects the statistics of all columns of the given data in one pass. Prefer the statistics collected while parsing (see FileParser::LoadInputData).
+   */
+  [[nodiscard]]
+  static DataStatistics CollectStatistics(DataVector const& data, std::optional<ScalingThreshold> scalingThreshold = std::nullopt);
   /*
    * Parses and returns the minimum and maximum values from the given file.
    */
@@ -31,29 +38,53 @@ public:
    */
   static void Normalize(DataVector& data, std::pair<MinMaxVector const, MinMaxVector const> const& minMaxVectors, TensorDataType newMinValue = -0.5, TensorDataType newMaxValue = 0.5);
   /*
-   * Normalizes the given tensor.
+   * Normalizes all given tensors with the given normalizers. If the data points are rows of one tensor (see BatchView), all of them are
+   * normalized at once.
+   */
+  static void Normalize(DataVector& data, Normalizer const& inputNormalizer, Normalizer const& outputNormalizer);
+  /*
+   * Normalizes the given tensor. The tensor can be a single data point or a batch of data points (one per row).
+   * Prefer a Normalizer if multiple tensors are normalized with the same min/max values.
    */
   static void Normalize(torch::Tensor& tensor, MinMaxVector const& minMaxVector, TensorDataType newMinValue = -0.5, TensorDataType newMaxValue = 0.5);
   /*
-   * Denormalizes the given tensor.
+   * Denormalizes the given tensor. The tensor can be a single data point or a batch of data points (one per row).
+   * Prefer a Normalizer if multiple tensors are denormalized with the same min/max values.
    */
   static void Denormalize(torch::Tensor& tensor, MinMaxVector const& minMaxVector, TensorDataType oldMinValue = -0.5, TensorDataType oldMaxValue = 0.5, bool limitValues = false);
 
   /*
-   * Scales the tensor logarithmically.
+   * Converts all tensors of the given data to the given data type. The rows of the converted data are views of two stacked tensors.
+   */
+  static void ConvertDataType(DataVector& data, torch::ScalarType dataType);
+  /*
+   * Stacks the rows of the given data into two contiguous tensors of the shape [rows, columns] (input and output).
+   */
+  [[nodiscard]]
+  static std::pair<torch::Tensor, torch::Tensor> StackData(DataVector const& data);
+  /*
+   * Returns views of the shape [rows, columns] (input and output) on the given data if its data points are equally spaced rows of the same
+   * tensors, e.g. after parsing the input file or loading a .npy file. Changes of the views change the data points and vice versa.
+   * Returns std::nullopt if the data points are separate tensors.
+   */
+  [[nodiscard]]
+  static std::optional<std::pair<torch::Tensor, torch::Tensor>> BatchView(DataVector const& data);
+
+  /*
+   * Scales the tensor logarithmically. Values below 1e-30 are raised to it first. Works element-wise on tensors of any shape.
    */
   static void ScaleLogarithmic(torch::Tensor& data);
   /*
-   * Reverts the logarithmically scaling.
+   * Reverts the logarithmically scaling. Works element-wise on tensors of any shape.
    */
   static void UnscaleLogarithmic(torch::Tensor& data);
 
   /*
-   * Scales the tensor with the square root function.
+   * Scales the tensor with the square root function. Values below 1e-30 are raised to it first. Works element-wise on tensors of any shape.
    */
   static void ScaleSquareRoot(torch::Tensor& data);
   /*
-   * Reverts the scaling with the square root function.
+   * Reverts the scaling with the square root function. Works element-wise on tensors of any shape.
    */
   static void UnscaleSquareRoot(torch::Tensor& data);
 };
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "Utilities/constants.h"
+#include "Utilities/datastatistics.h"
+#include "Utilities/mappedfile.h"
+
+#include <memory>
+
+namespace Utilities {
+
+/*
+ * Parsed input data as it is stored in a dataset cache.
+ */
+class CachedDataset
+{
+public:
+  std::string fileHeader;
+  torch::Tensor inputs;      // [rows, columns]
+  torch::Tensor outputs;     // [rows, columns]
+  DataStatistics statistics; // of the unscaled columns
+};
+
+/*
+ * Memory-mapped dataset cache, which reads ranges of rows without loading the whole cache (see DatasetCache).
+ */
+class DatasetCacheReader
+{
+public:
+  /*
+   * Opens the cache of the given input file and selected columns. Returns nullptr if there is no cache, it is outdated or it has other columns.
+   * A copy-on-write mapping is needed for mapRows.
+   */
+  [[nodiscard]]
+  static std::unique_ptr<DatasetCacheReader> Open(FilePath const& sourceFilePath, uint32_t numberOfInputVariables, uint32_t numberOfOutputVariables,
+                                                  std::vector<std::string> const& inputColumnNames = {}, std::vector<std::string> const& outputColumnNames = {},
+                                                  bool copyOnWrite = false);
+
+public:
+  [[nodiscard]]
+  std::string const& fileHeader() const { return header; }
+  [[nodiscard]]
+  uint64_t numberOfRows() const { return rows; }
+  /*
+   * Returns the min/max values of the unscaled columns.
+   */
+  [[nodiscard]]
+  MinMaxValues const& minMax() const { return columnMinMax; }
+  /*
+   * Returns the statistics of the unscaled columns, which were collected with the scaling threshold of the run that created the cache.
+   */
+  [[nodiscard]]
+  DataStatistics const& statistics() const { return columnStatistics; }
+  /*
+   * Copies the given rows into two row-major tensors [rows, columns] (input and output).
+   */
+  [[nodiscard]]
+  std::pair<torch::Tensor, torch::Tensor> readRows(uint64_t firstRow, uint64_t numberOfRowsToRead) const;
+  /*
+   * Returns all rows as two row-major tensors [rows, columns] (input and output) without copying them: the tensors use the mapping directly,
+   * which is released when the tensors and the reader are destroyed. The reader must be opened with a copy-on-write mapping.
+   */
+  [[nodiscard]]
+  std::pair<torch::Tensor, torch::Tensor> mapRows() const;
+
+private:
+  DatasetCacheReader(FilePath const& cacheFilePath, bool copyOnWrite);
+
+private:
+  std::shared_ptr<MappedFile> file;
+  std::string header {};
+  uint64_t rows = 0;
+  uint32_t numberOfInputs = 0;
+  uint32_t numberOfOutputs = 0;
+  DataStatistics columnStatistics {};
+  MinMaxValues columnMinMax {};
+  TensorDataType const* inputValues = nullptr;  // row by row
+  TensorDataType const* outputValues = nullptr; // row by row
+};
+
+/*
+ * Binary cache of a parsed input file, which is stored next to the input file ("<input file>.nncache").
+ *
+ * The cache contains the file header, the selected columns, the number of rows and columns, the data type, the statistics of the columns and
+ * the row-major input and output values (the layout of the training tensors, so they are mapped instead of copied).
+ * It is only used if the size and the modification time of the input file are still the same as when the cache was created. If the status
+ * change time or the inode of the input file differ as well (e.g. after a copy), the input file must also have the same hash.
+ */
+class DatasetCache
+{
+public:
+  /*
+   * Returns the path of the cache of the given input file.
+   */
+  [[nodiscard]]
+  static FilePath CachePath(FilePath const& sourceFilePath);
+  /*
+   * Loads the cache of the given input file and selected columns. Returns std::nullopt if there is no cache, it is outdated or it has other columns.
+   */
+  [[nodiscard]]
+  static std::optional<CachedDataset> Load(FilePath const& sourceFilePath, uint32_t numberOfInputVariables, uint32_t numberOfOutputVariables,
+                                           std::vector<std::string> const& inputColumnNames = {}, std::vector<std::string> const& outputColumnNames = {});
+  /*
+   * Creates the cache of the given input file with the given parsed data of the selected columns and its statistics.
+   * The cache is written to a temporary file first and then renamed, so concurrent runs never read a partial cache.
+   */
+  static bool Save(FilePath const& sourceFilePath, std::string const& fileHeader, torch::Tensor const& inputs, torch::Tensor const& outputs,
+                   DataStatistics const& statistics, std::vector<std::string> const& inputColumnNames = {},
+                   std::vector<std::string> const& outputColumnNames = {});
+};
+
+}
@@ -8,20 +8,44 @@ class DataSplitter
 {
 public:
   /*
-   * Splits the data randomly into two vectors with the given probability.
+   * Splits the data randomly into two vectors with the given probability (see trainingRowsOfRandomSplit). The order of the data points is kept.
    */
   [[nodiscard]]
-  static std::pair<DataVector, DataVector> splitDataRandomly(DataVector const& inputData, double trainingPercentage);
+  static std::pair<DataVector, DataVector> splitDataRandomly(DataVector const& inputData, double trainingPercentage, uint64_t seed);
+  /*
+   * Returns the ascending indices (kLong) of the training data points of a random split with the given probability.
+   * The same seed always results in the same split.
+   */
+  [[nodiscard]]
+  static torch::Tensor trainingRowsOfRandomSplit(size_t numberOfDataPoints, double trainingPercentage, uint64_t seed);
+  /*
+   * Assigns every data point to one of the given number of folds. The folds are equally sized (+-1) and the data points are assigned randomly.
+   * The same seed always results in the same folds. Returns the fold of each data point.
+   */
+  [[nodiscard]]
+  static std::vector<uint32_t> assignFolds(size_t numberOfDataPoints, uint32_t numberOfFolds, uint64_t seed);
+  /*
+   * Splits the data into training data (all other folds) and validation data (the given fold). The order of the data points is kept.
+   * The tensors are not copied, both vectors share the tensors of the given data.
+   */
+  [[nodiscard]]
+  static std::pair<DataVector, DataVector> splitDataByFold(DataVector const& data, std::vector<uint32_t> const& foldAssignment, uint32_t validationFold);
+  /*
+   * Returns the indices (kLong) of the training data points (all other folds) of the given validation fold in the order of splitDataByFold.
+   */
+  [[nodiscard]]
+  static torch::Tensor trainingRowsOfFold(std::vector<uint32_t> const& foldAssignment, uint32_t validationFold);
   /*
    * Splits the data into two vectors with the given threshold.
    */
   [[nodiscard]]
   static std::pair<DataVector, DataVector> splitDataWithThreshold(DataVector const& data, uint32_t thresholdVariable, TensorDataType threshold);
   /*
-   * Splits the data into batches with the given batch variable.
+   * Splits the data into batches with the given batch variable. All data points of a batch have the same values in all other input variables.
+   * Each batch is a pair of contiguous tensors [rows, columns] (input and output). The batches are ordered by their first data point.
    */
   [[nodiscard]]
-  static BatchMap splitDataIntoBatches(DataVector const& data, uint32_t batchVariable);
+  static BatchVector splitDataIntoBatches(DataVector const& data, uint32_t batchVariable);
 };
 
 }
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "Utilities/constants.h"
+#include "Utilities/programoptions.h"
+
+#include <limits>
+
+namespace Utilities {
+
+/*
+ * Count, min, max, mean and variance of the values of one column, collected in a streaming fashion (Welford's algorithm).
+ * Two accumulators can be merged, e.g. after collecting values on different threads.
+ */
+class ValueAccumulator
+{
+public:
+  void add(TensorDataType value);
+  /*
+   * Merges the values of the other accumulator into this accumulator.
+   */
+  void merge(ValueAccumulator const& other);
+
+  [[nodiscard]]
+  uint64_t count() const { return numberOfValues; }
+  [[nodiscard]]
+  TensorDataType minimum() const { return minimumValue; }
+  [[nodiscard]]
+  TensorDataType maximum() const { return maximumValue; }
+  [[nodiscard]]
+  double mean() const { return meanValue; }
+  /*
+   * Returns the population variance of all added values.
+   */
+  [[nodiscard]]
+  double variance() const;
+
+  /*
+   * Appends the state of the accumulator to the given values, e.g. to store it in a file (see FromValues).
+   */
+  void appendValues(std::vector<double>& values) const;
+  /*
+   * Returns the accumulator with the state which was appended at the given position (see appendValues).
+   */
+  [[nodiscard]]
+  static ValueAccumulator FromValues(double const* values);
+
+private:
+  uint64_t numberOfValues = 0;
+  TensorDataType minimumValue = std::numeric_limits<TensorDataType>::max();
+  TensorDataType maximumValue = std::numeric_limits<TensorDataType>::lowest();
+  double meanValue = 0.0;
+  double squaredDistanceSum = 0.0;
+};
+
+/*
+ * Threshold of the mixed scaling: the output values of data points whose input variable is <= the threshold are scaled differently.
+ */
+class ScalingThreshold
+{
+public:
+  /*
+   * Returns the threshold of the given options if a mixed scaling is active.
+   */
+  [[nodiscard]]
+  static std::optional<ScalingThreshold> FromOptions(ProgramOptions const& options);
+
+public:
+  uint32_t inputVariable;
+  TensorDataType threshold;
+};
+
+/*
+ * Collects the statistics of every input and output column of data points in a streaming fashion, e.g. while the input file is parsed.
+ * If a scaling threshold is set, the min/max values of the output columns are also collected separately for the data points below or at
+ * the threshold and for the data points above it (see mixed scaling).
+ * The statistics of different threads can be merged into one.
+ */
+class DataStatistics
+{
+public:
+  DataStatistics(uint32_t numberOfInputs = 0, uint32_t numberOfOutputs = 0, std::optional<ScalingThreshold> scalingThreshold = std::nullopt);
+
+  /*
+   * Collects the statistics of the given data points [rows, columns] in parallel.
+   */
+  [[nodiscard]]
+  static DataStatistics Collect(torch::Tensor const& inputs, torch::Tensor const& outputs, std::optional<ScalingThreshold> scalingThreshold = std::nullopt);
+
+public:
+  /*
+   * Adds one data point, given as pointers to its input and output values.
+   */
+  void addRow(TensorDataType const* inputs, TensorDataType const* outputs);
+  /*
+   * Merges the data points of the other statistics (with the same columns and threshold) into these statistics.
+   */
+  void merge(DataStatistics const& other);
+
+  [[nodiscard]]
+  uint64_t numberOfDataPoints() const { return numberOfRows; }
+  [[nodiscard]]
+  std::vector<ValueAccumulator> const& inputColumns() const { return inputAccumulators; }
+  [[nodiscard]]
+  std::vector<ValueAccumulator> const& outputColumns() const { return outputAccumulators; }
+  [[nodiscard]]
+  std::optional<ScalingThreshold> const& scalingThreshold() const { return threshold; }
+  /*
+   * Returns true if the statistics were collected with the given scaling threshold (or without a threshold if none is given).
+   */
+  [[nodiscard]]
+  bool hasScalingThreshold(std::optional<ScalingThreshold> scalingThreshold) const;
+  /*
+   * Returns the min/max values of all columns (see DataProcessor::CalculateMinMax).
+   */
+  [[nodiscard]]
+  MinMaxValues minMax() const;
+  /*
+   * Returns the min/max values with respect to the scaling threshold (see DataProcessor::CalculateMixedMinMax):
+   * the min/max values of the input columns are the same for both parts, the min/max values of the output columns are split.
+   * The output min/max values of a part without data points are empty.
+   */
+  [[nodiscard]]
+  MixedMinMaxValues mixedMinMax() const;
+
+  /*
+   * Returns the statistics (including the scaling threshold) as a sequence of values, e.g. to store them in a dataset cache (see FromValues).
+   */
+  [[nodiscard]]
+  std::vector<double> toValues() const;
+  /*
+   * Returns the statistics of the given values (see toValues). Returns std::nullopt if the values are incomplete.
+   */
+  [[nodiscard]]
+  static std::optional<DataStatistics> FromValues(std::vector<double> const& values);
+
+private:
+  uint64_t numberOfRows = 0;
+  std::vector<ValueAccumulator> inputAccumulators;
+  std::vector<ValueAccumulator> outputAccumulators;
+  std::optional<ScalingThreshold> threshold;
+  // Output min/max values of the data points below or at the threshold (first) and above the threshold (second):
+  std::pair<MinMaxVector, MinMaxVector> thresholdOutputMinMax {};
+  std::pair<uint64_t, uint64_t> thresholdCounts {0, 0};
+};
+
+}
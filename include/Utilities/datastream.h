@@ -0,0 +1,126 @@
+#pragma once
+
+#include "Utilities/constants.h"
+#include "Utilities/datasetcache.h"
+#include "Utilities/mappedfile.h"
+#include "Utilities/programoptions.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+
+namespace Utilities {
+
+/*
+ * Reads the input file (or its dataset cache) in chunks of data points, so the data never has to fit into the memory at once.
+ * Every pass over the data reads the chunks on a background thread, the next chunk is read and prepared while the current one is used.
+ * At most the current chunk, one prepared chunk and the chunk being read exist at the same time.
+ */
+class DataStream
+{
+public:
+  /*
+   * Prepares a chunk in place (e.g. scaling and normalization) on the background thread.
+   */
+  using ChunkPreparation = std::function<void(torch::Tensor& inputs, torch::Tensor& outputs)>;
+
+  /*
+   * Opens the input file of the given options. If the dataset cache is activated and up to date, the cache is read instead.
+   * The tensors of a chunk take at most the given number of bytes.
+   */
+  DataStream(ProgramOptions const& options, uint64_t maximumChunkSizeInBytes);
+  /*
+   * Destructor which stops a running pass.
+   */
+  ~DataStream();
+
+  DataStream(DataStream const&) = delete;
+  DataStream& operator=(DataStream const&) = delete;
+
+public:
+  /*
+   * Returns true if the input file (or cache) could be opened.
+   */
+  [[nodiscard]]
+  bool isOpen() const { return open; }
+  [[nodiscard]]
+  std::string const& fileHeader() const { return header; }
+  /*
+   * Returns the min/max values of the unscaled columns if the data is read from the dataset cache.
+   */
+  [[nodiscard]]
+  std::optional<MinMaxValues> cachedMinMax() const;
+  /*
+   * Returns the number of data points if it is known (from the dataset cache or after a complete pass).
+   */
+  [[nodiscard]]
+  std::optional<uint64_t> numberOfDataPoints() const;
+  /*
+   * Sets the preparation which is applied to every chunk of the following passes.
+   */
+  void setPreparation(ChunkPreparation chunkPreparation);
+  /*
+   * Starts a new pass over all data points (a running pass is stopped). If a seed is given, the chunks are read in random order.
+   */
+  void start(std::optional<uint64_t> shuffleSeed = std::nullopt);
+  /*
+   * Returns the next chunk (input and output tensor [rows, columns]) of the current pass.
+   * Returns std::nullopt at the end of the pass or if a chunk could not be read (see failed).
+   */
+  [[nodiscard]]
+  std::optional<std::pair<torch::Tensor, torch::Tensor>> next();
+  /*
+   * Returns true if a chunk of the last pass could not be read. The error was already printed.
+   */
+  [[nodiscard]]
+  bool failed() const;
+
+private:
+  /*
+   * Runs on the background thread and reads the chunks in the given order until the pass is complete or stopped.
+   */
+  void readAhead(std::vector<size_t> order);
+  /*
+   * Reads and prepares the given chunk. The memory of a parsed chunk of the input file is released afterwards.
+   * Returns std::nullopt if the chunk could not be parsed.
+   */
+  [[nodiscard]]
+  std::optional<std::pair<torch::Tensor, torch::Tensor>> readChunk(size_t chunk) const;
+  /*
+   * Stops a running pass and waits for the background thread.
+   */
+  void stop();
+
+private:
+  FilePath path;
+  uint32_t numberOfInputs;
+  uint32_t numberOfOutputs;
+  bool open = false;
+  std::string header {};
+
+  // The data is either read from the dataset cache (chunks of rows) or parsed from the input file (chunks of lines):
+  std::unique_ptr<DatasetCacheReader> cacheReader {nullptr};
+  std::unique_ptr<MappedFile> inputFile {nullptr};
+  std::vector<std::string_view> lineChunks {};
+  std::vector<uint32_t> columns {}; // selected columns of the input file
+  uint64_t numberOfRowsPerChunk = 0;
+  size_t numberOfChunks = 0;
+
+  ChunkPreparation preparation {};
+
+  mutable std::mutex mutex {};
+  std::condition_variable condition {};
+  std::deque<std::pair<torch::Tensor, torch::Tensor>> readyChunks {};
+  uint64_t numberOfReadRows = 0;
+  std::optional<uint64_t> knownNumberOfRows {};
+  bool finished = true;
+  bool stopped = false;
+  bool readError = false;
+  std::thread reader {};
+};
+
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Utilities {
+
+/*
+ * Approximates quantiles of non-negative values with logarithmic buckets.
+ * Each returned quantile has a relative error of at most the given relative accuracy.
+ * Two sketches with the same accuracy can be merged, e.g. after collecting values on different threads.
+ */
+class QuantileSketch
+{
+public:
+  explicit QuantileSketch(double relativeAccuracy = 0.01);
+
+public:
+  /*
+   * Adds a value to the sketch. Negative values and NaN are ignored.
+   */
+  void add(double value);
+  /*
+   * Merges the values of the other sketch into this sketch.
+   */
+  void merge(QuantileSketch const& other);
+  /*
+   * Returns the approximated q-quantile (q between 0 and 1) of all added values.
+   */
+  [[nodiscard]]
+  double quantile(double q) const;
+  /*
+   * Returns the number of added values.
+   */
+  [[nodiscard]]
+  uint64_t count() const;
+
+private:
+  [[nodiscard]]
+  int32_t bucketIndex(double value) const;
+  [[nodiscard]]
+  double bucketValue(int32_t index) const;
+
+private:
+  double gamma;
+  double logGamma;
+  uint64_t zeroCount = 0;
+  int32_t firstBucketIndex = 0;
+  std::vector<uint64_t> buckets {};
+};
+
+/*
+ * Error statistics of one column.
+ */
+class ErrorStatistics
+{
+public:
+  uint64_t count;
+  double meanAbsoluteError;
+  double maxAbsoluteError;
+  double maxRelativeError;
+  double absoluteErrorP50;
+  double absoluteErrorP95;
+  double absoluteErrorP99;
+};
+
+/*
+ * Error statistics of all output columns, once on the normalized and once on the denormalized values.
+ */
+class ErrorReport
+{
+public:
+  std::vector<ErrorStatistics> normalized;
+  std::vector<ErrorStatistics> denormalized;
+};
+
+/*
+ * Collects the error statistics of multiple columns in a streaming fashion.
+ * Accumulators of different threads can be merged into one.
+ */
+class ErrorAccumulator
+{
+public:
+  explicit ErrorAccumulator(size_t numberOfColumns = 0);
+
+public:
+  /*
+   * Adds the error of one value in the given column.
+   * The relative error is only collected if the wanted value is not zero.
+   */
+  void add(size_t column, double wantedValue, double actualValue);
+  /*
+   * Merges the values of the other accumulator into this accumulator.
+   */
+  void merge(ErrorAccumulator const& other);
+  /*
+   * Returns the statistics of all columns.
+   */
+  [[nodiscard]]
+  std::vector<ErrorStatistics> statistics() const;
+
+private:
+  class ColumnAccumulator
+  {
+  public:
+    uint64_t count = 0;
+    double absoluteErrorSum = 0.0;
+    double maxAbsoluteError = 0.0;
+    double maxRelativeError = 0.0;
+    QuantileSketch absoluteErrors {};
+  };
+
+  std::vector<ColumnAccumulator> columns;
+};
+
+}
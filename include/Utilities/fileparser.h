@@ -1,26 +1,108 @@
 #pragma once
 
 #include "Utilities/constants.h"
+#include "Utilities/datastatistics.h"
+#include "Utilities/erroraccumulator.h"
+#include "Utilities/programoptions.h"
+#include "Utilities/telemetry.h"
 
 #include <optional>
+#include <string_view>
 
 namespace Utilities {
 
 class FileParser
 {
 public:
+  using ParseError = std::pair<uint64_t, std::string>; // line number and message
+
+  /*
+   * Parses the given file and returns the data as two contiguous tensors [rows, columns] (input and output) and the file header.
+   * The file is memory-mapped and parsed in parallel, errors report the line number.
+   * If column names are given, only these columns are parsed (see SelectColumns). If statistics are given, the statistics of the parsed
+   * data points are collected while parsing and merged into them.
+   */
+  [[nodiscard]]
+  static std::optional<std::pair<torch::Tensor, torch::Tensor>> ParseInputTensors(std::string const& path, uint32_t numberOfInputNodes, uint32_t numberOfOutputNodes,
+                                                                                  std::string& fileHeader, std::vector<std::string> const& inputColumnNames = {},
+                                                                                  std::vector<std::string> const& outputColumnNames = {},
+                                                                                  DataStatistics* statistics = nullptr);
   /*
-   * Parses the given file and returns the data and the file header.
+   * Parses the given lines of an input file (without the file header) in parallel into two contiguous tensors [rows, columns] (input and output).
+   * The given columns of every line (first the input, then the output columns) are parsed, all other values are skipped without converting them.
+   * Errors report the line number in the given file, counted from the given number of the first line.
+   * If statistics are given, every thread collects the statistics of its data points while parsing, which are merged into the given statistics.
+   * If an error is given, the first error is stored in it instead of being printed.
    */
-  static std::optional<DataVector> ParseInputFile(std::string const& path, uint32_t numberOfInputNodes, uint32_t numberOfOutputNodes, std::string& fileHeader);
+  [[nodiscard]]
+  static std::optional<std::pair<torch::Tensor, torch::Tensor>> ParseLines(std::string_view lines, uint64_t firstLineNumber, uint32_t numberOfInputNodes,
+                                                                           uint32_t numberOfOutputNodes, std::vector<uint32_t> const& columns,
+                                                                           std::string const& path, DataStatistics* statistics = nullptr,
+                                                                           ParseError* error = nullptr);
   /*
-   * Saves the data to given file path together with the given file header.
+   * Returns the indices of the columns with the given names in the given file header (first the input, then the output columns) and reduces
+   * the file header to these columns. Without names, the first columns are the input and the following columns the output columns.
+   * Returns std::nullopt if a name is not part of the file header or the file header has an empty column name.
+   */
+  [[nodiscard]]
+  static std::optional<std::vector<uint32_t>> SelectColumns(std::string& fileHeader, std::vector<std::string> const& inputColumnNames,
+                                                            std::vector<std::string> const& outputColumnNames, uint32_t numberOfInputNodes,
+                                                            uint32_t numberOfOutputNodes, std::string const& path);
+  /*
+   * Parses the given file and returns the data and the file header. The tensors of all data points share the memory of two contiguous tensors.
+   * A NumPy array (.npy file) is loaded without parsing (see NpyFile::Load), its file header names the columns input1, ..., output1, ...
+   */
+  static std::optional<DataVector> ParseInputFile(std::string const& path, uint32_t numberOfInputNodes, uint32_t numberOfOutputNodes, std::string& fileHeader,
+                                                  std::vector<std::string> const& inputColumnNames = {}, std::vector<std::string> const& outputColumnNames = {});
+  /*
+   * Loads the input data of the given options (see ParseInputFile). If the dataset cache is activated, the data is loaded from the cache
+   * of the input file and the cache is (re)created if it is missing or outdated. NumPy arrays (the input file and the optional target file)
+   * are loaded without parsing and without the cache. Without a target file, the first columns of the input array are the input and the following
+   * columns the output variables.
+   * The statistics of the unscaled data (including the min/max values for the mixed scaling of the options) are returned as well, so
+   * they do not have to be calculated in another pass over the data.
+   */
+  static std::optional<DataVector> LoadInputData(ProgramOptions const& options, std::string& fileHeader, DataStatistics& statistics);
+  /*
+   * Saves the data to given file path together with the given file header (see SaveTensors).
    */
   static void SaveData(DataVector const& data, std::string const& outputFilePath, std::string const& fileHeader);
+  /*
+   * Saves the given tensors [rows, columns] (input and output) to the given file path together with the given file header.
+   * Blocks of rows are formatted in parallel and written in order, the values are written like std::ostream writes them.
+   * If the file path has the extension .npy, the values are saved as one NumPy array [rows, input and output columns] instead.
+   */
+  static void SaveTensors(torch::Tensor const& inputs, torch::Tensor const& outputs, std::string const& outputFilePath, std::string const& fileHeader);
   /*
    * Saves the given progress data to the given file path.
+   * If saveLearnRate is true, the learning rate of each epoch is saved in an additional column.
+   */
+  static void SaveProgressData(ProgressVector const& data, std::string const& filePath, bool saveLearnRate = false);
+  /*
+   * Saves the given error reports as JSON to the given file path. Each report is stored under its name.
+   * The output columns are named after the given column names.
+   */
+  static void SaveErrorReports(std::vector<std::pair<std::string, ErrorReport>> const& reports, std::string const& filePath, std::vector<std::string> const& columnNames);
+  /*
+   * Saves the given telemetry report (phase timings, training throughput and memory usage) as JSON to the given file path.
+   */
+  static void SaveTelemetryReport(TelemetryReport const& report, std::string const& filePath);
+  /*
+   * Parses the given sweep specification. Every line has the form "<parameter> = <value>, <value>, ...".
+   * Empty lines and everything after a '#' are ignored.
+   */
+  static std::optional<SweepSpecification> ParseSweepSpecification(std::string const& path);
+  /*
+   * Saves the given (ranked) sweep results to the given file path.
+   * If saveValidationError is true, the validation error of each trial is saved in an additional column.
+   */
+  static void SaveSweepResults(SweepResultVector const& results, std::string const& filePath, bool saveValidationError = false);
+  /*
+   * Splits the given file header into its (trimmed) column names. The names are separated by commas or, if there is no comma, by whitespaces
+   * (like the values of the data lines).
    */
-  static void SaveProgressData(ProgressVector const& data, std::string const& filePath);
+  [[nodiscard]]
+  static std::vector<std::string> SplitFileHeader(std::string const& fileHeader);
 };
 
 }
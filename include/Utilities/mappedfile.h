@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace Utilities {
+
+/*
+ * Memory mapping of a whole file. The mapping is released when the object is destroyed.
+ * The mapping is read-only unless it is copy-on-write, then the mapped memory can be written but the changes never reach the file.
+ */
+class MappedFile
+{
+public:
+  /*
+   * Maps the file with the given path. Use isOpen to check if the file could be mapped.
+   */
+  explicit MappedFile(std::string const& path, bool copyOnWrite = false);
+  ~MappedFile();
+
+  MappedFile(MappedFile const&) = delete;
+  MappedFile& operator=(MappedFile const&) = delete;
+
+public:
+  /*
+   * Returns true if the file could be opened. Empty files are open but have no data.
+   */
+  [[nodiscard]]
+  bool isOpen() const { return open; }
+  [[nodiscard]]
+  char const* data() const { return address; }
+  /*
+   * Returns the mapped memory if the mapping is copy-on-write, otherwise nullptr.
+   */
+  [[nodiscard]]
+  char* writableData() const { return writable ? const_cast<char*>(address) : nullptr; }
+  [[nodiscard]]
+  size_t size() const { return length; }
+  /*
+   * Returns the content of the file as one string view (valid as long as the object exists).
+   */
+  [[nodiscard]]
+  std::string_view content() const { return std::string_view(address, length); }
+  /*
+   * Releases the memory of the pages of the given part of the content, they are read from the file again when they are accessed.
+   * Copy-on-write mappings are not released, their changes would be lost.
+   */
+  void release(std::string_view part) const;
+
+private:
+  char const* address = nullptr;
+  size_t length = 0;
+  bool open = false;
+  bool writable = false;
+};
+
+}
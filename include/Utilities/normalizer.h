@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Utilities/constants.h"
+
+namespace Utilities {
+
+/*
+ * Maps the values of every column linearly from its min/max range to a new range (normalization) and back (denormalization).
+ * The scale and offset of every column are calculated once, so (de)normalizing a batch of data points [rows, columns] or a single data point
+ * [columns] is one fused multiply-add (plus a clamp if the values are limited).
+ */
+class Normalizer
+{
+public:
+  Normalizer() = default;
+  /*
+   * Creates the normalization of the columns with the given min/max values to the range [newMinValue, newMaxValue].
+   */
+  Normalizer(MinMaxVector const& minMaxVector, TensorDataType newMinValue, TensorDataType newMaxValue);
+
+public:
+  /*
+   * Returns true if the normalizer was created with min/max values.
+   */
+  [[nodiscard]]
+  bool isValid() const { return normalizationScale.defined(); }
+  /*
+   * Normalizes the given tensor in place. Tensors with another number of columns are left unchanged.
+   */
+  void normalize(torch::Tensor& tensor) const;
+  /*
+   * Denormalizes the given tensor in place. If limitValues is true, the values are limited to the normalized range first, so the results
+   * stay within the min/max values. Tensors with another number of columns are left unchanged.
+   */
+  void denormalize(torch::Tensor& tensor, bool limitValues = false) const;
+
+private:
+  /*
+   * Applies tensor = tensor * scale + offset in place with the scale and offset of the data type of the tensor.
+   */
+  static void multiplyAdd(torch::Tensor& tensor, torch::Tensor const& scale, torch::Tensor const& offset);
+
+private:
+  TensorDataType normalizedMinValue = 0.0;
+  TensorDataType normalizedMaxValue = 1.0;
+  torch::Tensor normalizationScale {};
+  torch::Tensor normalizationOffset {};
+  torch::Tensor denormalizationScale {};
+  torch::Tensor denormalizationOffset {};
+};
+
+}
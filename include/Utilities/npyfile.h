@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Utilities/constants.h"
+
+namespace Utilities {
+
+/*
+ * Reads and writes NumPy arrays in the .npy format (version 1.0 to 3.0) without Python.
+ * Only one- and two-dimensional little-endian arrays of float64, float32, int64 and int32 values are supported.
+ */
+class NpyFile
+{
+public:
+  /*
+   * Returns true if the given path has the extension ".npy".
+   */
+  [[nodiscard]]
+  static bool HasNpyExtension(FilePath const& path);
+  /*
+   * Loads the array of the given file as tensor [rows, columns] of TensorDataType (a one-dimensional array is one column).
+   * The file is memory-mapped. An array of TensorDataType values in C order is used without copying it: the tensor keeps the copy-on-write
+   * mapping alive, changes of the tensor never reach the file. All other arrays are converted into a new tensor.
+   * Returns std::nullopt (and prints the reason) if the file is not a supported .npy file.
+   */
+  [[nodiscard]]
+  static std::optional<torch::Tensor> Load(FilePath const& path);
+  /*
+   * Saves the given tensor [rows, columns] as .npy file of float64 values in C order.
+   */
+  static bool Save(torch::Tensor const& values, FilePath const& path);
+};
+
+}
@@ -9,13 +9,59 @@
 
 namespace Utilities {
 
+enum class OptimizerType
+{
+  SGD, Momentum, Adam, RMSprop, LBFGS
+};
+
+const std::map<std::string, OptimizerType> OptimizerTypeMap {
+  {"sgd",      OptimizerType::SGD},
+  {"momentum", OptimizerType::Momentum},
+  {"adam",     OptimizerType::Adam},
+  {"rmsprop",  OptimizerType::RMSprop},
+  {"lbfgs",    OptimizerType::LBFGS}
+};
+
+enum class LearnRateScheduleType
+{
+  Constant, Step, Cosine, Exponential, Plateau
+};
+
+const std::map<std::string, LearnRateScheduleType> LearnRateScheduleTypeMap {
+  {"constant",    LearnRateScheduleType::Constant},
+  {"step",        LearnRateScheduleType::Step},
+  {"cosine",      LearnRateScheduleType::Cosine},
+  {"exponential", LearnRateScheduleType::Exponential},
+  {"plateau",     LearnRateScheduleType::Plateau}
+};
+
+enum class ParallelModeType
+{
+  AllReduce, Hogwild
+};
+
+const std::map<std::string, ParallelModeType> ParallelModeTypeMap {
+  {"allreduce", ParallelModeType::AllReduce},
+  {"hogwild",   ParallelModeType::Hogwild}
+};
+
+const std::map<std::string, torch::ScalarType> PrecisionMap {
+  {"double", torch::kDouble},
+  {"float",  torch::kFloat}
+};
+
 namespace DefaultValues {
 
 const FilePath                INPUT_DATA_FILE_PATH = {};
+const FilePath                TARGET_DATA_FILE_PATH = {};
 const FilePath                INPUT_NETWORK_PARAMETERS = {};
 const FilePath                OUTPUT_NETWORK_PARAMETERS = {};
 const uint32_t                NUMBER_OF_INPUT_VARIABLES = 1;
 const uint32_t                NUMBER_OF_OUTPUT_VARIABLES = 1;
+const std::vector<std::string> INPUT_COLUMN_NAMES = {};
+const std::vector<std::string> OUTPUT_COLUMN_NAMES = {};
+const bool                    USE_DATASET_CACHE = false;
+const std::optional<uint64_t> MEMORY_BUDGET_IN_MB = std::nullopt;
 const uint32_t                NUMBER_OF_EPOCHS = 10;
 const bool                    SHOW_PROGRESS_DURING_TRAINING = true;
 const bool                    INTERACTIVE_MODE = false;
@@ -28,29 +74,71 @@ const uint32_t                MIXED_SCALING_INPUT_VARIABLE = 0;
 const TensorDataType          MIXED_SCALING_THRESHOLD = 0.0;
 const bool                    VALIDATE_AFTER_TRAINING = false;
 const double                  VALIDATION_PERCENTAGE = 30.0;
+const std::optional<uint32_t> VALIDATION_INTERVAL = std::nullopt;
+const uint32_t                VALIDATION_PATIENCE = 5;
+const std::optional<uint32_t> NUMBER_OF_FOLDS = std::nullopt;
 const FilePath                OUTPUT_VALUE = {};
 const FilePath                OUTPUT_DIFF = {};
 const FilePath                OUTPUT_RELATIVE_DIFF = {};
 const bool                    PRINT_BEHAVIOUR = false;
+const FilePath                OUTPUT_REPORT = {};
+const FilePath                METRICS_FILE_PATH = {};
 const int32_t                 NUMBER_OF_THREADS = torch::get_num_threads();
+const torch::ScalarType       PRECISION = TORCH_DATA_TYPE;
 const FilePath                INPUT_MIN_MAX_FILE_PATH = {};
 const FilePath                OUTPUT_MIN_MAX_FILE_PATH = {};
 const double                  LEARN_RATE = 0.001;
+const bool                    LEARN_RATE_SET = false;
+const double                  LBFGS_LEARN_RATE = 1.0;
+const OptimizerType           OPTIMIZER = OptimizerType::SGD;
+const double                  MOMENTUM = 0.9;
+const double                  WEIGHT_DECAY = 0.0;
+const double                  ADAM_BETA_1 = 0.9;
+const double                  ADAM_BETA_2 = 0.999;
+const double                  RMSPROP_ALPHA = 0.99;
+const uint32_t                LBFGS_MAX_ITERATIONS = 20;
+const uint32_t                LBFGS_HISTORY_SIZE = 100;
+const LearnRateScheduleType   LEARN_RATE_SCHEDULE = LearnRateScheduleType::Constant;
+const uint32_t                LEARN_RATE_WARMUP_EPOCHS = 0;
+const uint32_t                LEARN_RATE_STEP_SIZE = 10;
+const double                  LEARN_RATE_GAMMA = 0.1;
+const double                  MINIMUM_LEARN_RATE = 0.0;
+const uint32_t                LEARN_RATE_PATIENCE = 5;
 const TimeoutDuration         MAX_EXECUTION_TIME = std::chrono::duration_cast<TimeoutDuration>(std::chrono::hours(24 * 7)); // TODO change to std::chrono::weeks when switching to C++20
 const uint32_t                NUMBER_OF_DETERIORATIONS = 0;
 const FilePath                PROGRESS_FILE_PATH = {};
+const uint32_t                PROGRESS_INTERVAL = 1;
+const std::optional<uint32_t> CHECKPOINT_INTERVAL = std::nullopt;
+const FilePath                CHECKPOINT_DIRECTORY = {};
+const FilePath                RESUME_DIRECTORY = {};
 const std::optional<uint64_t> RANDOM_GENERATOR_SEED = std::nullopt;
 const uint32_t                NUMBER_OF_LAYERS = 2;
 const uint32_t                NUMBER_OF_NODES_PER_LAYER = 500;
 const std::optional<uint32_t> BATCH_TRAINING_INPUT_VARIABLE = std::nullopt;
+const std::optional<uint32_t> MINI_BATCH_SIZE = std::nullopt;
+const uint32_t                LOSS_EVALUATION_INTERVAL = 1;
+const bool                    SHUFFLE_DATA = false;
+const uint32_t                PREFETCH_BATCHES = 16;
+const uint32_t                DATA_PARALLEL_WORKERS = 1;
+const uint32_t                ALL_REDUCE_MINI_BATCH_SIZE = 32;
+const ParallelModeType        PARALLEL_MODE = ParallelModeType::AllReduce;
+const FilePath                SWEEP_SPECIFICATION_FILE_PATH = {};
+const uint32_t                SWEEP_PARALLEL_TRIALS = 1;
+const uint32_t                SWEEP_RUNG_EPOCHS = 5;
+const FilePath                SWEEP_RESULT_FILE_PATH = {};
 const bool                    DEBUG_OUTPUT = false;
 
 const std::string CLI_HELP_TEXT = {
   std::string("List of possible commandline parameters:\n") +
   "--help | -h                        : Output this text message.\n" +
-  "--input <filepath> | -i <filepath> : Use content of <filepath> for the input data.\n" +
+  "--input <filepath> | -i <filepath> : Use content of <filepath> for the input data. NumPy arrays (.npy files) are loaded without parsing.\n" +
+  "--targets <filepath>               : Use the NumPy array (.npy file) in <filepath> for the output variables, the array of --input (.npy file) then only contains the input variables.\n" +
   "--numberIn X | -ni X               : Sets the number of input variables to X. Default: " + std::to_string(NUMBER_OF_INPUT_VARIABLES) + "\n" +
   "--numberOut X | -no X              : Sets the number of output variables to X. Default: " + std::to_string(NUMBER_OF_OUTPUT_VARIABLES) + "\n" +
+  "--inputColumns <names>             : Uses the named columns of the file header (e.g. a,b,c) as input variables instead of the first columns, all other columns are skipped.\n" +
+  "--outputColumns <names>            : Uses the columns with the given names of the file header as output variables. Sets the number of output variables. Requires --inputColumns.\n" +
+  "--cache                            : If set, stores the parsed input data in a binary cache (<filepath>.nncache) and loads it from there as long as the input file is unchanged.\n" +
+  "--memoryBudget X                   : If set, streams the input file (or its cache) in chunks of at most X MB instead of loading it completely. Only supports the training itself.\n" +
   "--epochs X | -e X                  : Sets the minimum number of epochs (how many times the data is used for training). Default: " + std::to_string(NUMBER_OF_EPOCHS) + "\n" +
   "--showProgress <bool>              : Activate or deactivate display of progress and eta of the training. Default: " + (SHOW_PROGRESS_DURING_TRAINING ? "true" : "false") + "\n" +
   "--inWeights <filepath>             : If set, loads the weights in the file for the network in the initialization phase.\n" +
@@ -63,22 +151,55 @@ const std::string CLI_HELP_TEXT = {
   "--logSqrtScaling X <double>        : If set, scales the output logarithmic if input X [1, ..] is below or equal the given value and sqrt scaling above it. Does not work together with other scaling options.\n" +
   "--validate                         : If set, splits the data set in a training and validation set. After the training the network is tested with the validation set.\n" +
   "--validatePercentage <double>      : Sets the percentage of the data, which is only used for validation and not for training. Value should be between 0 and 100. Default: " + std::to_string(VALIDATION_PERCENTAGE) + "\n" +
-  "--outValues <filepath>             : If set, saves the output of the neural network for all input values to the specified file.\n" +
-  "--outDiff <filepath>               : If set, saves the difference of the output of the neural network and given input values to the specified file.\n" +
-  "--outRelativeDiff <filepath>       : If set, saves the relative difference of the output of the neural network and given input values to the specified file.\n" +
+  "--validateEvery X                  : If set, evaluates the validation set every X epochs and stops the training with the best weights when it does not improve anymore.\n" +
+  "--validationPatience X             : Sets the number of validation evaluations without improvement before the training is stopped. Default: " + std::to_string(VALIDATION_PATIENCE) + "\n" +
+  "--kFold K                          : If set, evaluates the network options with a K-fold cross-validation and reports the mean and standard deviation of the metrics.\n" +
+  "--outValues <filepath>             : If set, saves the output of the neural network for all input values to the specified file (as NumPy array if it is a .npy file).\n" +
+  "--outDiff <filepath>               : If set, saves the difference of the output of the neural network and given input values to the specified file (as NumPy array if it is a .npy file).\n" +
+  "--outRelativeDiff <filepath>       : If set, saves the relative difference of the output of the neural network and given input values to the specified file (as NumPy array if it is a .npy file).\n" +
   "--printBehaviour                   : If set, outputs the behaviour of the neural network to the console for the given input values.\n" +
+  "--outReport <filepath>             : If set, saves error statistics (MAE, max error, max relative error, error quantiles) of each output as JSON to the specified file.\n" +
+  "--metrics <filepath>               : If set, saves the wall and CPU time of each phase, the training throughput of each epoch, the peak memory usage and the size of the data as JSON to the specified file.\n" +
   "--threads X | -t X                 : Sets the number of used threads to X. Default value depends on the given system. Default value of the current system: " + std::to_string(NUMBER_OF_THREADS) + "\n" +
+  "--precision <name>                 : Sets the floating point precision of the training and inference: double or float. Normalization is always calculated in double precision. Default: double\n" +
   "--inMinMax <filepath>              : If set, uses the data in the given file to use as min/max values for normalization.\n" +
   "--outMinMax <filepath>             : If set, saves the used min/max values to the given file.\n" +
-  "--learnRate <double>               : Sets the learning rate of the statistical gradient descent. Default: " + std::to_string(LEARN_RATE) + "\n" +
+  "--learnRate <double>               : Sets the learning rate of the optimizer. Default: " + std::to_string(LEARN_RATE) + " (" + std::to_string(LBFGS_LEARN_RATE) + " for lbfgs)\n" +
+  "--optimizer <name>                 : Sets the optimizer: sgd, momentum (SGD with momentum), adam, rmsprop or lbfgs (full-batch L-BFGS, one step per epoch). Default: sgd\n" +
+  "--momentum <double>                : Sets the momentum of the momentum optimizer. Default: " + std::to_string(MOMENTUM) + "\n" +
+  "--weightDecay <double>             : Sets the weight decay (L2 penalty) of the sgd, momentum, adam and rmsprop optimizers. Default: " + std::to_string(WEIGHT_DECAY) + "\n" +
+  "--adamBetas <double> <double>      : Sets the coefficients beta1 and beta2 of the adam optimizer. Default: " + std::to_string(ADAM_BETA_1) + " " + std::to_string(ADAM_BETA_2) + "\n" +
+  "--rmspropAlpha <double>            : Sets the smoothing constant of the rmsprop optimizer. Default: " + std::to_string(RMSPROP_ALPHA) + "\n" +
+  "--lbfgsMaxIterations X             : Sets the maximum number of L-BFGS iterations per epoch. Default: " + std::to_string(LBFGS_MAX_ITERATIONS) + "\n" +
+  "--lbfgsHistorySize X               : Sets the number of past updates which L-BFGS keeps to approximate the Hessian. Default: " + std::to_string(LBFGS_HISTORY_SIZE) + "\n" +
+  "--learnRateSchedule <name>         : Sets the learning rate schedule: constant, step, cosine, exponential or plateau (reduce on plateau of the mean squared error). Default: constant\n" +
+  "--warmupEpochs X                   : Increases the learning rate linearly during the first X epochs. Default: " + std::to_string(LEARN_RATE_WARMUP_EPOCHS) + "\n" +
+  "--learnRateStepSize X              : Multiplies the learning rate with the learning rate gamma every X epochs (step schedule). Default: " + std::to_string(LEARN_RATE_STEP_SIZE) + "\n" +
+  "--learnRateGamma <double>          : Sets the factor of the step, exponential (per epoch) and plateau schedules. Default: " + std::to_string(LEARN_RATE_GAMMA) + "\n" +
+  "--minLearnRate <double>            : Sets the lower bound of the learning rate for the cosine and plateau schedules. Default: " + std::to_string(MINIMUM_LEARN_RATE) + "\n" +
+  "--learnRatePatience X              : Sets the number of exact loss evaluations without improvement before the plateau schedule reduces the learning rate. Default: " + std::to_string(LEARN_RATE_PATIENCE) + "\n" +
   "--timeoutInMinutes X               : Sets the timeout of the program to X minutes. Default: 1 week.\n" +
   "--timeoutInHours X                 : Sets the timeout of the program to X hours. Default: 1 week.\n" +
   "--numberOfDeteriorations X         : Sets the number of epochs in a row in which the improvement can be worse than the set epsilon without stopping. Default: " + std::to_string(NUMBER_OF_DETERIORATIONS) + "\n" +
   "--saveProgress <filepath>          : If set, saves the progress in a CSV file at the specified path.\n" +
+  "--progressEvery X                  : Saves the progress (see --saveProgress) only every X epochs. The progress is calculated on a background thread during the training. Default: " + std::to_string(PROGRESS_INTERVAL) + "\n" +
+  "--checkpointEvery X                : If set, saves a checkpoint (weights, optimizer and training state) every X epochs and after the last epoch (also after a timeout or a stop) to the directory of --checkpointDir.\n" +
+  "--checkpointDir <directory>        : Sets the directory of the checkpoints. The last checkpoint is replaced atomically.\n" +
+  "--resume <directory>               : If set, continues the training from the checkpoint in the given directory. Needs the same input data and network options.\n" +
   "--seed <uint64>                    : Sets the seed of the random number generator, which is used for initializing the network parameters.\n" +
   "--layers X                         : Sets the number of layers of the NN to X. Default: " + std::to_string(NUMBER_OF_LAYERS) + "\n" +
   "--nodes X                          : Sets the number of nodes per layer of the NN to X. Default: " + std::to_string(NUMBER_OF_NODES_PER_LAYER) + "\n" +
   "--batchVariable X                  : If set, concatenates training data around input variable X [1, ..] to batches.\n" +
+  "--miniBatch X                      : If set, trains on shuffled mini-batches of X data points with one optimizer step per mini-batch.\n" +
+  "--lossEvaluationInterval X         : Calculates the exact mean squared error only every X epochs, the loss of the training pass is shown in between. Default: " + std::to_string(LOSS_EVALUATION_INTERVAL) + "\n" +
+  "--shuffle                          : If set, trains on the data points in a new random order in every epoch. Mini-batches are always shuffled.\n" +
+  "--prefetch X                       : Sets the number of shuffled batches (or data points) which are assembled in advance on a background thread. Default: " + std::to_string(PREFETCH_BATCHES) + "\n" +
+  "--dataParallel X                   : Trains with X worker threads, each on its own part of the training data. Default: " + std::to_string(DATA_PARALLEL_WORKERS) + "\n" +
+  "--parallelMode <name>              : Sets how the workers of --dataParallel update the network: allreduce (averaged gradients) or hogwild (lock-free shared parameters). Default: allreduce\n" +
+  "--sweep <filepath>                 : If set, trains every combination of the parameter values in the given file (e.g. \"learnRate = 0.01, 0.001\") and stops weak combinations early.\n" +
+  "--sweepParallel X                  : Sets the number of sweep trials which are trained at the same time (sharing the threads of --threads). Default: " + std::to_string(SWEEP_PARALLEL_TRIALS) + "\n" +
+  "--sweepRungEpochs X                : Sets the number of epochs of the first sweep round, the worse half of the trials is stopped after every round. Default: " + std::to_string(SWEEP_RUNG_EPOCHS) + "\n" +
+  "--sweepOut <filepath>              : If set, saves the ranked results of the sweep trials in a CSV file at the specified path.\n" +
   "--debugOutput                      : If set, some debug information gets outputted to the console.\n"
 };
 
@@ -86,10 +207,13 @@ const std::string CLI_HELP_TEXT = {
 
 enum class CLIParameters
 {
-  Help, InputFilePath, NumberOfInputVariables, NumberOfOutputVariables, NumberOfEpochs, ShowProgressDuringTraining, InputNetworkParameters,
-  OutputNetworkParameters, Interactive, Epsilon, LogScaling, SqrtScaling, LogLinScaling, LogSqrtScaling, Validate, ValidatePercentage, OutValues,
-  OutDiff, OutRelativeDiff, PrintBehaviour, Threads, InputMinMax, OutputMinMax, LearnRate, TimeoutMinutes, TimeoutHours, NumberOfDeteriorations,
-  SaveProgress, Seed, NumberOfLayers, NumberOfNodes, BatchVariable, DebugOutput
+  Help, InputFilePath, TargetFilePath, NumberOfInputVariables, NumberOfOutputVariables, InputColumns, OutputColumns, Cache, MemoryBudget, NumberOfEpochs, ShowProgressDuringTraining, InputNetworkParameters,
+  OutputNetworkParameters, Interactive, Epsilon, LogScaling, SqrtScaling, LogLinScaling, LogSqrtScaling, Validate, ValidatePercentage, ValidateEvery,
+  ValidationPatience, KFold, OutValues, OutDiff, OutRelativeDiff, PrintBehaviour, OutReport, Metrics, Threads, Precision, InputMinMax, OutputMinMax, LearnRate, Optimizer, Momentum, WeightDecay, AdamBetas,
+  RMSpropAlpha, LBFGSMaxIterations, LBFGSHistorySize, LearnRateSchedule, WarmupEpochs, LearnRateStepSize, LearnRateGamma, MinLearnRate,
+  LearnRatePatience, TimeoutMinutes, TimeoutHours, NumberOfDeteriorations,
+  SaveProgress, ProgressEvery, CheckpointEvery, CheckpointDirectory, Resume, Seed, NumberOfLayers, NumberOfNodes, BatchVariable, MiniBatch, LossEvaluationInterval, Shuffle, Prefetch, DataParallel, ParallelMode,
+  Sweep, SweepParallel, SweepRungEpochs, SweepOut, DebugOutput
 };
 
 const std::map<std::string, CLIParameters> CLIParameterMap {
@@ -97,10 +221,15 @@ const std::map<std::string, CLIParameters> CLIParameterMap {
   {"-h",                      CLIParameters::Help},
   {"--input",                 CLIParameters::InputFilePath},
   {"-i",                      CLIParameters::InputFilePath},
+  {"--targets",               CLIParameters::TargetFilePath},
   {"--numberIn",              CLIParameters::NumberOfInputVariables},
   {"-ni",                     CLIParameters::NumberOfInputVariables},
   {"--numberOut",             CLIParameters::NumberOfOutputVariables},
   {"-no",                     CLIParameters::NumberOfOutputVariables},
+  {"--inputColumns",          CLIParameters::InputColumns},
+  {"--outputColumns",         CLIParameters::OutputColumns},
+  {"--cache",                 CLIParameters::Cache},
+  {"--memoryBudget",          CLIParameters::MemoryBudget},
   {"--epochs",                CLIParameters::NumberOfEpochs},
   {"-e",                      CLIParameters::NumberOfEpochs},
   {"--showProgress",          CLIParameters::ShowProgressDuringTraining},
@@ -114,23 +243,56 @@ const std::map<std::string, CLIParameters> CLIParameterMap {
   {"--logSqrtScaling",        CLIParameters::LogSqrtScaling},
   {"--validate",              CLIParameters::Validate},
   {"--validatePercentage",    CLIParameters::ValidatePercentage},
+  {"--validateEvery",         CLIParameters::ValidateEvery},
+  {"--validationPatience",    CLIParameters::ValidationPatience},
+  {"--kFold",                 CLIParameters::KFold},
   {"--outValues",             CLIParameters::OutValues},
   {"--outDiff",               CLIParameters::OutDiff},
   {"--outRelativeDiff",       CLIParameters::OutRelativeDiff},
   {"--printBehaviour",        CLIParameters::PrintBehaviour},
+  {"--outReport",             CLIParameters::OutReport},
+  {"--metrics",               CLIParameters::Metrics},
   {"--threads",               CLIParameters::Threads},
   {"-t",                      CLIParameters::Threads},
+  {"--precision",             CLIParameters::Precision},
   {"--inMinMax",              CLIParameters::InputMinMax},
   {"--outMinMax",             CLIParameters::OutputMinMax},
   {"--learnRate",             CLIParameters::LearnRate},
+  {"--optimizer",             CLIParameters::Optimizer},
+  {"--momentum",              CLIParameters::Momentum},
+  {"--weightDecay",           CLIParameters::WeightDecay},
+  {"--adamBetas",             CLIParameters::AdamBetas},
+  {"--rmspropAlpha",          CLIParameters::RMSpropAlpha},
+  {"--lbfgsMaxIterations",    CLIParameters::LBFGSMaxIterations},
+  {"--lbfgsHistorySize",      CLIParameters::LBFGSHistorySize},
+  {"--learnRateSchedule",     CLIParameters::LearnRateSchedule},
+  {"--warmupEpochs",          CLIParameters::WarmupEpochs},
+  {"--learnRateStepSize",     CLIParameters::LearnRateStepSize},
+  {"--learnRateGamma",        CLIParameters::LearnRateGamma},
+  {"--minLearnRate",          CLIParameters::MinLearnRate},
+  {"--learnRatePatience",     CLIParameters::LearnRatePatience},
   {"--timeoutInMinutes",      CLIParameters::TimeoutMinutes},
   {"--timeoutInHours",        CLIParameters::TimeoutHours},
   {"--numberOfDeteriorations",CLIParameters::NumberOfDeteriorations},
   {"--saveProgress",          CLIParameters::SaveProgress},
+  {"--progressEvery",         CLIParameters::ProgressEvery},
+  {"--checkpointEvery",       CLIParameters::CheckpointEvery},
+  {"--checkpointDir",         CLIParameters::CheckpointDirectory},
+  {"--resume",                CLIParameters::Resume},
   {"--seed",                  CLIParameters::Seed},
   {"--layers",                CLIParameters::NumberOfLayers},
   {"--nodes",                 CLIParameters::NumberOfNodes},
   {"--batchVariable",         CLIParameters::BatchVariable},
+  {"--miniBatch",             CLIParameters::MiniBatch},
+  {"--lossEvaluationInterval",CLIParameters::LossEvaluationInterval},
+  {"--shuffle",               CLIParameters::Shuffle},
+  {"--prefetch",              CLIParameters::Prefetch},
+  {"--dataParallel",          CLIParameters::DataParallel},
+  {"--parallelMode",          CLIParameters::ParallelMode},
+  {"--sweep",                 CLIParameters::Sweep},
+  {"--sweepParallel",         CLIParameters::SweepParallel},
+  {"--sweepRungEpochs",       CLIParameters::SweepRungEpochs},
+  {"--sweepOut",              CLIParameters::SweepOut},
   {"--debugOutput",           CLIParameters::DebugOutput}
 };
 
@@ -138,10 +300,15 @@ class ProgramOptions
 {
 public:
   FilePath                InputDataFilePath {          DefaultValues::INPUT_DATA_FILE_PATH };
+  FilePath                TargetDataFilePath {         DefaultValues::TARGET_DATA_FILE_PATH };
   FilePath                InputNetworkParameters {     DefaultValues::INPUT_NETWORK_PARAMETERS };
   FilePath                OutputNetworkParameters {    DefaultValues::OUTPUT_NETWORK_PARAMETERS };
   uint32_t                NumberOfInputVariables {     DefaultValues::NUMBER_OF_INPUT_VARIABLES };
   uint32_t                NumberOfOutputVariables {    DefaultValues::NUMBER_OF_OUTPUT_VARIABLES };
+  std::vector<std::string> InputColumnNames {         DefaultValues::INPUT_COLUMN_NAMES };
+  std::vector<std::string> OutputColumnNames {        DefaultValues::OUTPUT_COLUMN_NAMES };
+  bool                    UseDatasetCache {            DefaultValues::USE_DATASET_CACHE };
+  std::optional<uint64_t> MemoryBudgetInMB {           DefaultValues::MEMORY_BUDGET_IN_MB };
   uint32_t                NumberOfEpochs {             DefaultValues::NUMBER_OF_EPOCHS };
   bool                    ShowProgressDuringTraining { DefaultValues::SHOW_PROGRESS_DURING_TRAINING };
   bool                    InteractiveMode {            DefaultValues::INTERACTIVE_MODE };
@@ -154,21 +321,56 @@ public:
   TensorDataType          MixedScalingThreshold {      DefaultValues::MIXED_SCALING_THRESHOLD };
   bool                    ValidateAfterTraining {      DefaultValues::VALIDATE_AFTER_TRAINING };
   double                  ValidationPercentage {       DefaultValues::VALIDATION_PERCENTAGE };
+  std::optional<uint32_t> ValidationInterval {         DefaultValues::VALIDATION_INTERVAL };
+  uint32_t                ValidationPatience {         DefaultValues::VALIDATION_PATIENCE };
+  std::optional<uint32_t> NumberOfFolds {              DefaultValues::NUMBER_OF_FOLDS };
   FilePath                OutputValuesFilePath {       DefaultValues::OUTPUT_VALUE };
   FilePath                OutputDiffFilePath {         DefaultValues::OUTPUT_DIFF };
   FilePath                OutputRelativeDiffFilePath { DefaultValues::OUTPUT_RELATIVE_DIFF };
   bool                    PrintBehaviour {             DefaultValues::PRINT_BEHAVIOUR };
+  FilePath                OutputReportFilePath {       DefaultValues::OUTPUT_REPORT };
+  FilePath                MetricsFilePath {            DefaultValues::METRICS_FILE_PATH };
   int32_t                 NumberOfThreads {            DefaultValues::NUMBER_OF_THREADS };
+  torch::ScalarType       Precision {                  DefaultValues::PRECISION };
   FilePath                InputMinMaxFilePath {        DefaultValues::INPUT_MIN_MAX_FILE_PATH };
   FilePath                OutputMinMaxFilePath {       DefaultValues::OUTPUT_MIN_MAX_FILE_PATH };
   double                  LearnRate {                  DefaultValues::LEARN_RATE };
+  bool                    LearnRateSet {               DefaultValues::LEARN_RATE_SET }; // false if LearnRate is the default, which depends on the optimizer
+  OptimizerType           Optimizer {                  DefaultValues::OPTIMIZER };
+  double                  Momentum {                   DefaultValues::MOMENTUM };
+  double                  WeightDecay {                DefaultValues::WEIGHT_DECAY };
+  double                  AdamBeta1 {                  DefaultValues::ADAM_BETA_1 };
+  double                  AdamBeta2 {                  DefaultValues::ADAM_BETA_2 };
+  double                  RMSpropAlpha {               DefaultValues::RMSPROP_ALPHA };
+  uint32_t                LBFGSMaxIterations {         DefaultValues::LBFGS_MAX_ITERATIONS };
+  uint32_t                LBFGSHistorySize {           DefaultValues::LBFGS_HISTORY_SIZE };
+  LearnRateScheduleType   LearnRateSchedule {          DefaultValues::LEARN_RATE_SCHEDULE };
+  uint32_t                WarmupEpochs {               DefaultValues::LEARN_RATE_WARMUP_EPOCHS };
+  uint32_t                LearnRateStepSize {          DefaultValues::LEARN_RATE_STEP_SIZE };
+  double                  LearnRateGamma {             DefaultValues::LEARN_RATE_GAMMA };
+  double                  MinLearnRate {               DefaultValues::MINIMUM_LEARN_RATE };
+  uint32_t                LearnRatePatience {          DefaultValues::LEARN_RATE_PATIENCE };
   TimeoutDuration         MaxExecutionTime {           DefaultValues::MAX_EXECUTION_TIME };
   uint32_t                NumberOfDeteriorations {     DefaultValues::NUMBER_OF_DETERIORATIONS };
   FilePath                SaveProgressFilePath {       DefaultValues::PROGRESS_FILE_PATH };
+  uint32_t                ProgressInterval {           DefaultValues::PROGRESS_INTERVAL };
+  std::optional<uint32_t> CheckpointInterval {         DefaultValues::CHECKPOINT_INTERVAL };
+  FilePath                CheckpointDirectory {        DefaultValues::CHECKPOINT_DIRECTORY };
+  FilePath                ResumeDirectory {            DefaultValues::RESUME_DIRECTORY };
   std::optional<uint64_t> RNGSeed {                    DefaultValues::RANDOM_GENERATOR_SEED };
   uint32_t                NumberOfLayers {             DefaultValues::NUMBER_OF_LAYERS };
   uint32_t                NumberOfNodesPerLayer {      DefaultValues::NUMBER_OF_NODES_PER_LAYER };
   std::optional<uint32_t> BatchVariable {              DefaultValues::BATCH_TRAINING_INPUT_VARIABLE };
+  std::optional<uint32_t> MiniBatchSize {              DefaultValues::MINI_BATCH_SIZE };
+  uint32_t                LossEvaluationInterval {     DefaultValues::LOSS_EVALUATION_INTERVAL };
+  bool                    ShuffleData {                DefaultValues::SHUFFLE_DATA };
+  uint32_t                PrefetchBatches {            DefaultValues::PREFETCH_BATCHES };
+  uint32_t                DataParallelWorkers {        DefaultValues::DATA_PARALLEL_WORKERS };
+  ParallelModeType        ParallelMode {               DefaultValues::PARALLEL_MODE };
+  FilePath                SweepSpecificationFilePath { DefaultValues::SWEEP_SPECIFICATION_FILE_PATH };
+  uint32_t                SweepParallelTrials {        DefaultValues::SWEEP_PARALLEL_TRIALS };
+  uint32_t                SweepRungEpochs {            DefaultValues::SWEEP_RUNG_EPOCHS };
+  FilePath                SweepResultFilePath {        DefaultValues::SWEEP_RESULT_FILE_PATH };
   bool                    DebugOutput {                DefaultValues::DEBUG_OUTPUT };
 };
 
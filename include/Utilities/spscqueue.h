@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <optional>
+#include <vector>
+
+namespace Utilities {
+
+/*
+ * Bounded lock-free queue for exactly one producer thread and one consumer thread.
+ */
+template<typename T>
+class SpscQueue
+{
+public:
+  /*
+   * Constructor which creates a queue that holds up to the given number of elements.
+   */
+  explicit SpscQueue(size_t capacity) : buffer(capacity + 1) {}
+
+public:
+  /*
+   * Moves the value into the queue. Returns false (and keeps the value untouched) if the queue is full.
+   * Must only be called by the producer thread.
+   */
+  bool tryPush(T& value)
+  {
+    auto const writePosition = writeIndex.load(std::memory_order_relaxed);
+    auto const nextWritePosition = increment(writePosition);
+
+    if (nextWritePosition == readIndex.load(std::memory_order_acquire)) {
+      return false;
+    }
+
+    buffer[writePosition] = std::move(value);
+    writeIndex.store(nextWritePosition, std::memory_order_release);
+    return true;
+  }
+  /*
+   * Removes the oldest value from the queue. Returns std::nullopt if the queue is empty.
+   * Must only be called by the consumer thread.
+   */
+  std::optional<T> tryPop()
+  {
+    auto const readPosition = readIndex.load(std::memory_order_relaxed);
+
+    if (readPosition == writeIndex.load(std::memory_order_acquire)) {
+      return std::nullopt;
+    }
+
+    auto value = std::make_optional(std::move(buffer[readPosition]));
+    readIndex.store(increment(readPosition), std::memory_order_release);
+    return value;
+  }
+
+private:
+  [[nodiscard]]
+  size_t increment(size_t index) const
+  {
+    return (index + 1) % buffer.size();
+  }
+
+private:
+  std::vector<T> buffer;
+  // Separate cache lines, so producer and consumer do not invalidate each other's index:
+  alignas(64) std::atomic<size_t> readIndex {0};
+  alignas(64) std::atomic<size_t> writeIndex {0};
+};
+
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Utilities/constants.h"
+
+#include <chrono>
+#include <ctime>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Utilities {
+
+/*
+ * Wall and CPU time of one phase. The CPU time is the time of all threads of the process.
+ */
+class PhaseTiming
+{
+public:
+  std::string name;
+  double wallTimeInMS;
+  double cpuTimeInMS;
+};
+
+/*
+ * Number of trained data points and training throughput of one epoch.
+ */
+class EpochThroughput
+{
+public:
+  uint32_t epoch;
+  uint64_t numberOfSamples;
+  double samplesPerSecond;
+};
+
+class TelemetryReport
+{
+public:
+  double totalWallTimeInMS;
+  double totalCpuTimeInMS;
+  uint64_t peakResidentSetBytes;
+  uint64_t datasetBytes;
+  std::vector<PhaseTiming> phases;
+  std::vector<EpochThroughput> epochs;
+};
+
+/*
+ * Records the wall and CPU time of the phases of the program, the training throughput of every epoch and the size of the data.
+ * Every record only reads the clocks, so the telemetry can always be active.
+ */
+class Telemetry
+{
+public:
+  Telemetry();
+
+public:
+  /*
+   * Starts a new phase with the given name. A running phase is ended first.
+   */
+  void startPhase(std::string const& name);
+  /*
+   * Ends the running phase (if there is one).
+   */
+  void endPhase();
+  /*
+   * Records the number of trained data points and the training duration of the given epoch.
+   */
+  void recordEpoch(uint32_t epoch, uint64_t numberOfSamples, std::chrono::steady_clock::duration duration);
+  /*
+   * Records the number of bytes of the tensor data of the given data.
+   */
+  void recordDatasetBytes(DataVector const& data);
+  /*
+   * Returns all recorded values together with the peak resident set size of the process.
+   */
+  [[nodiscard]]
+  TelemetryReport createReport() const;
+
+private:
+  struct RunningPhase
+  {
+    std::string name;
+    std::chrono::steady_clock::time_point wallStart;
+    std::clock_t cpuStart;
+  };
+
+  std::chrono::steady_clock::time_point wallStart;
+  std::clock_t cpuStart;
+  std::optional<RunningPhase> runningPhase {};
+  uint64_t datasetBytes = 0;
+  std::vector<PhaseTiming> phases {};
+  std::vector<EpochThroughput> epochs {};
+};
+
+}
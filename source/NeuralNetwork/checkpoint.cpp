@@ -0,0 +1,244 @@
+#include "NeuralNetwork/checkpoint.h"
+
+#include <filesystem>
+#include <iostream>
+
+namespace NeuralNetwork {
+
+namespace {
+
+const std::string CHECKPOINT_FILE_NAME = "checkpoint.pt";
+const std::string TEMPORARY_FILE_SUFFIX = ".tmp";
+
+const std::string NETWORK_KEY = "network";
+const std::string OPTIMIZER_KEY = "optimizer";
+const std::string PRECISION_KEY = "precision";
+const std::string BEST_NETWORK_STATE_KEY = "bestNetworkState";
+
+std::filesystem::path checkpointPath(FilePath const& directory)
+{
+  return std::filesystem::path(directory) / CHECKPOINT_FILE_NAME;
+}
+
+void writeDouble(torch::serialize::OutputArchive& archive, std::string const& key, double value)
+{
+  archive.write(key, torch::tensor(value, torch::kDouble));
+}
+
+void writeInteger(torch::serialize::OutputArchive& archive, std::string const& key, int64_t value)
+{
+  archive.write(key, torch::tensor(value, torch::kLong));
+}
+
+double readDouble(torch::serialize::InputArchive& archive, std::string const& key)
+{
+  torch::Tensor tensor{};
+  archive.read(key, tensor);
+  return tensor.item<double>();
+}
+
+int64_t readInteger(torch::serialize::InputArchive& archive, std::string const& key)
+{
+  torch::Tensor tensor{};
+  archive.read(key, tensor);
+  return tensor.item<int64_t>();
+}
+
+template<typename T>
+std::vector<T> readVector(torch::serialize::InputArchive& archive, std::string const& key, torch::ScalarType dataType)
+{
+  torch::Tensor tensor{};
+  archive.read(key, tensor);
+  tensor = tensor.to(dataType).contiguous();
+  return std::vector<T>(tensor.data_ptr<T>(), tensor.data_ptr<T>() + tensor.numel());
+}
+
+void writeProgress(torch::serialize::OutputArchive& archive, ProgressVector const& progress)
+{
+  auto const numberOfEntries = static_cast<int64_t>(progress.size());
+  auto const numberOfScores = progress.empty() ? int64_t{0} : static_cast<int64_t>(progress.front().r2Score.size());
+
+  std::vector<int64_t> epochs{};
+  std::vector<int64_t> elapsedTimes{};
+  std::vector<double> meanSquaredErrors{};
+  std::vector<double> learnRates{};
+  std::vector<double> r2Scores{};
+
+  for (auto const& entry : progress) {
+    epochs.push_back(entry.epoch);
+    elapsedTimes.push_back(static_cast<int64_t>(entry.elapsedTimeInMS));
+    meanSquaredErrors.push_back(entry.meanSquaredError);
+    learnRates.push_back(entry.learnRate);
+    r2Scores.insert(r2Scores.end(), entry.r2Score.begin(), entry.r2Score.end());
+  }
+
+  archive.write("progressEpoch", torch::tensor(epochs, torch::kLong));
+  archive.write("progressElapsedTime", torch::tensor(elapsedTimes, torch::kLong));
+  archive.write("progressMeanSquaredError", torch::tensor(meanSquaredErrors, torch::kDouble));
+  archive.write("progressLearnRate", torch::tensor(learnRates, torch::kDouble));
+  archive.write("progressR2Score", torch::tensor(r2Scores, torch::kDouble).view({numberOfEntries, numberOfScores}));
+}
+
+ProgressVector readProgress(torch::serialize::InputArchive& archive)
+{
+  auto epochs = readVector<int64_t>(archive, "progressEpoch", torch::kLong);
+  auto elapsedTimes = readVector<int64_t>(archive, "progressElapsedTime", torch::kLong);
+  auto meanSquaredErrors = readVector<double>(archive, "progressMeanSquaredError", torch::kDouble);
+  auto learnRates = readVector<double>(archive, "progressLearnRate", torch::kDouble);
+  auto r2Scores = readVector<double>(archive, "progressR2Score", torch::kDouble);
+
+  auto const numberOfScores = epochs.empty() ? size_t{0} : r2Scores.size() / epochs.size();
+
+  ProgressVector progress{};
+  for (size_t i = 0; i < epochs.size(); ++i) {
+    auto firstScore = r2Scores.begin() + static_cast<std::ptrdiff_t>(i * numberOfScores);
+    progress.emplace_back(LearnProgressDataSet{
+      static_cast<uint32_t>(epochs[i]),
+      std::vector<double>(firstScore, firstScore + static_cast<std::ptrdiff_t>(numberOfScores)),
+      meanSquaredErrors[i],
+      static_cast<uint64_t>(elapsedTimes[i]),
+      learnRates[i]
+    });
+  }
+
+  return progress;
+}
+
+}
+
+bool saveCheckpoint(FilePath const& directory, Network const& network, torch::optim::Optimizer const& optimizer, TrainingState const& state)
+{
+  auto const path = checkpointPath(directory);
+  auto temporaryPath = path;
+  temporaryPath += TEMPORARY_FILE_SUFFIX;
+
+  try {
+    std::filesystem::create_directories(directory);
+
+    torch::serialize::OutputArchive networkArchive;
+    network->save(networkArchive);
+    torch::serialize::OutputArchive optimizerArchive;
+    optimizer.save(optimizerArchive);
+
+    torch::serialize::OutputArchive archive;
+    archive.write(NETWORK_KEY, networkArchive);
+    archive.write(OPTIMIZER_KEY, optimizerArchive);
+    writeInteger(archive, PRECISION_KEY, static_cast<int64_t>(network->parameters().front().scalar_type()));
+
+    writeInteger(archive, "epoch", state.epoch);
+    writeInteger(archive, "elapsedTime", static_cast<int64_t>(state.elapsedTimeInMS));
+    writeInteger(archive, "numberOfDataPoints", static_cast<int64_t>(state.numberOfDataPoints));
+    writeInteger(archive, "splitSeed", static_cast<int64_t>(state.splitSeed));
+    writeInteger(archive, "shuffleSeed", static_cast<int64_t>(state.shuffleSeed));
+    writeDouble(archive, "currentMeanError", state.currentMeanError);
+    writeDouble(archive, "trainingPassMeanError", state.trainingPassMeanError);
+    writeDouble(archive, "exactMeanError", state.exactMeanError);
+    writeInteger(archive, "continueTraining", state.continueTraining ? 1 : 0);
+    writeInteger(archive, "numberOfDeteriorationsInRow", state.numberOfDeteriorationsInRow);
+    writeDouble(archive, "learnRate", state.learnRate);
+    archive.write("schedulerState", torch::tensor(state.schedulerState, torch::kDouble));
+    writeDouble(archive, "bestValidationError", state.bestValidationError);
+    writeInteger(archive, "bestValidationEpoch", state.bestValidationEpoch);
+    writeInteger(archive, "numberOfValidationsWithoutImprovement", state.numberOfValidationsWithoutImprovement);
+
+    writeInteger(archive, BEST_NETWORK_STATE_KEY + "Size", static_cast<int64_t>(state.bestNetworkState.size()));
+    for (size_t i = 0; i < state.bestNetworkState.size(); ++i) {
+      archive.write(BEST_NETWORK_STATE_KEY + std::to_string(i), state.bestNetworkState[i]);
+    }
+
+    auto const& generatorState = state.randomGeneratorState;
+    archive.write("randomGeneratorState", torch::tensor(std::vector<uint8_t>(generatorState.begin(), generatorState.end()), torch::kByte));
+
+    writeProgress(archive, state.progress);
+
+    archive.save_to(temporaryPath.string());
+    std::filesystem::rename(temporaryPath, path);
+  } catch (std::exception const& e) {
+    std::cout << "\n[Warning] Could not save the checkpoint to " << path.string() << ". Reason: " << e.what() << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+std::optional<TrainingState> loadTrainingState(FilePath const& directory)
+{
+  auto const path = checkpointPath(directory);
+
+  if (!std::filesystem::exists(path)) {
+    std::cout << "Error: There is no checkpoint in " << directory << std::endl;
+    return std::nullopt;
+  }
+
+  try {
+    torch::serialize::InputArchive archive;
+    archive.load_from(path.string());
+
+    TrainingState state{};
+    state.epoch = static_cast<uint32_t>(readInteger(archive, "epoch"));
+    state.elapsedTimeInMS = static_cast<uint64_t>(readInteger(archive, "elapsedTime"));
+    state.numberOfDataPoints = static_cast<uint64_t>(readInteger(archive, "numberOfDataPoints"));
+    state.splitSeed = static_cast<uint64_t>(readInteger(archive, "splitSeed"));
+    state.shuffleSeed = static_cast<uint64_t>(readInteger(archive, "shuffleSeed"));
+    state.currentMeanError = readDouble(archive, "currentMeanError");
+    state.trainingPassMeanError = readDouble(archive, "trainingPassMeanError");
+    state.exactMeanError = readDouble(archive, "exactMeanError");
+    state.continueTraining = readInteger(archive, "continueTraining") != 0;
+    state.numberOfDeteriorationsInRow = static_cast<uint32_t>(readInteger(archive, "numberOfDeteriorationsInRow"));
+    state.learnRate = readDouble(archive, "learnRate");
+    state.schedulerState = readVector<double>(archive, "schedulerState", torch::kDouble);
+    state.bestValidationError = readDouble(archive, "bestValidationError");
+    state.bestValidationEpoch = static_cast<uint32_t>(readInteger(archive, "bestValidationEpoch"));
+    state.numberOfValidationsWithoutImprovement = static_cast<uint32_t>(readInteger(archive, "numberOfValidationsWithoutImprovement"));
+
+    auto const bestNetworkStateSize = readInteger(archive, BEST_NETWORK_STATE_KEY + "Size");
+    for (int64_t i = 0; i < bestNetworkStateSize; ++i) {
+      torch::Tensor tensor{};
+      archive.read(BEST_NETWORK_STATE_KEY + std::to_string(i), tensor);
+      state.bestNetworkState.push_back(tensor);
+    }
+
+    auto generatorState = readVector<uint8_t>(archive, "randomGeneratorState", torch::kByte);
+    state.randomGeneratorState = std::string(generatorState.begin(), generatorState.end());
+
+    state.progress = readProgress(archive);
+
+    return state;
+  } catch (std::exception const& e) {
+    std::cout << "Error: Could not load the checkpoint " << path.string() << ". Reason: " << e.what() << std::endl;
+    return std::nullopt;
+  }
+}
+
+bool loadCheckpointParameters(FilePath const& directory, Network& network, torch::optim::Optimizer& optimizer)
+{
+  auto const path = checkpointPath(directory);
+
+  try {
+    torch::serialize::InputArchive archive;
+    archive.load_from(path.string());
+
+    auto const savedDataType = static_cast<torch::ScalarType>(readInteger(archive, PRECISION_KEY));
+    auto const currentDataType = network->parameters().front().scalar_type();
+    if (savedDataType != currentDataType) {
+      std::cout << "Error: The checkpoint was trained with " << c10::toString(savedDataType) << " precision, but the current precision is " <<
+                   c10::toString(currentDataType) << "." << std::endl;
+      return false;
+    }
+
+    torch::serialize::InputArchive networkArchive;
+    archive.read(NETWORK_KEY, networkArchive);
+    network->load(networkArchive);
+
+    torch::serialize::InputArchive optimizerArchive;
+    archive.read(OPTIMIZER_KEY, optimizerArchive);
+    optimizer.load(optimizerArchive);
+  } catch (std::exception const& e) {
+    std::cout << "Error: Could not load the parameters of the checkpoint " << path.string() << ". Reason: " << e.what() << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+}
@@ -0,0 +1,185 @@
+#include "NeuralNetwork/crossvalidation.h"
+#include "Utilities/dataprocessor.h"
+#include "Utilities/datasplitter.h"
+#include "Utilities/fileparser.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <thread>
+
+namespace NeuralNetwork {
+
+namespace {
+
+/*
+ * Returns the mean and the (sample) standard deviation of the given values.
+ */
+[[nodiscard]]
+std::pair<double, double> calculateMeanAndStandardDeviation(std::vector<double> const& values)
+{
+  auto const mean = std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+
+  double squaredDeviationSum = 0.0;
+  for (auto value : values) {
+    squaredDeviationSum += (value - mean) * (value - mean);
+  }
+
+  return std::make_pair(mean, (values.size() > 1) ? std::sqrt(squaredDeviationSum / (values.size() - 1)) : 0.0);
+}
+
+void outputMeanAndStandardDeviation(std::string const& name, std::vector<double> const& values)
+{
+  auto [mean, standardDeviation] = calculateMeanAndStandardDeviation(values);
+  std::cout << name << ": " << mean << " (standard deviation: " << standardDeviation << ")" << std::endl;
+}
+
+}
+
+bool CrossValidation::performCrossValidation(Utilities::ProgramOptions const& user_options)
+{
+  options = user_options;
+  auto const numberOfFolds = options.NumberOfFolds.value();
+
+  if (options.DebugOutput) {
+    std::cout << "Read input file..." << std::endl;
+  }
+  std::string inputFileHeader{};
+  Utilities::DataStatistics statistics{};
+  auto dataOpt = Utilities::FileParser::LoadInputData(options, inputFileHeader, statistics);
+  if (!dataOpt) {
+    return false;
+  }
+
+  if (dataOpt->size() < numberOfFolds) {
+    std::cout << "Error: The input file contains " << dataOpt->size() << " data points, which is not enough for " << numberOfFolds << " folds." << std::endl;
+    return false;
+  }
+
+  torch::set_num_threads(options.NumberOfThreads);
+
+  Logic preparer{};
+  if (!preparer.prepareData(options, *dataOpt, statistics)) {
+    return false;
+  }
+
+  auto const seed = options.RNGSeed.value_or(std::random_device{}());
+  auto const foldAssignment = Utilities::DataSplitter::assignFolds(dataOpt->size(), numberOfFolds, seed);
+
+  // The folds are trained concurrently and quietly, every fold trains in a single worker:
+  auto foldOptions = options;
+  foldOptions.ShowProgressDuringTraining = false;
+  foldOptions.DebugOutput = false;
+  foldOptions.ValidateAfterTraining = true;
+  foldOptions.DataParallelWorkers = 1;
+  foldOptions.SaveProgressFilePath = Utilities::DefaultValues::PROGRESS_FILE_PATH;
+
+  if (options.DebugOutput) {
+    std::cout << "Prepare " << numberOfFolds << " folds..." << std::endl;
+  }
+
+  // The data is stacked only once, every fold trains its rows of the shared tensors:
+  std::optional<SharedTrainingData> sharedData{};
+  if (Logic::trainsOnStackedData(foldOptions)) {
+    sharedData = SharedTrainingData{};
+    std::tie(sharedData->inputs, sharedData->outputs) = Utilities::DataProcessor::StackData(*dataOpt);
+  }
+
+  std::vector<std::unique_ptr<Logic>> foldLogics{};
+  for (uint32_t fold = 0; fold < numberOfFolds; ++fold) {
+    if (sharedData) {
+      sharedData->trainingRows = Utilities::DataSplitter::trainingRowsOfFold(foldAssignment, fold);
+    }
+
+    auto logic = std::make_unique<Logic>();
+    logic->adoptDataPreparation(preparer);
+    if (!logic->prepareTraining(foldOptions, *dataOpt, Utilities::DataSplitter::splitDataByFold(*dataOpt, foldAssignment, fold), sharedData)) {
+      return false;
+    }
+    foldLogics.push_back(std::move(logic));
+  }
+
+  if (options.ShowProgressDuringTraining) {
+    std::cout << "Train " << numberOfFolds << " networks..." << std::endl;
+  }
+
+  // At most one fold per thread is trained at the same time, the other folds wait for the next free fold thread.
+  // The running folds share the intra-op threads, so every fold gets its part of them:
+  auto const numberOfConcurrentFolds = std::min<uint32_t>(numberOfFolds, static_cast<uint32_t>(std::max(1, options.NumberOfThreads)));
+  torch::set_num_threads(std::max(1, options.NumberOfThreads / static_cast<int32_t>(numberOfConcurrentFolds)));
+
+  std::vector<std::pair<NetworkMetrics, NetworkMetrics>> foldMetrics(numberOfFolds);
+  std::vector<uint32_t> foldEpochs(numberOfFolds);
+  std::atomic<uint32_t> nextFold{0};
+
+  auto trainFolds = [&]() {
+    for (auto fold = nextFold++; fold < numberOfFolds; fold = nextFold++) {
+      auto& logic = *foldLogics[fold];
+      logic.train(options.NumberOfEpochs, true);
+      logic.finishTraining();
+
+      foldMetrics[fold] = std::make_pair(logic.calculateTrainingMetrics(), logic.calculateValidationMetrics());
+      foldEpochs[fold] = logic.numberOfTrainedEpochs();
+      foldLogics[fold].reset();
+    }
+  };
+
+  std::vector<std::thread> threads{};
+  for (uint32_t thread = 1; thread < numberOfConcurrentFolds; ++thread) {
+    threads.emplace_back(trainFolds);
+  }
+
+  trainFolds();
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  torch::set_num_threads(options.NumberOfThreads);
+
+  outputResults(foldMetrics, foldEpochs);
+
+  return true;
+}
+
+void CrossValidation::outputResults(std::vector<std::pair<NetworkMetrics, NetworkMetrics>> const& foldMetrics, std::vector<uint32_t> const& foldEpochs) const
+{
+  std::cout << "\nCross-validation results:" << std::endl;
+  for (size_t fold = 0; fold < foldMetrics.size(); ++fold) {
+    auto const& [trainingMetrics, validationMetrics] = foldMetrics[fold];
+    std::cout << "Fold " << fold + 1 << " of " << foldMetrics.size() << " -- epochs: " << foldEpochs[fold] << ", mean squared error (training): " <<
+                 trainingMetrics.meanSquaredError << ", mean squared error (validation): " << validationMetrics.meanSquaredError << std::endl;
+  }
+
+  std::cout << "\nMean over " << foldMetrics.size() << " folds:" << std::endl;
+
+  std::vector<double> epochs(foldEpochs.begin(), foldEpochs.end());
+  outputMeanAndStandardDeviation("Epochs", epochs);
+
+  auto outputMetric = [&](std::string const& name, auto const& getValue) {
+    std::vector<double> values{};
+    for (auto const& metrics : foldMetrics) {
+      values.push_back(getValue(metrics));
+    }
+    outputMeanAndStandardDeviation(name, values);
+  };
+
+  outputMetric("Mean squared error (training)", [](auto const& metrics) { return metrics.first.meanSquaredError; });
+  outputMetric("Mean squared error (validation)", [](auto const& metrics) { return metrics.second.meanSquaredError; });
+
+  for (uint32_t output = 0; output < options.NumberOfOutputVariables; ++output) {
+    auto const outputName = " of output " + std::to_string(output + 1);
+
+    outputMetric("R2 score (training)" + outputName, [output](auto const& metrics) { return metrics.first.r2Score[output]; });
+    outputMetric("R2 score (validation)" + outputName, [output](auto const& metrics) { return metrics.second.r2Score[output]; });
+    outputMetric("R2 score alternate (training)" + outputName, [output](auto const& metrics) { return metrics.first.r2ScoreAlternate[output]; });
+    outputMetric("R2 score alternate (validation)" + outputName, [output](auto const& metrics) { return metrics.second.r2ScoreAlternate[output]; });
+    outputMetric("R2 score alternate denormalized (training)" + outputName, [output](auto const& metrics) { return metrics.first.r2ScoreAlternateDenormalized[output]; });
+    outputMetric("R2 score alternate denormalized (validation)" + outputName, [output](auto const& metrics) { return metrics.second.r2ScoreAlternateDenormalized[output]; });
+  }
+}
+
+}
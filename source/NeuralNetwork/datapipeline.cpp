@@ -0,0 +1,100 @@
+#include "NeuralNetwork/datapipeline.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace NeuralNetwork {
+
+namespace {
+
+const uint32_t NUMBER_OF_YIELDS_BEFORE_SLEEP = 64;
+const auto WAIT_SLEEP_DURATION = std::chrono::microseconds(50);
+
+/*
+ * Waits for the other thread. Yields first, so a short wait is not delayed by the scheduler, and sleeps after that,
+ * so a long wait (e.g. a full queue while the network trains) does not take CPU time from the training.
+ */
+void waitForOtherThread(uint32_t& numberOfWaits)
+{
+  if (numberOfWaits++ < NUMBER_OF_YIELDS_BEFORE_SLEEP) {
+    std::this_thread::yield();
+  } else {
+    std::this_thread::sleep_for(WAIT_SLEEP_DURATION);
+  }
+}
+
+}
+
+std::mt19937_64 epochGenerator(uint64_t const seed, uint32_t const epoch, uint32_t const stream)
+{
+  std::seed_seq seedSequence{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32u), epoch, stream};
+  return std::mt19937_64(seedSequence);
+}
+
+torch::Tensor epochPermutation(torch::Tensor const& rows, uint64_t const seed, uint32_t const epoch, uint32_t const stream)
+{
+  auto permutation = rows.contiguous().clone();
+  auto* data = permutation.data_ptr<int64_t>();
+  auto generator = epochGenerator(seed, epoch, stream);
+  std::shuffle(data, data + permutation.numel(), generator);
+
+  return permutation;
+}
+
+DataPipeline::DataPipeline(torch::Tensor const& inputs, torch::Tensor const& outputs, torch::Tensor const& trainingRows, int64_t const batchSize,
+                           size_t const capacity, uint64_t const seed, uint32_t const firstEpoch) :
+  inputs(inputs), outputs(outputs), trainingRows(trainingRows.defined() ? trainingRows : torch::arange(inputs.size(0), torch::kLong)), batchSize(batchSize),
+  seed(seed), firstEpoch(firstEpoch), queue(capacity)
+{
+  producer = std::thread(&DataPipeline::produce, this);
+}
+
+DataPipeline::~DataPipeline()
+{
+  stopped = true;
+  producer.join();
+}
+
+std::optional<std::pair<torch::Tensor, torch::Tensor>> DataPipeline::next()
+{
+  uint32_t numberOfWaits = 0;
+
+  while (true) {
+    auto batch = queue.tryPop();
+    if (batch) {
+      if (!batch->first.defined()) {
+        return std::nullopt;
+      }
+      return batch;
+    }
+    waitForOtherThread(numberOfWaits);
+  }
+}
+
+void DataPipeline::produce()
+{
+  auto const numberOfSamples = trainingRows.size(0);
+  auto const numberOfBatches = (numberOfSamples + batchSize - 1) / batchSize;
+
+  for (auto epoch = firstEpoch; !stopped; ++epoch) {
+    auto indices = epochPermutation(trainingRows, seed, epoch);
+
+    // One additional (empty) batch marks the end of the epoch:
+    for (int64_t batchNumber = 0; batchNumber <= numberOfBatches && !stopped; ++batchNumber) {
+      std::pair<torch::Tensor, torch::Tensor> batch{};
+
+      if (batchNumber < numberOfBatches) {
+        auto const first = batchNumber * batchSize;
+        auto batchIndices = indices.narrow(0, first, std::min(batchSize, numberOfSamples - first));
+        batch = std::make_pair(inputs.index_select(0, batchIndices), outputs.index_select(0, batchIndices));
+      }
+
+      uint32_t numberOfWaits = 0;
+      while (!queue.tryPush(batch) && !stopped) {
+        waitForOtherThread(numberOfWaits);
+      }
+    }
+  }
+}
+
+}
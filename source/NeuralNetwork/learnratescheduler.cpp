@@ -0,0 +1,96 @@
+#include "NeuralNetwork/learnratescheduler.h"
+
+#include <cmath>
+
+namespace NeuralNetwork {
+
+namespace {
+
+const double PLATEAU_RELATIVE_THRESHOLD = 1e-4;
+constexpr double PI = 3.14159265358979323846;
+
+}
+
+LearnRateScheduler::LearnRateScheduler(Utilities::ProgramOptions const& options) :
+  schedule(options.LearnRateSchedule), baseLearnRate(options.LearnRate), minLearnRate(options.MinLearnRate), gamma(options.LearnRateGamma),
+  warmupEpochs(options.WarmupEpochs), stepSize(options.LearnRateStepSize), patience(options.LearnRatePatience), numberOfEpochs(options.NumberOfEpochs),
+  plateauLearnRate(options.LearnRate)
+{
+}
+
+double LearnRateScheduler::learnRateForEpoch(uint32_t const epoch, std::optional<double> const meanSquaredError)
+{
+  if (epoch <= warmupEpochs) {
+    return baseLearnRate * epoch / warmupEpochs;
+  }
+
+  // Number of epochs since the end of the warmup, starting with 0:
+  auto const scheduledEpoch = epoch - warmupEpochs - 1;
+
+  switch (schedule) {
+    case Utilities::LearnRateScheduleType::Step:
+      return baseLearnRate * std::pow(gamma, scheduledEpoch / stepSize);
+    case Utilities::LearnRateScheduleType::Exponential:
+      return baseLearnRate * std::pow(gamma, scheduledEpoch);
+    case Utilities::LearnRateScheduleType::Cosine: {
+      // Anneals over the remaining minimum number of epochs and keeps the minimum learning rate afterwards:
+      auto const period = std::max(numberOfEpochs, warmupEpochs + 1) - warmupEpochs;
+      auto const progress = std::min(static_cast<double>(scheduledEpoch) / period, 1.0);
+      return minLearnRate + (baseLearnRate - minLearnRate) * (1.0 + std::cos(PI * progress)) / 2.0;
+    }
+    case Utilities::LearnRateScheduleType::Plateau:
+      if (!meanSquaredError) {
+        return plateauLearnRate;
+      }
+      if (*meanSquaredError < bestMeanSquaredError * (1.0 - PLATEAU_RELATIVE_THRESHOLD)) {
+        bestMeanSquaredError = *meanSquaredError;
+        evaluationsWithoutImprovement = 0;
+      } else if (++evaluationsWithoutImprovement > patience) {
+        plateauLearnRate = std::max(minLearnRate, plateauLearnRate * gamma);
+        evaluationsWithoutImprovement = 0;
+      }
+      return plateauLearnRate;
+    case Utilities::LearnRateScheduleType::Constant:
+      break;
+  }
+
+  return baseLearnRate;
+}
+
+bool LearnRateScheduler::isActive() const
+{
+  return schedule != Utilities::LearnRateScheduleType::Constant || warmupEpochs > 0;
+}
+
+std::vector<double> LearnRateScheduler::state() const
+{
+  return {plateauLearnRate, bestMeanSquaredError, static_cast<double>(evaluationsWithoutImprovement)};
+}
+
+void LearnRateScheduler::restoreState(std::vector<double> const& state)
+{
+  if (state.size() == 3) {
+    plateauLearnRate = state[0];
+    bestMeanSquaredError = state[1];
+    evaluationsWithoutImprovement = static_cast<uint32_t>(state[2]);
+  }
+}
+
+void LearnRateScheduler::applyLearnRate(torch::optim::Optimizer& optimizer, double const learnRate)
+{
+  for (auto& group : optimizer.param_groups()) {
+    auto& groupOptions = group.options();
+
+    if (auto* sgdOptions = dynamic_cast<torch::optim::SGDOptions*>(&groupOptions)) {
+      sgdOptions->lr(learnRate);
+    } else if (auto* adamOptions = dynamic_cast<torch::optim::AdamOptions*>(&groupOptions)) {
+      adamOptions->lr(learnRate);
+    } else if (auto* rmspropOptions = dynamic_cast<torch::optim::RMSpropOptions*>(&groupOptions)) {
+      rmspropOptions->lr(learnRate);
+    } else if (auto* lbfgsOptions = dynamic_cast<torch::optim::LBFGSOptions*>(&groupOptions)) {
+      lbfgsOptions->lr(learnRate);
+    }
+  }
+}
+
+}
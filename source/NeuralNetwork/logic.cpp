@@ -3,11 +3,83 @@
 #include "Utilities/datasplitter.h"
 #include "Utilities/fileparser.h"
 
+#include <algorithm>
 #include <chrono>
+#include <iterator>
 #include <random>
+#include <sstream>
+#include <utility>
 
 namespace NeuralNetwork {
 
+namespace {
+
+const uint64_t BYTES_PER_MEGABYTE = 1024 * 1024;
+
+// The chunk which is trained, its shuffled copy, the prepared chunk and the chunk which is read share the memory budget:
+const uint64_t STREAMED_CHUNKS_IN_MEMORY = 4;
+
+// Number of data points which are inferred at once for the output files:
+const size_t OUTPUT_CHUNK_SIZE = 65536;
+
+/*
+ * Extends the given min/max values with the column-wise min/max values of the given data points [rows, columns].
+ */
+void updateMinMax(torch::Tensor const& values, MinMaxVector& minMaxVector)
+{
+  if (values.size(0) == 0) {
+    return;
+  }
+
+  auto const minimum = std::get<0>(values.min(0)).to(TORCH_DATA_TYPE).contiguous();
+  auto const maximum = std::get<0>(values.max(0)).to(TORCH_DATA_TYPE).contiguous();
+  for (size_t i = 0; i < minMaxVector.size(); ++i) {
+    minMaxVector[i].first = std::min(minMaxVector[i].first, minimum.data_ptr<TensorDataType>()[i]);
+    minMaxVector[i].second = std::max(minMaxVector[i].second, maximum.data_ptr<TensorDataType>()[i]);
+  }
+}
+
+/*
+ * Prints the count, mean and standard deviation of every column of the given statistics.
+ */
+void printColumnStatistics(Utilities::DataStatistics const& statistics, std::string const& fileHeader)
+{
+  auto const columnNames = Utilities::FileParser::SplitFileHeader(fileHeader);
+  size_t column = 0;
+  for (auto const* columns : {&statistics.inputColumns(), &statistics.outputColumns()}) {
+    for (auto const& accumulator : *columns) {
+      std::cout << "Column " << ((column < columnNames.size()) ? columnNames[column] : std::to_string(column + 1)) << ": count " << accumulator.count()
+                << ", mean " << accumulator.mean() << ", standard deviation " << std::sqrt(accumulator.variance()) << std::endl;
+      ++column;
+    }
+  }
+}
+
+/*
+ * Applies the given scaling to the given min/max values of unscaled data. As all scalings are monotonic, the results are the min/max values
+ * of the scaled data.
+ */
+void scaleMinMax(MinMaxVector& minMaxVector, void (*scaling)(torch::Tensor&))
+{
+  if (minMaxVector.empty()) {
+    return;
+  }
+
+  std::vector<TensorDataType> values{};
+  for (auto const& [minimum, maximum] : minMaxVector) {
+    values.push_back(minimum);
+    values.push_back(maximum);
+  }
+
+  auto tensor = torch::tensor(values, TORCH_DATA_TYPE);
+  scaling(tensor);
+  for (size_t i = 0; i < minMaxVector.size(); ++i) {
+    minMaxVector[i] = std::make_pair(tensor[2 * i].item<TensorDataType>(), tensor[2 * i + 1].item<TensorDataType>());
+  }
+}
+
+}
+
 bool Logic::performUserRequest(Utilities::ProgramOptions const& user_options)
 {
   options = user_options;
@@ -15,41 +87,136 @@ bool Logic::performUserRequest(Utilities::ProgramOptions const& user_options)
   if (options.DebugOutput) {
     std::cout << "Read input file..." << std::endl;
   }
-  auto dataOpt = Utilities::FileParser::ParseInputFile(options.InputDataFilePath, options.NumberOfInputVariables,
-    options.NumberOfOutputVariables, inputFileHeader);
+  telemetry.startPhase("parse");
+  Utilities::DataStatistics statistics{};
+  auto dataOpt = Utilities::FileParser::LoadInputData(options, inputFileHeader, statistics);
   if (!dataOpt) {
     return false;
   }
+  if (options.DebugOutput) {
+    printColumnStatistics(statistics, inputFileHeader);
+  }
 
-  useMixedScaling = options.LogLinScaling || options.LogSqrtScaling;
   torch::set_num_threads(options.NumberOfThreads);
 
-  if (options.RNGSeed) {
-    torch::manual_seed(*options.RNGSeed);
+  if (!prepareData(options, *dataOpt, statistics)) {
+    return false;
+  }
+  telemetry.recordDatasetBytes(*dataOpt);
+
+  telemetry.startPhase("build");
+  if (!prepareTraining(options, *dataOpt)) {
+    return false;
+  }
+
+  if (options.DebugOutput) {
+    std::cout << "Start the training..." << std::endl;
+  }
+
+  telemetry.startPhase("train");
+  train(options.NumberOfEpochs, true);
+  finishTraining();
+
+  if (options.DebugOutput) {
+    std::cout << "\nTraining finished." << std::endl;
+  }
+
+  network->eval();
+
+  telemetry.startPhase("outputs");
+  if (options.OutputNetworkParameters != Utilities::DefaultValues::OUTPUT_NETWORK_PARAMETERS) {
+    saveNetwork(network, options.OutputNetworkParameters);
+  }
+
+  if (options.OutputValuesFilePath != Utilities::DefaultValues::OUTPUT_VALUE) {
+    saveValuesToFile(*dataOpt, options.OutputValuesFilePath);
+  }
+
+  if (options.OutputDiffFilePath != Utilities::DefaultValues::OUTPUT_DIFF) {
+    saveDiffToFile(*dataOpt, options.OutputDiffFilePath, false);
+  }
+
+  if (options.OutputRelativeDiffFilePath != Utilities::DefaultValues::OUTPUT_RELATIVE_DIFF) {
+    saveDiffToFile(*dataOpt, options.OutputRelativeDiffFilePath, true);
+  }
+
+  if (options.SaveProgressFilePath != Utilities::DefaultValues::PROGRESS_FILE_PATH) {
+    Utilities::FileParser::SaveProgressData(trainingProgress, options.SaveProgressFilePath, LearnRateScheduler(options).isActive());
+  }
+
+  if (options.OutputReportFilePath != Utilities::DefaultValues::OUTPUT_REPORT) {
+    saveErrorReportToFile(splitData, *dataOpt);
+  }
+
+  // Output behaviour of network:
+  telemetry.startPhase("analysis");
+  if (options.PrintBehaviour) {
+    std::cout << std::endl;
+    if (options.ValidateAfterTraining) {
+      auto trainingMetrics = analyzer->calculateMetrics(splitData.first);
+      auto validationMetrics = analyzer->calculateMetrics(splitData.second);
+      std::cout << "R2 score (training): " << trainingMetrics.r2Score << std::endl;
+      std::cout << "R2 score alternate (training): " << trainingMetrics.r2ScoreAlternate << std::endl;
+      std::cout << "R2 score alternate denormalized (training): " << trainingMetrics.r2ScoreAlternateDenormalized << std::endl;
+      std::cout << "R2 score (validation): " << validationMetrics.r2Score << std::endl;
+      std::cout << "R2 score alternate (validation): " << validationMetrics.r2ScoreAlternate << std::endl;
+      std::cout << "R2 score alternate denormalized (validation): " << validationMetrics.r2ScoreAlternateDenormalized << std::endl;
+    }
+    auto metrics = analyzer->calculateMetrics(*dataOpt);
+    std::cout << "R2 score (all): " << metrics.r2Score << std::endl;
+    std::cout << "R2 score alternate (all): " << metrics.r2ScoreAlternate << std::endl;
+    std::cout << "R2 score alternate denormalized (all): " << metrics.r2ScoreAlternateDenormalized << std::endl;
+
+    if (options.ValidateAfterTraining) {
+      std::cout << "\nTraining set:" << std::endl;
+      outputBehaviour(splitData.first);
+      std::cout << "\nValidation set:" << std::endl;
+      outputBehaviour(splitData.second);
+    } else {
+      outputBehaviour(*dataOpt);
+    }
+  }
+
+  telemetry.endPhase();
+  if (options.MetricsFilePath != Utilities::DefaultValues::METRICS_FILE_PATH) {
+    Utilities::FileParser::SaveTelemetryReport(telemetry.createReport(), options.MetricsFilePath);
+  }
+
+  if (options.InteractiveMode) {
+    performInteractiveMode();
   }
 
+  return true;
+}
+
+bool Logic::prepareData(Utilities::ProgramOptions const& user_options, DataVector& data, Utilities::DataStatistics const& statistics)
+{
+  options = user_options;
+  useMixedScaling = options.LogLinScaling || options.LogSqrtScaling;
+
   if (options.DebugOutput) {
     std::cout << "Scale the output tensors..." << std::endl;
   }
+  telemetry.startPhase("scale");
 
   if (options.LogScaling) {
-    for (auto& [inputTensor, outputTensor] : *dataOpt) {
+    for (auto& [inputTensor, outputTensor] : data) {
       (void) inputTensor;
       Utilities::DataProcessor::ScaleLogarithmic(outputTensor);
     }
   } else if (options.SqrtScaling) {
-    for (auto& [inputTensor, outputTensor] : *dataOpt) {
+    for (auto& [inputTensor, outputTensor] : data) {
       (void) inputTensor;
       Utilities::DataProcessor::ScaleSquareRoot(outputTensor);
     }
   } else if (options.LogLinScaling) {
-    for (auto& [inputTensor, outputTensor] : *dataOpt) {
+    for (auto& [inputTensor, outputTensor] : data) {
       if (inputTensor[options.MixedScalingInputVariable].item<TensorDataType>() <= options.MixedScalingThreshold) {
         Utilities::DataProcessor::ScaleLogarithmic(outputTensor);
       }
     }
   } else if (options.LogSqrtScaling) {
-    for (auto& [inputTensor, outputTensor] : *dataOpt) {
+    for (auto& [inputTensor, outputTensor] : data) {
       if (inputTensor[options.MixedScalingInputVariable].item<TensorDataType>() <= options.MixedScalingThreshold) {
         Utilities::DataProcessor::ScaleLogarithmic(outputTensor);
       } else {
@@ -61,6 +228,7 @@ bool Logic::performUserRequest(Utilities::ProgramOptions const& user_options)
   if (options.DebugOutput) {
     std::cout << "Get min/max values..." << std::endl;
   }
+  telemetry.startPhase("minMax");
 
   // Get min/max values
   bool minMaxInputtedByUser = options.InputMinMaxFilePath != Utilities::DefaultValues::INPUT_MIN_MAX_FILE_PATH;
@@ -80,11 +248,28 @@ bool Logic::performUserRequest(Utilities::ProgramOptions const& user_options)
       }
       minMax = *minMaxFromFile;
     }
+  } else if (!data.empty() && statistics.numberOfDataPoints() == data.size() && statistics.inputColumns().size() == options.NumberOfInputVariables &&
+             statistics.hasScalingThreshold(Utilities::ScalingThreshold::FromOptions(options))) {
+    // The statistics were collected while parsing the unscaled data:
+    if (useMixedScaling) {
+      mixedScalingMinMax = statistics.mixedMinMax();
+      scaleMinMax(mixedScalingMinMax.first.second, Utilities::DataProcessor::ScaleLogarithmic);
+      if (options.LogSqrtScaling) {
+        scaleMinMax(mixedScalingMinMax.second.second, Utilities::DataProcessor::ScaleSquareRoot);
+      }
+    } else {
+      minMax = statistics.minMax();
+      if (options.LogScaling) {
+        scaleMinMax(minMax.second, Utilities::DataProcessor::ScaleLogarithmic);
+      } else if (options.SqrtScaling) {
+        scaleMinMax(minMax.second, Utilities::DataProcessor::ScaleSquareRoot);
+      }
+    }
   } else {
     if (useMixedScaling) {
-      Utilities::DataProcessor::CalculateMixedMinMax(*dataOpt, options.MixedScalingInputVariable, options.MixedScalingThreshold, mixedScalingMinMax);
+      Utilities::DataProcessor::CalculateMixedMinMax(data, options.MixedScalingInputVariable, options.MixedScalingThreshold, mixedScalingMinMax);
     } else {
-      Utilities::DataProcessor::CalculateMinMax(*dataOpt, minMax);
+      Utilities::DataProcessor::CalculateMinMax(data, minMax);
     }
   }
 
@@ -100,27 +285,24 @@ bool Logic::performUserRequest(Utilities::ProgramOptions const& user_options)
   if (options.DebugOutput) {
     std::cout << "Normalize values..." << std::endl;
   }
+  telemetry.startPhase("normalize");
 
-  // Normalize
-  if (useMixedScaling) {
-    for (auto& [inputTensor, outputTensor] : *dataOpt) {
-      if (inputTensor[options.MixedScalingInputVariable].item<TensorDataType>() <= options.MixedScalingThreshold) {
-        Utilities::DataProcessor::Normalize(outputTensor, mixedScalingMinMax.first.second, -1.0, 0.0); // TODO check if overlap is a problem
-      } else {
-        Utilities::DataProcessor::Normalize(outputTensor, mixedScalingMinMax.second.second, 0.0, 1.0);
-      }
-      Utilities::DataProcessor::Normalize(inputTensor, mixedScalingMinMax.first.first, 0.0, 1.0);
-    }
+  // Normalize, all data points at once if they are rows of the parsed tensors:
+  createNormalizers();
+  if (auto batch = Utilities::DataProcessor::BatchView(data)) {
+    normalizeData(batch->first, batch->second);
   } else {
-    Utilities::DataProcessor::Normalize(*dataOpt, minMax, 0.0, 1.0);  // TODO let user control normalization
+    for (auto& [inputTensor, outputTensor] : data) {
+      normalizeData(inputTensor, outputTensor);
+    }
   }
 
   // Calculate denormalized mixed scaling threshold value:
   if (useMixedScaling) {
-    auto tempInputTensor = dataOpt->front().first.clone();
+    auto tempInputTensor = data.front().first.clone();
     tempInputTensor[options.MixedScalingInputVariable] = options.MixedScalingThreshold;
 
-    Utilities::DataProcessor::Normalize(tempInputTensor, mixedScalingMinMax.first.first, 0.0, 1.0);
+    inputNormalizer.normalize(tempInputTensor);
     normalizedMixedScalingThreshold = tempInputTensor[options.MixedScalingInputVariable].item<TensorDataType>();
   }
 
@@ -128,51 +310,46 @@ bool Logic::performUserRequest(Utilities::ProgramOptions const& user_options)
     saveMinMaxToFile();
   }
 
-  if (options.DebugOutput) {
-    std::cout << "Configure network..." << std::endl;
+  // The normalization is calculated in double precision, the training and inference use the precision the user selected:
+  if (options.Precision != TORCH_DATA_TYPE) {
+    Utilities::DataProcessor::ConvertDataType(data, options.Precision);
   }
+  telemetry.endPhase();
 
-  auto networkConfiguration = std::vector<uint32_t>();
-  for (uint32_t i = 0; i < options.NumberOfLayers; ++i) {
-    networkConfiguration.push_back(options.NumberOfNodesPerLayer);
-  }
+  return true;
+}
 
-  network = Network{options.NumberOfInputVariables, options.NumberOfOutputVariables, networkConfiguration};
-  analyzer = std::make_unique<NetworkAnalyzer>(network, [this](auto inTensor, auto outTensor, auto limitValues) {
-    denormalizeOutputTensor(inTensor, outTensor, limitValues);
-  }, [this](auto inTensor, auto outTensor) {
-    unscaleOutputTensor(inTensor, outTensor);
-  });
+bool Logic::performStreamingRequest(Utilities::ProgramOptions const& user_options)
+{
+  options = user_options;
+  torch::set_num_threads(options.NumberOfThreads);
 
-  // Load pre-trained weights:
-  if (options.InputNetworkParameters != Utilities::DefaultValues::INPUT_NETWORK_PARAMETERS) {
-    torch::load(network, options.InputNetworkParameters);
+  if (options.DebugOutput) {
+    std::cout << "Open input file..." << std::endl;
   }
-
-  std::pair<DataVector, DataVector> data;
-
-  if (options.ValidateAfterTraining) {
-    data = Utilities::DataSplitter::splitDataRandomly(*dataOpt, 100.0 - options.ValidationPercentage);
-  } else {
-    data = std::make_pair(*dataOpt, DataVector());
+  telemetry.startPhase("parse");
+  stream = std::make_unique<Utilities::DataStream>(options, options.MemoryBudgetInMB.value() * BYTES_PER_MEGABYTE / STREAMED_CHUNKS_IN_MEMORY);
+  if (!stream->isOpen()) {
+    return false;
   }
+  inputFileHeader = stream->fileHeader();
 
-  if (options.BatchVariable.has_value()) {
-    useBatchTraining = true;
-
-    batchedTrainingData = Utilities::DataSplitter::splitDataIntoBatches(data.first, options.BatchVariable.value());
+  if (!prepareStreamingData()) {
+    return false;
+  }
 
-    if (options.DebugOutput) {
-      std::cout << "Split training data (" << data.first.size() << " data points) into " << batchedTrainingData.size() << " batches." << std::endl;
-      std::cout << "Size of first batch: " << batchedTrainingData.begin()->second.size() << std::endl;
-    }
+  telemetry.startPhase("build");
+  if (!prepareTraining(options, DataVector())) {
+    return false;
   }
 
   if (options.DebugOutput) {
     std::cout << "Start the training..." << std::endl;
   }
 
-  trainNetwork(data.first);
+  telemetry.startPhase("train");
+  train(options.NumberOfEpochs, true);
+  finishTraining();
 
   if (options.DebugOutput) {
     std::cout << "\nTraining finished." << std::endl;
@@ -180,108 +357,340 @@ bool Logic::performUserRequest(Utilities::ProgramOptions const& user_options)
 
   network->eval();
 
+  telemetry.startPhase("outputs");
   if (options.OutputNetworkParameters != Utilities::DefaultValues::OUTPUT_NETWORK_PARAMETERS) {
-    torch::save(network, options.OutputNetworkParameters);
+    saveNetwork(network, options.OutputNetworkParameters);
   }
 
-  if (options.OutputValuesFilePath != Utilities::DefaultValues::OUTPUT_VALUE) {
-    saveValuesToFile(*dataOpt, options.OutputValuesFilePath);
+  telemetry.endPhase();
+  if (options.MetricsFilePath != Utilities::DefaultValues::METRICS_FILE_PATH) {
+    Utilities::FileParser::SaveTelemetryReport(telemetry.createReport(), options.MetricsFilePath);
   }
 
-  if (options.OutputDiffFilePath != Utilities::DefaultValues::OUTPUT_DIFF) {
-    saveDiffToFile(*dataOpt, options.OutputDiffFilePath, false);
-  }
+  return true;
+}
 
-  if (options.OutputRelativeDiffFilePath != Utilities::DefaultValues::OUTPUT_RELATIVE_DIFF) {
-    saveDiffToFile(*dataOpt, options.OutputRelativeDiffFilePath, true);
+bool Logic::prepareStreamingData()
+{
+  useMixedScaling = false;
+
+  auto scaleOutputs = [this](torch::Tensor& outputs) {
+    if (options.LogScaling) {
+      Utilities::DataProcessor::ScaleLogarithmic(outputs);
+    } else if (options.SqrtScaling) {
+      Utilities::DataProcessor::ScaleSquareRoot(outputs);
+    }
+  };
+
+  if (options.DebugOutput) {
+    std::cout << "Get min/max values..." << std::endl;
   }
+  telemetry.startPhase("minMax");
 
-  if (options.SaveProgressFilePath != Utilities::DefaultValues::PROGRESS_FILE_PATH) {
-    Utilities::FileParser::SaveProgressData(trainingProgress, options.SaveProgressFilePath);
+  // The min/max values of the dataset cache are only valid for unscaled data:
+  bool minMaxInputtedByUser = options.InputMinMaxFilePath != Utilities::DefaultValues::INPUT_MIN_MAX_FILE_PATH;
+  bool useCachedMinMax = !minMaxInputtedByUser && stream->cachedMinMax() && !options.LogScaling && !options.SqrtScaling;
+  if (minMaxInputtedByUser) {
+    auto minMaxFromFile = Utilities::DataProcessor::GetMinMaxFromFile(options.InputMinMaxFilePath,
+                                                                      options.NumberOfInputVariables, options.NumberOfOutputVariables);
+    if (!minMaxFromFile) {
+      return false;
+    }
+    minMax = *minMaxFromFile;
+  } else if (useCachedMinMax) {
+    minMax = *stream->cachedMinMax();
   }
 
-  // Output behaviour of network:
-  if (options.PrintBehaviour) {
-    std::cout << std::endl;
-    if (options.ValidateAfterTraining) {
-      std::cout << "R2 score (training): " << analyzer->calculateR2Score(data.first) << std::endl;
-      std::cout << "R2 score alternate (training): " << analyzer->calculateR2ScoreAlternate(data.first) << std::endl;
-      std::cout << "R2 score alternate denormalized (training): " << analyzer->calculateR2ScoreAlternateDenormalized(data.first) << std::endl;
-      std::cout << "R2 score (validation): " << analyzer->calculateR2Score(data.second) << std::endl;
-      std::cout << "R2 score alternate (validation): " << analyzer->calculateR2ScoreAlternate(data.second) << std::endl;
-      std::cout << "R2 score alternate denormalized (validation): " << analyzer->calculateR2ScoreAlternateDenormalized(data.second) << std::endl;
+  // First pass over the data, which calculates the min/max values of the scaled data and counts the data points:
+  if ((!minMaxInputtedByUser && !useCachedMinMax) || !stream->numberOfDataPoints()) {
+    MinMaxValues passMinMax = std::make_pair(
+      MinMaxVector(options.NumberOfInputVariables, std::make_pair(std::numeric_limits<TensorDataType>::max(), std::numeric_limits<TensorDataType>::lowest())),
+      MinMaxVector(options.NumberOfOutputVariables, std::make_pair(std::numeric_limits<TensorDataType>::max(), std::numeric_limits<TensorDataType>::lowest()))
+    );
+
+    stream->setPreparation([scaleOutputs](torch::Tensor&, torch::Tensor& outputs) { scaleOutputs(outputs); });
+    stream->start();
+    while (auto chunk = stream->next()) {
+      updateMinMax(chunk->first, passMinMax.first);
+      updateMinMax(chunk->second, passMinMax.second);
+    }
+    if (stream->failed()) {
+      return false;
     }
-    std::cout << "R2 score (all): " << analyzer->calculateR2Score(*dataOpt) << std::endl;
-    std::cout << "R2 score alternate (all): " << analyzer->calculateR2ScoreAlternate(*dataOpt) << std::endl;
-    std::cout << "R2 score alternate denormalized (all): " << analyzer->calculateR2ScoreAlternateDenormalized(*dataOpt) << std::endl;
 
-    if (options.ValidateAfterTraining) {
-      std::cout << "\nTraining set:" << std::endl;
-      outputBehaviour(data.first);
-      std::cout << "\nValidation set:" << std::endl;
-      outputBehaviour(data.second);
+    if (!minMaxInputtedByUser && !useCachedMinMax) {
+      minMax = passMinMax;
+    }
+  }
+
+  // Without data points, the min/max values would stay at the limits of the data type and every mean squared error would be NaN:
+  if (stream->numberOfDataPoints().value_or(0) == 0) {
+    std::cout << "Error: The input file " << options.InputDataFilePath << " contains no data points." << std::endl;
+    return false;
+  }
+
+  if (!minMaxValuesAreValid()) {
+    if (minMaxInputtedByUser) {
+      std::cout << "The inputted min/max values are invalid. A minimum value must not be equal to the corresponding maximum value." << std::endl;
     } else {
-      outputBehaviour(*dataOpt);
+      std::cout << "The inputted data is invalid. If no min/max values for the normalization are inputted, each column must contain at least 2 different values." << std::endl;
     }
+    return false;
   }
 
-  if (options.InteractiveMode) {
-    performInteractiveMode();
+  if (options.OutputMinMaxFilePath != Utilities::DefaultValues::OUTPUT_MIN_MAX_FILE_PATH) {
+    saveMinMaxToFile();
   }
 
+  // Every chunk of the following passes is scaled, normalized and converted to the selected precision while the previous chunk is trained:
+  createNormalizers();
+  stream->setPreparation([this, scaleOutputs](torch::Tensor& inputs, torch::Tensor& outputs) {
+    scaleOutputs(outputs);
+    normalizeData(inputs, outputs);
+    if (options.Precision != TORCH_DATA_TYPE) {
+      inputs = inputs.to(options.Precision);
+      outputs = outputs.to(options.Precision);
+    }
+  });
+  telemetry.endPhase();
+
   return true;
 }
 
-void Logic::trainNetwork(DataVector const& data)
+bool Logic::trainsOnStackedData(Utilities::ProgramOptions const& options)
 {
-  if (data.empty()) {
-    return;
+  return options.Optimizer == Utilities::OptimizerType::LBFGS || options.DataParallelWorkers > 1 ||
+         (!options.BatchVariable.has_value() && (options.MiniBatchSize.has_value() || options.ShuffleData));
+}
+
+void Logic::adoptDataPreparation(Logic const& preparedLogic)
+{
+  useMixedScaling = preparedLogic.useMixedScaling;
+  normalizedMixedScalingThreshold = preparedLogic.normalizedMixedScalingThreshold;
+  minMax = preparedLogic.minMax;
+  mixedScalingMinMax = preparedLogic.mixedScalingMinMax;
+  inputNormalizer = preparedLogic.inputNormalizer;
+  outputNormalizer = preparedLogic.outputNormalizer;
+  belowThresholdOutputNormalizer = preparedLogic.belowThresholdOutputNormalizer;
+  inputFileHeader = preparedLogic.inputFileHeader;
+}
+
+bool Logic::prepareTraining(Utilities::ProgramOptions const& user_options, DataVector const& data,
+                            std::optional<std::pair<DataVector, DataVector>> predefinedSplit, std::optional<SharedTrainingData> sharedData)
+{
+  options = user_options;
+
+  if (options.RNGSeed) {
+    torch::manual_seed(*options.RNGSeed);
+    shuffleGenerator.seed(*options.RNGSeed);
+  } else {
+    shuffleGenerator.seed(std::random_device{}());
   }
 
-  auto const& numberOfEpochs = options.NumberOfEpochs;
-  bool saveProgress = options.SaveProgressFilePath != Utilities::DefaultValues::PROGRESS_FILE_PATH;
+  if (options.DebugOutput) {
+    std::cout << "Configure network..." << std::endl;
+  }
+
+  network = createNetwork();
+  analyzer = std::make_unique<NetworkAnalyzer>(network, [this](torch::Tensor const& inTensor, torch::Tensor& outTensor, bool limitValues) {
+    denormalizeOutputTensor(inTensor, outTensor, limitValues);
+  }, [this](torch::Tensor const& inTensor, torch::Tensor& outTensor) {
+    unscaleOutputTensor(inTensor, outTensor);
+  });
+
+  // Load pre-trained weights:
+  if (options.InputNetworkParameters != Utilities::DefaultValues::INPUT_NETWORK_PARAMETERS) {
+    auto trainedPrecision = loadNetwork(network, options.InputNetworkParameters);
+    if (trainedPrecision != options.Precision) {
+      std::cout << "[Warning] The loaded weights were trained with " << c10::toString(trainedPrecision) << " precision and are converted to " <<
+                   c10::toString(options.Precision) << " precision." << std::endl;
+    }
+  }
+
+  // A streamed input file is not in the given data:
+  auto const numberOfDataPoints = stream ? stream->numberOfDataPoints().value_or(0) : data.size();
 
-  torch::optim::SGD optimizer(network->parameters(), options.LearnRate);
+  // The state of a resumed training contains the seed of the validation split, so the training continues with the same split:
+  bool resumeTraining = options.ResumeDirectory != Utilities::DefaultValues::RESUME_DIRECTORY;
+  if (resumeTraining) {
+    auto resumedState = loadTrainingState(options.ResumeDirectory);
+    if (!resumedState) {
+      return false;
+    }
+    if (resumedState->numberOfDataPoints != numberOfDataPoints) {
+      std::cout << "Error: The checkpoint was trained with " << resumedState->numberOfDataPoints << " data points, but the input file contains " <<
+                   numberOfDataPoints << " data points." << std::endl;
+      return false;
+    }
+    trainingState = std::move(*resumedState);
+  } else {
+    trainingState = TrainingState{};
+    trainingState.numberOfDataPoints = numberOfDataPoints;
+    trainingState.splitSeed = shuffleGenerator();
+  }
 
-  auto lastMeanError = analyzer->calculateMeanSquaredError(data);
-  auto currentMeanError = lastMeanError;
+  if (predefinedSplit) {
+    splitData = std::move(*predefinedSplit);
+  } else if (options.ValidateAfterTraining) {
+    splitData = Utilities::DataSplitter::splitDataRandomly(data, 100.0 - options.ValidationPercentage, trainingState.splitSeed);
+    if (sharedData && !sharedData->trainingRows.defined()) {
+      sharedData->trainingRows = Utilities::DataSplitter::trainingRowsOfRandomSplit(data.size(), 100.0 - options.ValidationPercentage, trainingState.splitSeed);
+    }
+  } else {
+    splitData = std::make_pair(data, DataVector());
+  }
 
-  bool continueTraining = true;
-  uint32_t numberOfDeteriorationsInRow = 0;
+  if (options.BatchVariable.has_value()) {
+    useBatchTraining = true;
 
-  auto start = std::chrono::steady_clock::now();
+    batchedTrainingData = Utilities::DataSplitter::splitDataIntoBatches(splitData.first, options.BatchVariable.value());
 
-  for (uint32_t epoch = 1; epoch <= numberOfEpochs || continueTraining; ++epoch) {
+    if (options.DebugOutput && !batchedTrainingData.empty()) {
+      std::cout << "Split training data (" << splitData.first.size() << " data points) into " << batchedTrainingData.size() << " batches." << std::endl;
+      std::cout << "Size of first batch: " << batchedTrainingData.front().first.size(0) << std::endl;
+    }
+  }
+
+  if (splitData.first.empty() && !stream) {
+    return true;
+  }
+
+  optimizer = createOptimizer(network->parameters());
+  scheduler = std::make_unique<LearnRateScheduler>(options);
+  bool useFullBatchTraining = options.Optimizer == Utilities::OptimizerType::LBFGS;
+  bool useDataParallelTraining = options.DataParallelWorkers > 1;
+  usePipeline = !stream && !useFullBatchTraining && !useBatchTraining && !useDataParallelTraining && trainsOnStackedData(options);
+
+  if (resumeTraining) {
+    if (!loadCheckpointParameters(options.ResumeDirectory, network, *optimizer)) {
+      return false;
+    }
+    LearnRateScheduler::applyLearnRate(*optimizer, trainingState.learnRate);
+    scheduler->restoreState(trainingState.schedulerState);
+    std::istringstream(trainingState.randomGeneratorState) >> shuffleGenerator;
+    trainingProgress = std::exchange(trainingState.progress, {});
+
+    if (options.DebugOutput) {
+      std::cout << "Resume the training after epoch " << trainingState.epoch << "." << std::endl;
+    }
+  } else {
+    trainingState.learnRate = options.LearnRate;
+    trainingState.shuffleSeed = shuffleGenerator();
+    trainingState.currentMeanError = trainingMeanSquaredError();
+    trainingState.trainingPassMeanError = trainingState.currentMeanError;
+    trainingState.exactMeanError = trainingState.currentMeanError;
+  }
+
+  // Shared data is not copied, the training rows select the data points of this training:
+  if (sharedData && (usePipeline || useFullBatchTraining || useDataParallelTraining)) {
+    stackedInputs = sharedData->inputs;
+    stackedOutputs = sharedData->outputs;
+    trainingRows = sharedData->trainingRows;
+  } else if (usePipeline || useFullBatchTraining || useDataParallelTraining) {
+    std::tie(stackedInputs, stackedOutputs) = Utilities::DataProcessor::StackData(splitData.first);
+  }
+
+  if (useDataParallelTraining) {
+    // The workers share the intra-op threads, so every worker gets its part of them:
+    torch::set_num_threads(std::max(1, options.NumberOfThreads / static_cast<int32_t>(options.DataParallelWorkers)));
+
+    parallelTrainer = std::make_unique<ParallelTrainer>(network, *optimizer, stackedInputs, stackedOutputs, trainingRows, options,
+      [this]() { return createNetwork(); },
+      [this](std::vector<torch::Tensor> const& parameters) { return createOptimizer(parameters); },
+      trainingState.shuffleSeed);
+    parallelTrainer->setLearnRate(trainingState.learnRate);
+  }
+
+  if (options.SaveProgressFilePath != Utilities::DefaultValues::PROGRESS_FILE_PATH) {
+    progressEvaluator = std::make_unique<ProgressEvaluator>(createNetwork(), splitData.first);
+  }
+
+  return true;
+}
+
+bool Logic::train(uint32_t const lastEpoch, bool const continueAfterLastEpoch)
+{
+  if (!optimizer) {
+    return true;
+  }
+  if (trainingStopped) {
+    return false;
+  }
+
+  auto const& numberOfEpochs = options.NumberOfEpochs;
+  bool saveProgress = options.SaveProgressFilePath != Utilities::DefaultValues::PROGRESS_FILE_PATH;
+  bool useFullBatchTraining = options.Optimizer == Utilities::OptimizerType::LBFGS;
+  bool useValidationStopping = options.ValidationInterval.has_value() && !splitData.second.empty();
+  bool saveCheckpoints = options.CheckpointInterval.has_value();
+  std::optional<TrainingState> uncheckpointedState{}; // state after the last epoch, if it is not in the saved checkpoint
+
+  auto const numberOfTrainingSamples = stream ? trainingState.numberOfDataPoints : splitData.first.size();
+  auto lastMeanError = trainingState.currentMeanError;
+
+  // Mini-batches and shuffled data points are assembled on a background thread, which starts with the next epoch:
+  if (usePipeline && !pipeline) {
+    pipeline = std::make_unique<DataPipeline>(stackedInputs, stackedOutputs, trainingRows, static_cast<int64_t>(options.MiniBatchSize.value_or(1)),
+      options.PrefetchBatches, trainingState.shuffleSeed, trainingState.epoch + 1);
+  }
+
+  // Elapsed time of previous calls (and of a resumed training) is included, so the timeout and the progress continue:
+  auto start = std::chrono::steady_clock::now() - std::chrono::milliseconds(trainingState.elapsedTimeInMS);
+
+  for (uint32_t epoch = trainingState.epoch + 1; epoch <= lastEpoch || (continueAfterLastEpoch && trainingState.continueTraining); ++epoch) {
     auto elapsed = std::chrono::duration_cast<TimeoutDuration>(std::chrono::steady_clock::now() - start);
     auto remaining = ((elapsed / std::max(epoch - 1, 1u)) * (numberOfEpochs - epoch + 1));
-    lastMeanError = currentMeanError;
-    currentMeanError = analyzer->calculateMeanSquaredError(data);
+    lastMeanError = trainingState.currentMeanError;
+    bool const exactEvaluation = (epoch - 1) % options.LossEvaluationInterval == 0;
+    if (exactEvaluation) {
+      trainingState.currentMeanError = trainingMeanSquaredError();
+    } else {
+      trainingState.currentMeanError = trainingState.trainingPassMeanError;
+    }
 
-    if (lastMeanError - currentMeanError < options.Epsilon) {
-      ++numberOfDeteriorationsInRow;
-      if (numberOfDeteriorationsInRow > options.NumberOfDeteriorations) {
-        continueTraining = false;
+    // The training pass average of the epochs in between is a different measure, so the stopping criteria only compare exact values:
+    if (exactEvaluation) {
+      if (trainingState.exactMeanError - trainingState.currentMeanError < options.Epsilon) {
+        ++trainingState.numberOfDeteriorationsInRow;
+        if (trainingState.numberOfDeteriorationsInRow > options.NumberOfDeteriorations) {
+          trainingState.continueTraining = false;
+        }
+      } else {
+        trainingState.numberOfDeteriorationsInRow = 0;
+      }
+      trainingState.exactMeanError = trainingState.currentMeanError;
+    }
+
+    if (scheduler->isActive()) {
+      auto newLearnRate = scheduler->learnRateForEpoch(epoch, exactEvaluation ? std::make_optional(trainingState.exactMeanError) : std::nullopt);
+      if (newLearnRate != trainingState.learnRate) {
+        LearnRateScheduler::applyLearnRate(*optimizer, newLearnRate);
+        if (parallelTrainer) {
+          parallelTrainer->setLearnRate(newLearnRate);
+        }
+        if (options.DebugOutput) {
+          std::cout << "\nLearning rate changed from " << trainingState.learnRate << " to " << newLearnRate << " in epoch " << epoch << "." << std::endl;
+        }
+        trainingState.learnRate = newLearnRate;
       }
-    } else {
-      numberOfDeteriorationsInRow = 0;
     }
 
-    if (saveProgress) {
-      auto r2score = analyzer->calculateR2ScoreAlternate(data);
-      trainingProgress.emplace_back(LearnProgressDataSet{
+    // The errors of the progress are calculated on a background thread with a copy of the current weights:
+    if (saveProgress && (epoch - 1) % options.ProgressInterval == 0) {
+      progressEvaluator->evaluate(LearnProgressDataSet{
         epoch,
-        r2score,
-        currentMeanError,
-        static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count())
-      });
+        {},
+        0.0,
+        static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()),
+        trainingState.learnRate
+      }, copyNetworkState(network));
     }
 
     if (options.ShowProgressDuringTraining) {
       if (epoch > numberOfEpochs) {
-        std::cout << "\rContinue training. Mean squared error changed from " << lastMeanError << " to " << currentMeanError << " -- epoch: " << epoch;
+        std::cout << "\rContinue training. Mean squared error changed from " << lastMeanError << " to " << trainingState.currentMeanError << " -- epoch: " << epoch;
         std::flush(std::cout);
       } else {
-        std::cout << "\rEpoch " << epoch << " of " << numberOfEpochs << ". Current mean squared error: " << currentMeanError << " previous: " << lastMeanError <<
+        std::cout << "\rEpoch " << epoch << " of " << numberOfEpochs << ". Current mean squared error: " << trainingState.currentMeanError << " previous: " << lastMeanError <<
                   " -- Remaining time: " << formatDuration<std::chrono::milliseconds, std::chrono::hours, std::chrono::minutes, std::chrono::seconds>(remaining); // TODO better output
         std::flush(std::cout);
       }
@@ -289,47 +698,350 @@ void Logic::trainNetwork(DataVector const& data)
 
     if (elapsed > options.MaxExecutionTime) {
       std::cout << "\nStop execution (timeout)." << std::endl;
+      trainingStopped = true;
       break;
     }
 
-    if (std::isnan(currentMeanError)) {
+    if (std::isnan(trainingState.currentMeanError)) {
       std::cout << "\nStop execution (error is NaN)." << std::endl;
+      trainingStopped = true;
+      uncheckpointedState.reset(); // the previous checkpoint is kept instead of the broken weights
       break;
     }
 
-    if (useBatchTraining) {
-      for (auto const& [identifier, batch] : batchedTrainingData) {
-        (void) identifier;
-
-        optimizer.zero_grad();
-
-        for (auto const& [x, y] : batch) {
-          auto prediction = network->forward(x);
-          auto loss = torch::mse_loss(prediction, y);
+    if (useValidationStopping && (epoch - 1) % options.ValidationInterval.value() == 0) {
+      auto validationError = analyzer->calculateMeanSquaredError(splitData.second);
+      if (validationError < trainingState.bestValidationError) {
+        trainingState.bestValidationError = validationError;
+        trainingState.bestValidationEpoch = epoch - 1;
+        trainingState.bestNetworkState = copyNetworkState(network);
+        trainingState.numberOfValidationsWithoutImprovement = 0;
+      } else if (++trainingState.numberOfValidationsWithoutImprovement >= options.ValidationPatience) {
+        std::cout << "\nStop execution (validation error did not improve in the last " << trainingState.numberOfValidationsWithoutImprovement << " evaluations)." << std::endl;
+        trainingStopped = true;
+        validationStopped = true;
+        break;
+      }
+    }
 
-          loss.backward();
-        }
+    auto trainingStart = std::chrono::steady_clock::now();
 
-        optimizer.step();
+    double trainingPassError;
+    if (parallelTrainer) {
+      trainingPassError = parallelTrainer->trainEpoch(epoch);
+    } else if (useFullBatchTraining) {
+      // The rows of shared data are gathered for every epoch, so the logic keeps no copy of them:
+      if (trainingRows.defined()) {
+        trainingPassError = trainEpochFullBatch(stackedInputs.index_select(0, trainingRows), stackedOutputs.index_select(0, trainingRows), *optimizer);
+      } else {
+        trainingPassError = trainEpochFullBatch(stackedInputs, stackedOutputs, *optimizer);
       }
+    } else if (useBatchTraining) {
+      trainingPassError = trainEpochBatchVariable(*optimizer);
+    } else if (pipeline) {
+      trainingPassError = trainEpochPipeline(*pipeline, *optimizer);
+    } else if (stream) {
+      trainingPassError = trainEpochStreaming(*stream, *optimizer, epoch);
     } else {
-      for (auto const& [x, y] : data) {
-        auto prediction = network->forward(x);
+      trainingPassError = trainEpochPerRow(splitData.first, *optimizer);
+    }
+    trainingState.trainingPassMeanError = trainingPassError / numberOfTrainingSamples;
+
+    if (stream && stream->failed()) {
+      std::cout << "\nStop execution (the input file could not be read)." << std::endl;
+      trainingStopped = true;
+      uncheckpointedState.reset(); // the weights of the unfinished epoch do not match the state
+      break;
+    }
 
-        auto loss = torch::mse_loss(prediction, y);
+    auto epochTrainingDuration = std::chrono::steady_clock::now() - trainingStart;
+    trainingDuration += epochTrainingDuration;
+    numberOfTrainedSamples += numberOfTrainingSamples;
+    telemetry.recordEpoch(epoch, numberOfTrainingSamples, epochTrainingDuration);
 
-        optimizer.zero_grad();
+    trainingState.epoch = epoch;
+    trainingState.elapsedTimeInMS = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
 
-        loss.backward();
-        optimizer.step();
+    if (saveCheckpoints) {
+      trainingState.schedulerState = scheduler->state();
+      if (epoch % options.CheckpointInterval.value() == 0) {
+        writeCheckpoint(trainingState);
+        uncheckpointedState.reset();
+      } else {
+        uncheckpointedState = trainingState;
       }
     }
   }
 
+  // The last epoch, a timeout or a stop are saved as well. The next epoch may already have changed the state, but not the weights:
+  if (uncheckpointedState) {
+    writeCheckpoint(*uncheckpointedState);
+  }
+
+  return !trainingStopped;
+}
+
+void Logic::writeCheckpoint(TrainingState& state)
+{
+  std::ostringstream generatorState{};
+  generatorState << shuffleGenerator;
+  state.randomGeneratorState = generatorState.str();
+
+  // The progress of the following epoch is evaluated again after resuming:
+  if (progressEvaluator) {
+    progressEvaluator->collect(trainingProgress);
+  }
+  state.progress.clear();
+  std::copy_if(trainingProgress.begin(), trainingProgress.end(), std::back_inserter(state.progress),
+               [&](LearnProgressDataSet const& entry) { return entry.epoch <= state.epoch; });
+
+  if (!saveCheckpoint(options.CheckpointDirectory, network, *optimizer, state)) {
+    std::cout << "\n[Warning] The checkpoint of epoch " << state.epoch << " was not saved, a resumed training starts from the previous checkpoint." << std::endl;
+  }
+  state.progress.clear();
+}
+
+void Logic::pauseTraining()
+{
+  // The batches only depend on the seed and the epoch, so the next call of train assembles the same batches again:
+  pipeline.reset();
+}
+
+void Logic::finishTraining()
+{
+  if (!optimizer) {
+    return;
+  }
+
+  pauseTraining();
+
+  if (progressEvaluator) {
+    progressEvaluator->collect(trainingProgress);
+  }
+
+  // The final weights were not validated yet, they are only kept if they are better than the best validated ones:
+  bool useValidationStopping = options.ValidationInterval.has_value() && !splitData.second.empty();
+  if (useValidationStopping && !trainingState.bestNetworkState.empty() && validationMeanSquaredError() > trainingState.bestValidationError) {
+    restoreNetworkState(network, trainingState.bestNetworkState);
+    if (options.DebugOutput || options.ShowProgressDuringTraining) {
+      std::cout << "\nRestored the weights after epoch " << trainingState.bestValidationEpoch << " with the lowest validation error: " << trainingState.bestValidationError;
+      std::flush(std::cout);
+    }
+  }
+
+  if (options.LossEvaluationInterval > 1 && (options.DebugOutput || options.ShowProgressDuringTraining)) {
+    std::cout << "\nMean squared error after training: " << trainingMeanSquaredError();
+    std::flush(std::cout);
+  }
+
   if (options.DebugOutput) {
     std::cout << "\nTraining duration: " << formatDuration<std::chrono::milliseconds, std::chrono::hours, std::chrono::minutes, std::chrono::seconds>
-      (std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start)) << std::endl;
+      (std::chrono::milliseconds(trainingState.elapsedTimeInMS)) << std::endl;
+
+    auto trainingSeconds = std::chrono::duration<double>(trainingDuration).count();
+    if (trainingSeconds > 0.0) {
+      std::cout << "Training throughput: " << static_cast<double>(numberOfTrainedSamples) / trainingSeconds << " samples/s" << std::endl;
+    }
+  }
+
+  if (parallelTrainer) {
+    torch::set_num_threads(options.NumberOfThreads);
+  }
+}
+
+double Logic::trainingMeanSquaredError()
+{
+  if (!stream) {
+    return analyzer->calculateMeanSquaredError(splitData.first);
+  }
+
+  // A streamed input file is read again:
+  torch::NoGradGuard noGradGuard;
+  double errorSum = 0.0;
+  uint64_t numberOfSamples = 0;
+
+  stream->start();
+  while (auto chunk = stream->next()) {
+    auto const& [inputs, outputs] = *chunk;
+    errorSum += torch::mse_loss(network->forward(inputs), outputs, at::Reduction::Sum).item<double>() / outputs.size(1);
+    numberOfSamples += inputs.size(0);
   }
+
+  return errorSum / numberOfSamples;
+}
+
+double Logic::validationMeanSquaredError()
+{
+  return analyzer->calculateMeanSquaredError(splitData.second);
+}
+
+Network const& Logic::getNetwork() const
+{
+  return network;
+}
+
+NetworkMetrics Logic::calculateTrainingMetrics()
+{
+  return analyzer->calculateMetrics(splitData.first);
+}
+
+NetworkMetrics Logic::calculateValidationMetrics()
+{
+  return analyzer->calculateMetrics(splitData.second);
+}
+
+uint32_t Logic::numberOfTrainedEpochs() const
+{
+  return trainingState.epoch;
+}
+
+bool Logic::stoppedByValidation() const
+{
+  return validationStopped;
+}
+
+double Logic::trainEpochPerRow(DataVector const& data, torch::optim::Optimizer& optimizer)
+{
+  auto errorSum = torch::zeros({}, TORCH_DATA_TYPE);
+
+  for (auto const& [x, y] : data) {
+    auto prediction = network->forward(x);
+
+    auto loss = torch::mse_loss(prediction, y);
+    errorSum += loss.detach().to(TORCH_DATA_TYPE);
+
+    optimizer.zero_grad();
+
+    loss.backward();
+    optimizer.step();
+  }
+
+  return errorSum.item<double>();
+}
+
+double Logic::trainEpochBatchVariable(torch::optim::Optimizer& optimizer)
+{
+  auto errorSum = torch::zeros({}, TORCH_DATA_TYPE);
+
+  for (auto const& [x, y] : batchedTrainingData) {
+    optimizer.zero_grad();
+
+    // Same gradient as one backward pass per data point:
+    auto prediction = network->forward(x);
+    auto loss = torch::mse_loss(prediction, y, at::Reduction::Sum) / y.size(1);
+    errorSum += loss.detach().to(TORCH_DATA_TYPE);
+
+    loss.backward();
+    optimizer.step();
+  }
+
+  return errorSum.item<double>();
+}
+
+double Logic::trainEpochPipeline(DataPipeline& pipeline, torch::optim::Optimizer& optimizer)
+{
+  auto errorSum = torch::zeros({}, TORCH_DATA_TYPE);
+
+  while (auto batch = pipeline.next()) {
+    auto const& [x, y] = *batch;
+
+    auto prediction = network->forward(x);
+    auto loss = torch::mse_loss(prediction, y);
+    errorSum += loss.detach().to(TORCH_DATA_TYPE) * x.size(0);
+
+    optimizer.zero_grad();
+
+    loss.backward();
+    optimizer.step();
+  }
+
+  return errorSum.item<double>();
+}
+
+double Logic::trainEpochStreaming(Utilities::DataStream& dataStream, torch::optim::Optimizer& optimizer, uint32_t const epoch)
+{
+  auto errorSum = torch::zeros({}, TORCH_DATA_TYPE);
+  auto const batchSize = static_cast<int64_t>(options.MiniBatchSize.value_or(1));
+  bool const shuffle = options.ShuffleData || options.MiniBatchSize.has_value();
+
+  // The chunks are read in random order and the data points of every chunk are shuffled (the n-th read chunk with stream n):
+  dataStream.start(shuffle ? std::make_optional<uint64_t>(epochGenerator(trainingState.shuffleSeed, epoch)()) : std::nullopt);
+  for (uint32_t chunkNumber = 1; auto chunk = dataStream.next(); ++chunkNumber) {
+    auto [inputs, outputs] = std::move(*chunk);
+    auto const numberOfSamples = inputs.size(0);
+
+    if (shuffle) {
+      auto indices = epochPermutation(torch::arange(numberOfSamples, torch::kLong), trainingState.shuffleSeed, epoch, chunkNumber);
+      inputs = inputs.index_select(0, indices);
+      outputs = outputs.index_select(0, indices);
+    }
+
+    for (int64_t first = 0; first < numberOfSamples; first += batchSize) {
+      auto const numberOfBatchSamples = std::min(batchSize, numberOfSamples - first);
+      auto x = inputs.narrow(0, first, numberOfBatchSamples);
+      auto y = outputs.narrow(0, first, numberOfBatchSamples);
+
+      auto prediction = network->forward(x);
+      auto loss = torch::mse_loss(prediction, y);
+      errorSum += loss.detach().to(TORCH_DATA_TYPE) * numberOfBatchSamples;
+
+      optimizer.zero_grad();
+
+      loss.backward();
+      optimizer.step();
+    }
+  }
+
+  return errorSum.item<double>();
+}
+
+double Logic::trainEpochFullBatch(torch::Tensor const& inputs, torch::Tensor const& outputs, torch::optim::Optimizer& optimizer)
+{
+  auto closure = [&]() {
+    optimizer.zero_grad();
+
+    auto prediction = network->forward(inputs);
+    auto loss = torch::mse_loss(prediction, outputs);
+
+    loss.backward();
+    return loss;
+  };
+
+  auto loss = optimizer.step(closure);
+
+  return loss.item<double>() * inputs.size(0);
+}
+
+Network Logic::createNetwork() const
+{
+  auto networkConfiguration = std::vector<uint32_t>();
+  for (uint32_t i = 0; i < options.NumberOfLayers; ++i) {
+    networkConfiguration.push_back(options.NumberOfNodesPerLayer);
+  }
+
+  return Network{options.NumberOfInputVariables, options.NumberOfOutputVariables, networkConfiguration, options.Precision};
+}
+
+std::unique_ptr<torch::optim::Optimizer> Logic::createOptimizer(std::vector<torch::Tensor> const& parameters) const
+{
+  switch (options.Optimizer) {
+    case Utilities::OptimizerType::Momentum:
+      return std::make_unique<torch::optim::SGD>(parameters, torch::optim::SGDOptions(options.LearnRate)
+        .momentum(options.Momentum).weight_decay(options.WeightDecay));
+    case Utilities::OptimizerType::Adam:
+      return std::make_unique<torch::optim::Adam>(parameters, torch::optim::AdamOptions(options.LearnRate)
+        .betas(std::make_tuple(options.AdamBeta1, options.AdamBeta2)).weight_decay(options.WeightDecay));
+    case Utilities::OptimizerType::RMSprop:
+      return std::make_unique<torch::optim::RMSprop>(parameters, torch::optim::RMSpropOptions(options.LearnRate)
+        .alpha(options.RMSpropAlpha).weight_decay(options.WeightDecay));
+    case Utilities::OptimizerType::LBFGS:
+      return std::make_unique<torch::optim::LBFGS>(parameters, torch::optim::LBFGSOptions(options.LearnRate)
+        .max_iter(options.LBFGSMaxIterations).history_size(options.LBFGSHistorySize).line_search_fn("strong_wolfe"));
+    case Utilities::OptimizerType::SGD:
+      break;
+  }
+
+  return std::make_unique<torch::optim::SGD>(parameters, torch::optim::SGDOptions(options.LearnRate).weight_decay(options.WeightDecay));
 }
 
 void Logic::performInteractiveMode()
@@ -354,8 +1066,8 @@ void Logic::performInteractiveMode()
     }
 
     if (currentVariable >= options.NumberOfInputVariables) {
-      Utilities::DataProcessor::Normalize(inTensor, (useMixedScaling) ? mixedScalingMinMax.first.first : inputMinMax, 0.0, 1.0);
-      auto output = network->forward(inTensor);
+      inputNormalizer.normalize(inTensor);
+      auto output = network->forward(inTensor.to(options.Precision)).to(TORCH_DATA_TYPE);
       auto dOutputTensor = output.clone();
       denormalizeOutputTensor(inTensor, dOutputTensor, false);
 
@@ -382,9 +1094,9 @@ void Logic::outputBehaviour(DataVector const& data)
     auto prediction = network->forward(inputTensor);
     auto loss = torch::mse_loss(prediction, outputTensor);
 
-    torch::Tensor dInputTensor = inputTensor.clone();
-    torch::Tensor dOutputTensor = outputTensor.clone();
-    torch::Tensor dPrediction = prediction.clone();
+    torch::Tensor dInputTensor = inputTensor.to(TORCH_DATA_TYPE, false, true);
+    torch::Tensor dOutputTensor = outputTensor.to(TORCH_DATA_TYPE, false, true);
+    torch::Tensor dPrediction = prediction.to(TORCH_DATA_TYPE, false, true);
 
     denormalizeInputTensor(dInputTensor, false);
     denormalizeOutputTensor(inputTensor, dOutputTensor, false);
@@ -405,53 +1117,88 @@ void Logic::outputBehaviour(DataVector const& data)
 
 void Logic::saveValuesToFile(DataVector const& data, std::string const& path)
 {
-  DataVector values(data.size());
+  if (data.empty()) {
+    return;
+  }
 
-  size_t i = 0;
-  for (auto const& [inputTensor, outputTensor] : data) {
-    (void) outputTensor;
-    auto prediction = network->forward(inputTensor);
-    torch::Tensor dInputTensor = inputTensor.clone();
+  torch::NoGradGuard noGradGuard;
+  std::vector<torch::Tensor> inputChunks{};
+  std::vector<torch::Tensor> valueChunks{};
 
-    denormalizeInputTensor(dInputTensor, false);
-    denormalizeOutputTensor(inputTensor, prediction, false);
+  // The data points are inferred, denormalized and unscaled in batches:
+  for (size_t first = 0; first < data.size(); first += OUTPUT_CHUNK_SIZE) {
+    auto last = std::min(first + OUTPUT_CHUNK_SIZE, data.size());
+    auto [inputs, outputs] = Utilities::DataProcessor::StackData(DataVector(data.begin() + first, data.begin() + last));
+    (void) outputs;
 
-    unscaleOutputTensor(inputTensor, prediction);
+    auto prediction = network->forward(inputs).to(TORCH_DATA_TYPE, false, true);
+    torch::Tensor dInputs = inputs.to(TORCH_DATA_TYPE, false, true);
 
-    values[i++] = std::make_pair(dInputTensor, prediction);
+    denormalizeInputTensor(dInputs, false);
+    denormalizeOutputTensor(inputs, prediction, false);
+
+    unscaleOutputTensor(inputs, prediction);
+
+    inputChunks.push_back(dInputs);
+    valueChunks.push_back(prediction);
   }
 
-  Utilities::FileParser::SaveData(values, path, inputFileHeader);
+  Utilities::FileParser::SaveTensors(torch::cat(inputChunks), torch::cat(valueChunks), path, inputFileHeader);
 }
 
 void Logic::saveDiffToFile(DataVector const& data, std::string const& path, bool outputRelativeDiff)
 {
-  DataVector diff(data.size());
+  if (data.empty()) {
+    return;
+  }
 
-  size_t i = 0;
-  for (auto const& [inputTensor, outputTensor] : data) {
-    auto prediction = network->forward(inputTensor);
-    torch::Tensor dInputTensor = inputTensor.clone();
-    torch::Tensor dOutputTensor = outputTensor.clone();
+  torch::NoGradGuard noGradGuard;
+  std::vector<torch::Tensor> inputChunks{};
+  std::vector<torch::Tensor> diffChunks{};
 
-    denormalizeInputTensor(dInputTensor, false);
-    denormalizeOutputTensor(inputTensor, dOutputTensor, false);
-    denormalizeOutputTensor(inputTensor, prediction, false);
+  // The data points are inferred, denormalized and unscaled in batches:
+  for (size_t first = 0; first < data.size(); first += OUTPUT_CHUNK_SIZE) {
+    auto last = std::min(first + OUTPUT_CHUNK_SIZE, data.size());
+    auto [inputs, outputs] = Utilities::DataProcessor::StackData(DataVector(data.begin() + first, data.begin() + last));
 
-    unscaleOutputTensor(inputTensor, dOutputTensor);
-    unscaleOutputTensor(inputTensor, prediction);
+    auto prediction = network->forward(inputs).to(TORCH_DATA_TYPE, false, true);
+    torch::Tensor dInputs = inputs.to(TORCH_DATA_TYPE, false, true);
+    torch::Tensor dOutputs = outputs.to(TORCH_DATA_TYPE, false, true);
+
+    denormalizeInputTensor(dInputs, false);
+    denormalizeOutputTensor(inputs, dOutputs, false);
+    denormalizeOutputTensor(inputs, prediction, false);
+
+    unscaleOutputTensor(inputs, dOutputs);
+    unscaleOutputTensor(inputs, prediction);
 
-    torch::Tensor difference;
     if (outputRelativeDiff) {
-      difference = NetworkAnalyzer::calculateRelativeDiff(dOutputTensor, prediction);
+      diffChunks.push_back(NetworkAnalyzer::calculateRelativeDiff(dOutputs, prediction));
     } else {
-      difference = NetworkAnalyzer::calculateDiff(dOutputTensor, prediction);
+      diffChunks.push_back(NetworkAnalyzer::calculateDiff(dOutputs, prediction));
     }
+    inputChunks.push_back(dInputs);
+  }
 
-    diff[i++] = std::make_pair(dInputTensor, difference);
+  Utilities::FileParser::SaveTensors(torch::cat(inputChunks), torch::cat(diffChunks), path, inputFileHeader);
+}
+
+void Logic::saveErrorReportToFile(std::pair<DataVector, DataVector> const& splitData, DataVector const& allData)
+{
+  std::vector<std::pair<std::string, Utilities::ErrorReport>> reports{};
+  if (options.ValidateAfterTraining) {
+    reports.emplace_back("training", analyzer->calculateErrorReport(splitData.first));
+    reports.emplace_back("validation", analyzer->calculateErrorReport(splitData.second));
   }
+  reports.emplace_back("all", analyzer->calculateErrorReport(allData));
 
-  Utilities::FileParser::SaveData(diff, path, inputFileHeader);
+  auto columnNames = Utilities::FileParser::SplitFileHeader(inputFileHeader);
+  auto outputColumnNames = std::vector<std::string>();
+  for (size_t i = options.NumberOfInputVariables; i < columnNames.size(); ++i) {
+    outputColumnNames.push_back(columnNames[i]);
+  }
+
+  Utilities::FileParser::SaveErrorReports(reports, options.OutputReportFilePath, outputColumnNames);
 }
 
 void Logic::saveMinMaxToFile() const
@@ -494,21 +1241,51 @@ void Logic::saveMinMaxToFile() const
   Utilities::FileParser::SaveData(data, options.OutputMinMaxFilePath, inputFileHeader);
 }
 
-inline void Logic::denormalizeInputTensor(torch::Tensor& tensor, bool limitValues)
+void Logic::createNormalizers()
 {
-  Utilities::DataProcessor::Denormalize(tensor, (useMixedScaling) ? mixedScalingMinMax.first.first : inputMinMax, 0.0, 1.0, limitValues);
+  // TODO let user control normalization
+  if (useMixedScaling) {
+    inputNormalizer = Utilities::Normalizer(mixedScalingMinMax.first.first, 0.0, 1.0);
+    belowThresholdOutputNormalizer = Utilities::Normalizer(mixedScalingMinMax.first.second, -1.0, 0.0); // TODO check if overlap is a problem
+    outputNormalizer = Utilities::Normalizer(mixedScalingMinMax.second.second, 0.0, 1.0);
+  } else {
+    inputNormalizer = Utilities::Normalizer(inputMinMax, 0.0, 1.0);
+    outputNormalizer = Utilities::Normalizer(outputMinMax, 0.0, 1.0);
+    belowThresholdOutputNormalizer = Utilities::Normalizer();
+  }
 }
 
-inline void Logic::denormalizeOutputTensor(torch::Tensor const& inputTensor, torch::Tensor& outputTensor, bool limitValues)
+void Logic::normalizeData(torch::Tensor& inputTensor, torch::Tensor& outputTensor) const
 {
   if (useMixedScaling) {
-    if (inputTensor[options.MixedScalingInputVariable].item<TensorDataType>() <= normalizedMixedScalingThreshold) {
-      Utilities::DataProcessor::Denormalize(outputTensor, mixedScalingMinMax.first.second, -1.0, 0.0, limitValues);
-    } else {
-      Utilities::DataProcessor::Denormalize(outputTensor, mixedScalingMinMax.second.second, 0.0, 1.0, limitValues);
-    }
+    auto belowThreshold = inputTensor.select(-1, options.MixedScalingInputVariable).le(options.MixedScalingThreshold).unsqueeze(-1);
+    auto belowThresholdOutputTensor = outputTensor.clone();
+
+    belowThresholdOutputNormalizer.normalize(belowThresholdOutputTensor);
+    outputNormalizer.normalize(outputTensor);
+    outputTensor.copy_(torch::where(belowThreshold, belowThresholdOutputTensor, outputTensor));
   } else {
-    Utilities::DataProcessor::Denormalize(outputTensor, outputMinMax, 0.0, 1.0, limitValues);
+    outputNormalizer.normalize(outputTensor);
+  }
+  inputNormalizer.normalize(inputTensor);
+}
+
+inline void Logic::denormalizeInputTensor(torch::Tensor& tensor, bool limitValues) const
+{
+  inputNormalizer.denormalize(tensor, limitValues);
+}
+
+inline void Logic::denormalizeOutputTensor(torch::Tensor const& inputTensor, torch::Tensor& outputTensor, bool limitValues) const
+{
+  if (useMixedScaling) {
+    auto belowThreshold = mixedScalingMask(inputTensor);
+    auto belowThresholdOutputTensor = outputTensor.clone();
+
+    belowThresholdOutputNormalizer.denormalize(belowThresholdOutputTensor, limitValues);
+    outputNormalizer.denormalize(outputTensor, limitValues);
+    outputTensor.copy_(torch::where(belowThreshold, belowThresholdOutputTensor, outputTensor));
+  } else {
+    outputNormalizer.denormalize(outputTensor, limitValues);
   }
 }
 
@@ -521,19 +1298,25 @@ void Logic::unscaleOutputTensor(torch::Tensor const& inputTensor, torch::Tensor&
     Utilities::DataProcessor::UnscaleSquareRoot(outputTensor);
   }
   else if (options.LogLinScaling) {
-    if (inputTensor[options.MixedScalingInputVariable].item<TensorDataType>() <= normalizedMixedScalingThreshold) {
-      Utilities::DataProcessor::UnscaleLogarithmic(outputTensor);
-    }
+    auto logarithmicTensor = outputTensor.clone();
+    Utilities::DataProcessor::UnscaleLogarithmic(logarithmicTensor);
+
+    outputTensor.copy_(torch::where(mixedScalingMask(inputTensor), logarithmicTensor, outputTensor));
   }
   else if (options.LogSqrtScaling) {
-    if (inputTensor[options.MixedScalingInputVariable].item<TensorDataType>() <= normalizedMixedScalingThreshold) {
-      Utilities::DataProcessor::UnscaleLogarithmic(outputTensor);
-    } else {
-      Utilities::DataProcessor::UnscaleSquareRoot(outputTensor);
-    }
+    auto logarithmicTensor = outputTensor.clone();
+    Utilities::DataProcessor::UnscaleLogarithmic(logarithmicTensor);
+    Utilities::DataProcessor::UnscaleSquareRoot(outputTensor);
+
+    outputTensor.copy_(torch::where(mixedScalingMask(inputTensor), logarithmicTensor, outputTensor));
   }
 }
 
+torch::Tensor Logic::mixedScalingMask(torch::Tensor const& inputTensor) const
+{
+  return inputTensor.select(-1, options.MixedScalingInputVariable).le(normalizedMixedScalingThreshold).unsqueeze(-1);
+}
+
 bool Logic::minMaxValuesAreValid() const
 {
   auto validationFunction = [] (std::vector<std::pair<TensorDataType, TensorDataType>> const& data) {
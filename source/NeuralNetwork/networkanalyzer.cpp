@@ -1,150 +1,196 @@
 #include "NeuralNetwork/networkanalyzer.h"
+#include "Utilities/dataprocessor.h"
+
+#include <ATen/Parallel.h>
 
 namespace NeuralNetwork {
-  NetworkAnalyzer::NetworkAnalyzer(Network& network_, DenormalizeOutputTensorFunction denormFunction, UnscaleOutputTensorFunction unscaleFunction) :
-    network(network_), denormalizeOutputTensor(std::move(denormFunction)), unscaleOutputTensor(std::move(unscaleFunction))
-  {
-  }
 
-  double NetworkAnalyzer::calculateMeanSquaredError(DataVector const& testData)
-  {
-    double error = 0;
-    for (auto const& [x, y] : testData) {
-      auto prediction = network->forward(x);
-      auto loss = torch::mse_loss(prediction, y);
-      error += loss.item<double>();
-    }
-    return error / testData.size();
-  }
+namespace {
 
-  std::vector<double> NetworkAnalyzer::calculateR2Score(DataVector const& testData)
+const size_t EVALUATION_CHUNK_SIZE = 8192;
+const int64_t ERROR_ACCUMULATION_GRAIN_SIZE = 1024;
+
+/*
+ * Column-wise running mean and sum of squared deviations, merged chunk by chunk (Chan et al.).
+ */
+class ColumnMoments
+{
+public:
+  void add(torch::Tensor const& values)
   {
-    if (testData.empty()) {
-      return std::vector<double>();
+    auto chunkCount = values.size(0);
+    auto chunkMean = values.mean(0);
+    auto chunkM2 = (values - chunkMean).pow(2).sum(0);
+
+    if (count == 0) {
+      mean = chunkMean;
+      m2 = chunkM2;
+    } else {
+      auto totalCount = static_cast<double>(count + chunkCount);
+      auto delta = chunkMean - mean;
+      mean = mean + delta * (chunkCount / totalCount);
+      m2 = m2 + chunkM2 + delta.pow(2) * (static_cast<double>(count) * chunkCount / totalCount);
     }
+    count += chunkCount;
+  }
 
-    std::vector<double> scores{};
-
-    for (int64_t i = 0; i < testData[0].second.size(0); ++i) {
-      double SQE = 0.0;
-      double SQT = 0.0;
+  int64_t count = 0;
+  torch::Tensor mean{};
+  torch::Tensor m2{};
+};
 
-      TensorDataType y_cross = 0.0;
-      for (auto const& [x, y] : testData) {
-        (void) x;
-        y_cross += y[i].item<TensorDataType>();
-      }
-      y_cross /= testData.size();
-
-      for (auto const& [x, y] : testData) {
-        auto prediction = network->forward(x);
+std::vector<double> toVector(torch::Tensor const& tensor)
+{
+  auto contiguousTensor = tensor.to(torch::kDouble).contiguous();
+  auto const* begin = contiguousTensor.data_ptr<double>();
+  return std::vector<double>(begin, begin + contiguousTensor.numel());
+}
 
-        SQE += std::pow(prediction[i].item<TensorDataType>() - y_cross, 2.0);
-        SQT += std::pow(y[i].item<TensorDataType>() - y_cross, 2.0);
+/*
+ * Adds the errors of all values to the accumulators. Rows are processed in parallel, each thread uses its own accumulator.
+ */
+void accumulateErrors(torch::Tensor const& wantedValues, torch::Tensor const& actualValues, std::vector<Utilities::ErrorAccumulator>& accumulators)
+{
+  auto wanted = wantedValues.to(torch::kDouble).contiguous();
+  auto actual = actualValues.to(torch::kDouble).contiguous();
+  auto const* wantedData = wanted.data_ptr<double>();
+  auto const* actualData = actual.data_ptr<double>();
+  auto const numberOfColumns = wanted.size(1);
+
+  at::parallel_for(0, wanted.size(0), ERROR_ACCUMULATION_GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    auto& accumulator = accumulators[at::get_thread_num()];
+    for (int64_t row = begin; row < end; ++row) {
+      for (int64_t column = 0; column < numberOfColumns; ++column) {
+        accumulator.add(column, wantedData[row * numberOfColumns + column], actualData[row * numberOfColumns + column]);
       }
-
-      scores.push_back(SQE / SQT);
     }
+  });
+}
 
-    return scores;
+}
+
+  NetworkAnalyzer::NetworkAnalyzer(Network& network_, DenormalizeOutputTensorFunction denormFunction, UnscaleOutputTensorFunction unscaleFunction) :
+    network(network_), denormalizeOutputTensor(std::move(denormFunction)), unscaleOutputTensor(std::move(unscaleFunction))
+  {
   }
 
-  std::vector<double> NetworkAnalyzer::calculateR2ScoreAlternate(DataVector const& testData)
+  NetworkMetrics NetworkAnalyzer::calculateMetrics(DataVector const& testData, bool const calculateDenormalized)
   {
     if (testData.empty()) {
-      return std::vector<double>();
+      return NetworkMetrics{std::numeric_limits<double>::quiet_NaN(), {}, {}, {}};
     }
 
-    std::vector<double> scores{};
+    torch::NoGradGuard noGradGuard;
 
-    for (int64_t i = 0; i < testData[0].second.size(0); ++i) {
-      double SQR = 0.0;
-      double SQT = 0.0;
+    ColumnMoments targetMoments{};
+    ColumnMoments predictionMoments{};
+    ColumnMoments denormalizedTargetMoments{};
+    torch::Tensor squaredResiduals = torch::zeros(testData.front().second.size(0), torch::kDouble);
+    torch::Tensor denormalizedSquaredResiduals = squaredResiduals.clone();
 
-      TensorDataType y_cross = 0.0;
-      for (auto const& [x, y] : testData) {
-        (void) x;
-        y_cross += y[i].item<TensorDataType>();
-      }
-      y_cross /= testData.size();
+    for (size_t first = 0; first < testData.size(); first += EVALUATION_CHUNK_SIZE) {
+      auto last = std::min(first + EVALUATION_CHUNK_SIZE, testData.size());
+      auto [x, y] = Utilities::DataProcessor::StackData(DataVector(testData.begin() + first, testData.begin() + last));
+
+      auto prediction = network->forward(x).to(torch::kDouble);
+      auto target = y.to(torch::kDouble);
+
+      targetMoments.add(target);
+      predictionMoments.add(prediction);
+      squaredResiduals += (target - prediction).pow(2).sum(0);
+
+      if (calculateDenormalized) {
+        denormalizeOutputTensor(x, target, false);
+        denormalizeOutputTensor(x, prediction, false);
 
-      for (auto const& [x, y] : testData) {
-        auto prediction = network->forward(x);
-        TensorDataType yi = y[i].item<TensorDataType>();
+        unscaleOutputTensor(x, target);
+        unscaleOutputTensor(x, prediction);
 
-        SQR += std::pow(yi - prediction[i].item<TensorDataType>(), 2.0);
-        SQT += std::pow(yi - y_cross, 2.0);
+        denormalizedTargetMoments.add(target);
+        denormalizedSquaredResiduals += (target - prediction).pow(2).sum(0);
       }
+    }
+
+    auto numberOfValues = static_cast<double>(targetMoments.count * squaredResiduals.size(0));
+    auto squaredExplained = predictionMoments.m2 + (predictionMoments.mean - targetMoments.mean).pow(2) * static_cast<double>(predictionMoments.count);
 
-      scores.push_back(1.0 - (SQR / SQT));
+    NetworkMetrics metrics{};
+    metrics.meanSquaredError = squaredResiduals.sum().item<double>() / numberOfValues;
+    metrics.r2Score = toVector(squaredExplained / targetMoments.m2);
+    metrics.r2ScoreAlternate = toVector(1.0 - squaredResiduals / targetMoments.m2);
+    if (calculateDenormalized) {
+      metrics.r2ScoreAlternateDenormalized = toVector(1.0 - denormalizedSquaredResiduals / denormalizedTargetMoments.m2);
     }
 
-    return scores;
+    return metrics;
   }
 
-  std::vector<double> NetworkAnalyzer::calculateR2ScoreAlternateDenormalized(DataVector const& testData)
+  Utilities::ErrorReport NetworkAnalyzer::calculateErrorReport(DataVector const& testData)
   {
     if (testData.empty()) {
-      return std::vector<double>();
+      return Utilities::ErrorReport{};
     }
 
-    std::vector<double> scores{};
+    torch::NoGradGuard noGradGuard;
 
-    for (int64_t i = 0; i < testData[0].second.size(0); ++i) {
-      double SQR = 0.0;
-      double SQT = 0.0;
+    auto const numberOfColumns = static_cast<size_t>(testData.front().second.size(0));
+    auto const numberOfThreads = static_cast<size_t>(at::get_num_threads());
+    std::vector<Utilities::ErrorAccumulator> normalizedAccumulators(numberOfThreads, Utilities::ErrorAccumulator(numberOfColumns));
+    std::vector<Utilities::ErrorAccumulator> denormalizedAccumulators(numberOfThreads, Utilities::ErrorAccumulator(numberOfColumns));
 
-      TensorDataType y_cross = 0.0;
-      for (auto const& [x, y] : testData) {
-        auto yD = y.clone();
-        denormalizeOutputTensor(x, yD, false);
+    for (size_t first = 0; first < testData.size(); first += EVALUATION_CHUNK_SIZE) {
+      auto last = std::min(first + EVALUATION_CHUNK_SIZE, testData.size());
+      auto [x, y] = Utilities::DataProcessor::StackData(DataVector(testData.begin() + first, testData.begin() + last));
 
-        unscaleOutputTensor(x, yD);
+      auto prediction = network->forward(x).to(torch::kDouble);
+      auto target = y.to(torch::kDouble);
 
-        y_cross += yD[i].item<TensorDataType>();
-      }
-      y_cross /= testData.size();
+      accumulateErrors(target, prediction, normalizedAccumulators);
 
-      for (auto const& [x, y] : testData) {
-        auto prediction = network->forward(x);
-        auto yD = y.clone();
-        denormalizeOutputTensor(x, yD, false);
-        denormalizeOutputTensor(x, prediction, false);
+      denormalizeOutputTensor(x, target, false);
+      denormalizeOutputTensor(x, prediction, false);
 
-        unscaleOutputTensor(x, yD);
-        unscaleOutputTensor(x, prediction);
+      unscaleOutputTensor(x, target);
+      unscaleOutputTensor(x, prediction);
 
-        TensorDataType yi = yD[i].item<TensorDataType>();
-
-        SQR += std::pow(yi - prediction[i].item<TensorDataType>(), 2.0);
-        SQT += std::pow(yi - y_cross, 2.0);
-      }
+      accumulateErrors(target, prediction, denormalizedAccumulators);
+    }
 
-      scores.push_back(1.0 - (SQR / SQT));
+    for (size_t i = 1; i < numberOfThreads; ++i) {
+      normalizedAccumulators.front().merge(normalizedAccumulators[i]);
+      denormalizedAccumulators.front().merge(denormalizedAccumulators[i]);
     }
 
-    return scores;
+    return Utilities::ErrorReport{normalizedAccumulators.front().statistics(), denormalizedAccumulators.front().statistics()};
   }
 
-  torch::Tensor NetworkAnalyzer::calculateDiff(torch::Tensor const& wantedValue, torch::Tensor const& actualValue)
+  double NetworkAnalyzer::calculateMeanSquaredError(DataVector const& testData)
   {
-    auto output = wantedValue.clone();
+    return calculateMetrics(testData, false).meanSquaredError;
+  }
 
-    for (int64_t i = 0; i < wantedValue.size(0); ++i) {
-      output[i] -= actualValue[i].item<TensorDataType>();
-    }
+  std::vector<double> NetworkAnalyzer::calculateR2Score(DataVector const& testData)
+  {
+    return calculateMetrics(testData, false).r2Score;
+  }
 
-    return output;
+  std::vector<double> NetworkAnalyzer::calculateR2ScoreAlternate(DataVector const& testData)
+  {
+    return calculateMetrics(testData, false).r2ScoreAlternate;
   }
 
-  torch::Tensor NetworkAnalyzer::calculateRelativeDiff(torch::Tensor const& wantedValue, torch::Tensor const& actualValue)
+  std::vector<double> NetworkAnalyzer::calculateR2ScoreAlternateDenormalized(DataVector const& testData)
   {
-    auto diff = calculateDiff(wantedValue, actualValue);
+    return calculateMetrics(testData, true).r2ScoreAlternateDenormalized;
+  }
 
-    for (int64_t i = 0; i < wantedValue.size(0); ++i) {
-      diff[i] /= wantedValue[i].item<TensorDataType>();
-    }
+  torch::Tensor NetworkAnalyzer::calculateDiff(torch::Tensor const& wantedValue, torch::Tensor const& actualValue)
+  {
+    return wantedValue - actualValue;
+  }
 
-    return diff;
+  torch::Tensor NetworkAnalyzer::calculateRelativeDiff(torch::Tensor const& wantedValue, torch::Tensor const& actualValue)
+  {
+    return calculateDiff(wantedValue, actualValue) / wantedValue;
   }
 }
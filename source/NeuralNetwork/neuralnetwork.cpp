@@ -3,18 +3,24 @@
 
 namespace NeuralNetwork {
 
-NetworkImpl::NetworkImpl(uint32_t const numberOfInputNodes, uint32_t const numberOfOutputNode, std::vector<uint32_t> const& hiddenLayers)
+namespace {
+
+const std::string NETWORK_PRECISION_KEY = "precision";
+
+}
+
+NetworkImpl::NetworkImpl(uint32_t const numberOfInputNodes, uint32_t const numberOfOutputNode, std::vector<uint32_t> const& hiddenLayers, torch::ScalarType const dataType)
 {
   if (hiddenLayers.empty()) {
-    addLayer(0, numberOfInputNodes, numberOfOutputNode);
+    addLayer(0, numberOfInputNodes, numberOfOutputNode, dataType);
   } else {
-    addLayer(0, numberOfInputNodes, hiddenLayers[0]);
+    addLayer(0, numberOfInputNodes, hiddenLayers[0], dataType);
 
     for (size_t i = 1; i < hiddenLayers.size(); ++i) {
-      addLayer(i, hiddenLayers[i - 1], hiddenLayers[i]);
+      addLayer(i, hiddenLayers[i - 1], hiddenLayers[i], dataType);
     }
 
-    addLayer(hiddenLayers.size(), hiddenLayers[hiddenLayers.size() - 1], numberOfOutputNode);
+    addLayer(hiddenLayers.size(), hiddenLayers[hiddenLayers.size() - 1], numberOfOutputNode, dataType);
   }
 }
 
@@ -27,11 +33,67 @@ torch::Tensor NetworkImpl::forward(torch::Tensor x)
   return x;
 }
 
-void NetworkImpl::addLayer(size_t const layerNumber, uint32_t const numberOfInputNodes, uint32_t const numberOfOutputNodes)
+void NetworkImpl::addLayer(size_t const layerNumber, uint32_t const numberOfInputNodes, uint32_t const numberOfOutputNodes, torch::ScalarType const dataType)
 {
   layers.emplace_back(register_module("layer" + std::to_string(layerNumber),
     torch::nn::Sequential(torch::nn::Linear(numberOfInputNodes, numberOfOutputNodes), torch::nn::Functional(torch::leaky_relu, 0.2))));
-  layers[layerNumber]->to(TORCH_DATA_TYPE);
+  layers[layerNumber]->to(dataType);
+}
+
+void saveNetwork(Network const& network, FilePath const& filePath)
+{
+  torch::serialize::OutputArchive archive;
+  network->save(archive);
+  archive.write(NETWORK_PRECISION_KEY, torch::tensor(static_cast<int64_t>(network->parameters().front().scalar_type())));
+  archive.save_to(filePath);
+}
+
+torch::ScalarType loadNetwork(Network& network, FilePath const& filePath)
+{
+  torch::serialize::InputArchive archive;
+  archive.load_from(filePath);
+
+  auto trainedDataType = torch::kDouble;
+  torch::Tensor precision{};
+  if (archive.try_read(NETWORK_PRECISION_KEY, precision)) {
+    trainedDataType = static_cast<torch::ScalarType>(precision.item<int64_t>());
+  }
+
+  // The stored parameters can only be loaded into parameters of the same data type:
+  auto currentDataType = network->parameters().front().scalar_type();
+  network->to(trainedDataType);
+  network->load(archive);
+  network->to(currentDataType);
+
+  return trainedDataType;
+}
+
+std::vector<torch::Tensor> copyNetworkState(Network const& network)
+{
+  torch::NoGradGuard noGradGuard;
+  std::vector<torch::Tensor> state{};
+
+  for (auto const& parameter : network->parameters()) {
+    state.push_back(parameter.detach().clone());
+  }
+  for (auto const& buffer : network->buffers()) {
+    state.push_back(buffer.detach().clone());
+  }
+
+  return state;
+}
+
+void restoreNetworkState(Network& network, std::vector<torch::Tensor> const& state)
+{
+  torch::NoGradGuard noGradGuard;
+  size_t index = 0;
+
+  for (auto& parameter : network->parameters()) {
+    parameter.copy_(state.at(index++));
+  }
+  for (auto& buffer : network->buffers()) {
+    buffer.copy_(state.at(index++));
+  }
 }
 
 }
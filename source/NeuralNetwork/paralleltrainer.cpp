@@ -0,0 +1,301 @@
+#include "NeuralNetwork/paralleltrainer.h"
+#include "NeuralNetwork/learnratescheduler.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <numeric>
+
+namespace NeuralNetwork {
+
+namespace {
+
+/*
+ * Blocks all threads until the given number of threads arrived. Can be reused for multiple phases.
+ */
+class Barrier
+{
+public:
+  explicit Barrier(size_t numberOfThreads) : numberOfThreads(numberOfThreads), remaining(numberOfThreads) {}
+
+  void arriveAndWait()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    auto currentGeneration = generation;
+
+    if (--remaining == 0) {
+      ++generation;
+      remaining = numberOfThreads;
+      condition.notify_all();
+    } else {
+      condition.wait(lock, [&]() { return generation != currentGeneration; });
+    }
+  }
+
+private:
+  std::mutex mutex {};
+  std::condition_variable condition {};
+  size_t numberOfThreads;
+  size_t remaining;
+  uint64_t generation = 0;
+};
+
+}
+
+ParallelTrainer::ParallelTrainer(Network& network, torch::optim::Optimizer& optimizer, torch::Tensor const& inputs, torch::Tensor const& outputs,
+                                 torch::Tensor const& trainingRows, Utilities::ProgramOptions const& options, NetworkFactoryFunction const& createNetwork,
+                                 OptimizerFactoryFunction const& createOptimizer, uint64_t seed) :
+  mode(options.ParallelMode), batchSize(static_cast<int64_t>(options.MiniBatchSize.value_or(1))), shuffle(options.MiniBatchSize.has_value() || options.ShuffleData), seed(seed),
+  inputs(inputs), outputs(outputs)
+{
+  auto const rows = trainingRows.defined() ? trainingRows : torch::arange(inputs.size(0), torch::kLong);
+  auto const numberOfSamples = rows.size(0);
+  auto const numberOfWorkers = std::max<int64_t>(1, std::min<int64_t>(options.DataParallelWorkers, numberOfSamples));
+
+  // The first shards get one data point more, so the first worker always has the largest shard:
+  auto const shardSize = numberOfSamples / numberOfWorkers;
+  auto const remainder = numberOfSamples % numberOfWorkers;
+
+  auto masterParameters = network->parameters();
+  int64_t first = 0;
+
+  for (int64_t i = 0; i < numberOfWorkers; ++i) {
+    auto size = shardSize + ((i < remainder) ? 1 : 0);
+
+    Worker worker{};
+    worker.rows = rows.narrow(0, first, size);
+    first += size;
+
+    if (i == 0) {
+      worker.network = network;
+      worker.optimizer = &optimizer;
+    } else {
+      worker.network = createNetwork();
+      worker.network->train();
+
+      auto replicaParameters = worker.network->parameters();
+      torch::NoGradGuard noGradGuard;
+      for (size_t p = 0; p < masterParameters.size(); ++p) {
+        if (mode == Utilities::ParallelModeType::Hogwild) {
+          replicaParameters[p].set_data(masterParameters[p]);
+        } else {
+          replicaParameters[p].copy_(masterParameters[p]);
+        }
+      }
+
+      // Only Hogwild workers step on their own, but every replica keeps an optimizer, so the learning rate handling is the same:
+      worker.ownedOptimizer = createOptimizer(replicaParameters);
+      worker.optimizer = worker.ownedOptimizer.get();
+    }
+
+    workers.push_back(std::move(worker));
+  }
+
+  threads.reserve(workers.size() - 1);
+  for (size_t i = 1; i < workers.size(); ++i) {
+    threads.emplace_back(&ParallelTrainer::workerLoop, this, i);
+  }
+}
+
+ParallelTrainer::~ParallelTrainer()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  startCondition.notify_all();
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+double ParallelTrainer::trainEpoch(uint32_t const epoch)
+{
+  if (mode == Utilities::ParallelModeType::Hogwild) {
+    return trainEpochHogwild(epoch);
+  }
+
+  return trainEpochAllReduce(epoch);
+}
+
+void ParallelTrainer::setLearnRate(double const learnRate)
+{
+  // The first worker uses the optimizer of the caller, which sets the learning rate itself:
+  for (size_t i = 1; i < workers.size(); ++i) {
+    LearnRateScheduler::applyLearnRate(*workers[i].optimizer, learnRate);
+  }
+}
+
+double ParallelTrainer::trainEpochAllReduce(uint32_t const epoch)
+{
+  auto const numberOfWorkers = workers.size();
+  auto const numberOfSteps = (workers.front().rows.size(0) + batchSize - 1) / batchSize;
+
+  std::vector<torch::Tensor> orders(numberOfWorkers);
+  std::vector<std::vector<torch::Tensor>> parameters(numberOfWorkers);
+  for (size_t i = 0; i < numberOfWorkers; ++i) {
+    orders[i] = shardOrder(i, epoch);
+    parameters[i] = workers[i].network->parameters();
+  }
+
+  std::vector<double> errorSums(numberOfWorkers, 0.0);
+  std::vector<int64_t> batchRows(numberOfWorkers, 0);
+  Barrier barrier(numberOfWorkers);
+
+  auto reduceAndStep = [&]() {
+    auto totalRows = std::accumulate(batchRows.begin(), batchRows.end(), int64_t{0});
+    auto& masterParameters = parameters.front();
+
+    {
+      torch::NoGradGuard noGradGuard;
+      for (size_t p = 0; p < masterParameters.size(); ++p) {
+        auto masterGradient = masterParameters[p].grad();
+        masterGradient.mul_(static_cast<double>(batchRows.front()) / totalRows);
+
+        for (size_t i = 1; i < numberOfWorkers; ++i) {
+          if (batchRows[i] > 0) {
+            masterGradient.add_(parameters[i][p].grad(), static_cast<double>(batchRows[i]) / totalRows);
+          }
+        }
+      }
+    }
+
+    workers.front().optimizer->step();
+
+    torch::NoGradGuard noGradGuard;
+    for (size_t i = 1; i < numberOfWorkers; ++i) {
+      for (size_t p = 0; p < masterParameters.size(); ++p) {
+        parameters[i][p].copy_(masterParameters[p]);
+      }
+    }
+  };
+
+  runWorkers([&](size_t const i) {
+    auto& worker = workers[i];
+    auto const shardSize = worker.rows.size(0);
+    auto errorSum = torch::zeros({}, TORCH_DATA_TYPE);
+
+    for (int64_t step = 0; step < numberOfSteps; ++step) {
+      auto const first = step * batchSize;
+      batchRows[i] = std::max<int64_t>(0, std::min(batchSize, shardSize - first));
+
+      worker.optimizer->zero_grad();
+
+      if (batchRows[i] > 0) {
+        auto batchIndices = orders[i].narrow(0, first, batchRows[i]);
+        auto x = inputs.index_select(0, batchIndices);
+        auto y = outputs.index_select(0, batchIndices);
+
+        auto prediction = worker.network->forward(x);
+        auto loss = torch::mse_loss(prediction, y);
+        errorSum += loss.detach().to(TORCH_DATA_TYPE) * batchRows[i];
+
+        loss.backward();
+      }
+
+      // All gradients are ready, the first worker averages them and updates the parameters of all replicas:
+      barrier.arriveAndWait();
+      if (i == 0) {
+        reduceAndStep();
+      }
+      barrier.arriveAndWait();
+    }
+
+    errorSums[i] = errorSum.item<double>();
+  });
+
+  return std::accumulate(errorSums.begin(), errorSums.end(), 0.0);
+}
+
+double ParallelTrainer::trainEpochHogwild(uint32_t const epoch)
+{
+  auto const numberOfWorkers = workers.size();
+
+  std::vector<torch::Tensor> orders(numberOfWorkers);
+  for (size_t i = 0; i < numberOfWorkers; ++i) {
+    orders[i] = shardOrder(i, epoch);
+  }
+
+  std::vector<double> errorSums(numberOfWorkers, 0.0);
+
+  runWorkers([&](size_t const i) {
+    auto& worker = workers[i];
+    auto const shardSize = worker.rows.size(0);
+    auto errorSum = torch::zeros({}, TORCH_DATA_TYPE);
+
+    for (int64_t first = 0; first < shardSize; first += batchSize) {
+      auto batchIndices = orders[i].narrow(0, first, std::min(batchSize, shardSize - first));
+      auto x = inputs.index_select(0, batchIndices);
+      auto y = outputs.index_select(0, batchIndices);
+
+      auto prediction = worker.network->forward(x);
+      auto loss = torch::mse_loss(prediction, y);
+      errorSum += loss.detach().to(TORCH_DATA_TYPE) * x.size(0);
+
+      worker.optimizer->zero_grad();
+
+      loss.backward();
+      worker.optimizer->step();
+    }
+
+    errorSums[i] = errorSum.item<double>();
+  });
+
+  return std::accumulate(errorSums.begin(), errorSums.end(), 0.0);
+}
+
+torch::Tensor ParallelTrainer::shardOrder(size_t const worker, uint32_t const epoch) const
+{
+  auto const& rows = workers[worker].rows;
+
+  if (!shuffle) {
+    return rows;
+  }
+
+  return epochPermutation(rows, seed, epoch, static_cast<uint32_t>(worker));
+}
+
+void ParallelTrainer::runWorkers(std::function<void(size_t)> const& function)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    task = &function;
+    unfinishedWorkers = threads.size();
+    ++taskGeneration;
+  }
+  startCondition.notify_all();
+
+  function(0);
+
+  std::unique_lock<std::mutex> lock(mutex);
+  finishCondition.wait(lock, [&]() { return unfinishedWorkers == 0; });
+  task = nullptr;
+}
+
+void ParallelTrainer::workerLoop(size_t const worker)
+{
+  uint64_t finishedGeneration = 0;
+
+  while (true) {
+    std::function<void(size_t)> const* currentTask = nullptr;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      startCondition.wait(lock, [&]() { return stopping || taskGeneration != finishedGeneration; });
+      if (stopping) {
+        return;
+      }
+      finishedGeneration = taskGeneration;
+      currentTask = task;
+    }
+
+    (*currentTask)(worker);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (--unfinishedWorkers == 0) {
+      finishCondition.notify_one();
+    }
+  }
+}
+
+}
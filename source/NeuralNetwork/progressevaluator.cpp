@@ -0,0 +1,76 @@
+#include "NeuralNetwork/progressevaluator.h"
+
+namespace NeuralNetwork {
+
+namespace {
+
+const size_t MAXIMUM_QUEUED_EVALUATIONS = 2;
+
+}
+
+ProgressEvaluator::ProgressEvaluator(Network network_, DataVector const& data) :
+  network(std::move(network_)),
+  analyzer(network, [](torch::Tensor const&, torch::Tensor&, bool) {}, [](torch::Tensor const&, torch::Tensor&) {}), // only normalized metrics are needed
+  data(data)
+{
+  worker = std::thread(&ProgressEvaluator::evaluateInBackground, this);
+}
+
+ProgressEvaluator::~ProgressEvaluator()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopped = true;
+  }
+  condition.notify_all();
+  worker.join();
+}
+
+void ProgressEvaluator::evaluate(LearnProgressDataSet entry, std::vector<torch::Tensor> networkState)
+{
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [&]() { return queuedEvaluations.size() < MAXIMUM_QUEUED_EVALUATIONS; });
+    queuedEvaluations.emplace_back(std::move(entry), std::move(networkState));
+  }
+  condition.notify_all();
+}
+
+void ProgressEvaluator::collect(ProgressVector& progress)
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  condition.wait(lock, [&]() { return queuedEvaluations.empty() && !evaluating; });
+
+  progress.insert(progress.end(), evaluatedEntries.begin(), evaluatedEntries.end());
+  evaluatedEntries.clear();
+}
+
+void ProgressEvaluator::evaluateInBackground()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+
+  while (true) {
+    condition.wait(lock, [&]() { return stopped || !queuedEvaluations.empty(); });
+    if (queuedEvaluations.empty()) {
+      return;
+    }
+
+    auto [entry, networkState] = std::move(queuedEvaluations.front());
+    queuedEvaluations.pop_front();
+    evaluating = true;
+    lock.unlock();
+    condition.notify_all();
+
+    restoreNetworkState(network, networkState);
+    auto metrics = analyzer.calculateMetrics(data, false);
+    entry.meanSquaredError = metrics.meanSquaredError;
+    entry.r2Score = metrics.r2ScoreAlternate;
+
+    lock.lock();
+    evaluatedEntries.push_back(std::move(entry));
+    evaluating = false;
+    condition.notify_all();
+  }
+}
+
+}
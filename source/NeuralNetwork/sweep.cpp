@@ -0,0 +1,439 @@
+#include "NeuralNetwork/sweep.h"
+#include "Utilities/dataprocessor.h"
+#include "Utilities/fileparser.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <random>
+#include <thread>
+
+namespace NeuralNetwork {
+
+namespace {
+
+const std::string NO_MINI_BATCH = "none";
+
+/*
+ * Data of one scaling mode, which all trials with this scaling mode share.
+ */
+struct PreparedData
+{
+  std::unique_ptr<Logic> preparer {nullptr};
+  DataVector data {};
+  std::optional<SharedTrainingData> stackedData {}; // only stacked if a trial trains on stacked data
+};
+
+[[nodiscard]]
+std::string scalingName(Utilities::ProgramOptions const& options)
+{
+  if (options.LogScaling) {
+    return "log";
+  }
+  if (options.SqrtScaling) {
+    return "sqrt";
+  }
+  if (options.LogLinScaling) {
+    return "loglin";
+  }
+  if (options.LogSqrtScaling) {
+    return "logsqrt";
+  }
+  return "none";
+}
+
+[[nodiscard]]
+std::string optimizerName(Utilities::OptimizerType const optimizer)
+{
+  for (auto const& [name, type] : Utilities::OptimizerTypeMap) {
+    if (type == optimizer) {
+      return name;
+    }
+  }
+  return {};
+}
+
+/*
+ * Sets the given value of the sweep parameter in the given options. Returns false if the parameter or the value is unknown.
+ */
+[[nodiscard]]
+bool applySweepValue(Utilities::ProgramOptions& options, std::string const& parameter, std::string const& value)
+{
+  try {
+    if (parameter == "layers") {
+      options.NumberOfLayers = std::stoul(value);
+    } else if (parameter == "nodes") {
+      options.NumberOfNodesPerLayer = std::stoul(value);
+    } else if (parameter == "learnRate") {
+      options.LearnRate = std::stod(value);
+      options.LearnRateSet = true;
+    } else if (parameter == "miniBatch") {
+      options.MiniBatchSize = (value == NO_MINI_BATCH) ? std::nullopt : std::make_optional<uint32_t>(std::stoul(value));
+    } else if (parameter == "optimizer") {
+      auto optimizer = Utilities::OptimizerTypeMap.find(value);
+      if (optimizer == Utilities::OptimizerTypeMap.end()) {
+        std::cout << "Unknown optimizer in the sweep specification: " << value << ". Available optimizers: sgd, momentum, adam, rmsprop, lbfgs" << std::endl;
+        return false;
+      }
+      options.Optimizer = optimizer->second;
+    } else if (parameter == "scaling") {
+      if (value != "none" && value != "log" && value != "sqrt" && value != "loglin" && value != "logsqrt") {
+        std::cout << "Unknown scaling in the sweep specification: " << value << ". Available scalings: none, log, sqrt, loglin, logsqrt" << std::endl;
+        return false;
+      }
+      options.LogScaling = value == "log";
+      options.SqrtScaling = value == "sqrt";
+      options.LogLinScaling = value == "loglin";
+      options.LogSqrtScaling = value == "logsqrt";
+    } else {
+      std::cout << "Unknown parameter in the sweep specification: " << parameter << ". Available parameters: layers, nodes, learnRate, scaling, optimizer, miniBatch" << std::endl;
+      return false;
+    }
+  } catch (std::exception const&) {
+    std::cout << "Could not parse the value " << value << " of the sweep parameter " << parameter << "." << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+/*
+ * Checks the combinations of options which can be different between the trials. Returns false if the trial options are invalid.
+ */
+[[nodiscard]]
+bool trialOptionsAreValid(Utilities::ProgramOptions const& options, Utilities::ProgramOptions const& userOptions)
+{
+  if (options.NumberOfLayers == 0 || options.NumberOfNodesPerLayer == 0 || options.NumberOfLayers * options.NumberOfNodesPerLayer > MaxNumberOfNodes) {
+    std::cout << "Invalid network size in the sweep specification: " << options.NumberOfLayers << " layers with " << options.NumberOfNodesPerLayer <<
+                 " nodes. The total number of nodes should be between 1 and " << MaxNumberOfNodes << "." << std::endl;
+    return false;
+  }
+
+  if (options.LearnRate <= 0.0) {
+    std::cout << "Invalid learning rate in the sweep specification: " << options.LearnRate << ". The value should be > 0." << std::endl;
+    return false;
+  }
+
+  if (options.MiniBatchSize.has_value() && (options.MiniBatchSize.value() == 0 || options.BatchVariable.has_value())) {
+    std::cout << "Invalid mini-batch size in the sweep specification. The value should be > 0 and can not be combined with batch training." << std::endl;
+    return false;
+  }
+
+  if (options.Optimizer == Utilities::OptimizerType::LBFGS && (options.MiniBatchSize.has_value() || options.BatchVariable.has_value())) {
+    std::cout << "The lbfgs optimizer in the sweep specification can not be combined with mini-batch or batch training." << std::endl;
+    return false;
+  }
+
+  // The input variable and threshold of the mixed scaling can only be set on the command line:
+  if ((options.LogLinScaling || options.LogSqrtScaling) && !userOptions.LogLinScaling && !userOptions.LogSqrtScaling) {
+    std::cout << "The mixed scalings in the sweep specification need the input variable and threshold of --logLinScaling or --logSqrtScaling." << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+/*
+ * Deep copy of the given data, so it can be scaled and normalized independently of the original data.
+ */
+[[nodiscard]]
+DataVector cloneData(DataVector const& data)
+{
+  DataVector clonedData{};
+  if (data.empty()) {
+    return clonedData;
+  }
+  clonedData.reserve(data.size());
+
+  // The cloned data points are rows of two tensors, so they can be normalized at once (see DataProcessor::BatchView):
+  auto [inputs, outputs] = Utilities::DataProcessor::StackData(data);
+  auto inputRows = inputs.unbind(0);
+  auto outputRows = outputs.unbind(0);
+  for (size_t i = 0; i < inputRows.size(); ++i) {
+    clonedData.emplace_back(inputRows[i], outputRows[i]);
+  }
+
+  return clonedData;
+}
+
+}
+
+bool Sweep::performSweep(Utilities::ProgramOptions const& user_options)
+{
+  options = user_options;
+
+  auto specification = Utilities::FileParser::ParseSweepSpecification(options.SweepSpecificationFilePath);
+  if (!specification) {
+    return false;
+  }
+
+  auto trialOptions = createTrialOptions(*specification);
+  if (!trialOptions) {
+    return false;
+  }
+
+  if (options.DebugOutput) {
+    std::cout << "Read input file..." << std::endl;
+  }
+  std::string inputFileHeader{};
+  Utilities::DataStatistics statistics{};
+  auto dataOpt = Utilities::FileParser::LoadInputData(options, inputFileHeader, statistics);
+  if (!dataOpt) {
+    return false;
+  }
+
+  torch::set_num_threads(options.NumberOfThreads);
+
+  // The data is scaled and normalized once per scaling mode. All trials with the same scaling mode share the prepared data:
+  std::map<std::string, PreparedData> preparedData{};
+  for (auto const& trialOption : *trialOptions) {
+    auto& [preparer, data, stackedData] = preparedData[scalingName(trialOption)];
+    if (preparer) {
+      continue;
+    }
+
+    if (options.DebugOutput) {
+      std::cout << "Prepare data for scaling " << scalingName(trialOption) << "..." << std::endl;
+    }
+
+    auto preparerOptions = trialOption;
+    preparerOptions.OutputMinMaxFilePath = Utilities::DefaultValues::OUTPUT_MIN_MAX_FILE_PATH;
+
+    preparer = std::make_unique<Logic>();
+    data = cloneData(*dataOpt);
+    if (!preparer->prepareData(preparerOptions, data, statistics)) {
+      return false;
+    }
+  }
+  dataOpt.reset();
+
+  // The prepared data is stacked only once per scaling mode, the trials train their rows of the shared tensors:
+  for (auto const& trialOption : *trialOptions) {
+    auto& [preparer, data, stackedData] = preparedData[scalingName(trialOption)];
+    if (!stackedData && Logic::trainsOnStackedData(trialOption)) {
+      stackedData = SharedTrainingData{};
+      std::tie(stackedData->inputs, stackedData->outputs) = Utilities::DataProcessor::StackData(data);
+    }
+  }
+
+  if (options.DebugOutput) {
+    std::cout << "Prepare " << trialOptions->size() << " trials..." << std::endl;
+  }
+
+  trials.clear();
+  trials.reserve(trialOptions->size());
+  for (auto const& trialOption : *trialOptions) {
+    auto const& [preparer, data, stackedData] = preparedData[scalingName(trialOption)];
+
+    Trial trial{};
+    trial.options = trialOption;
+    trial.logic = std::make_unique<Logic>();
+    trial.logic->adoptDataPreparation(*preparer);
+    if (!trial.logic->prepareTraining(trial.options, data, std::nullopt, stackedData)) {
+      return false;
+    }
+
+    trials.push_back(std::move(trial));
+  }
+
+  // Successive halving:
+  std::vector<Trial*> remainingTrials{};
+  for (auto& trial : trials) {
+    remainingTrials.push_back(&trial);
+  }
+
+  auto lastEpoch = std::min(options.SweepRungEpochs, options.NumberOfEpochs);
+  for (uint32_t round = 1; !remainingTrials.empty(); ++round) {
+    bool isLastRound = remainingTrials.size() == 1 || lastEpoch >= options.NumberOfEpochs;
+
+    if (options.ShowProgressDuringTraining) {
+      std::cout << "Round " << round << ": train " << remainingTrials.size() << " trials" << (isLastRound ? " until the end" : " until epoch " + std::to_string(lastEpoch)) << "..." << std::endl;
+    }
+
+    trainTrials(remainingTrials, isLastRound ? options.NumberOfEpochs : lastEpoch, isLastRound);
+
+    std::stable_sort(remainingTrials.begin(), remainingTrials.end(), [](Trial const* lhs, Trial const* rhs) { return lhs->error < rhs->error; });
+
+    if (isLastRound) {
+      break;
+    }
+
+    // Stopped trials can not be continued and do not take a place of the continuing trials. Early stopped trials finished their training
+    // and compete with their final error, trials stopped by a timeout or NaN keep the rank of this round:
+    for (auto* trial : remainingTrials) {
+      if (trial->trainingStopped && !trial->finished) {
+        trial->logic.reset();
+      }
+    }
+    remainingTrials.erase(std::remove_if(remainingTrials.begin(), remainingTrials.end(), [](Trial const* trial) { return trial->trainingStopped; }),
+                          remainingTrials.end());
+
+    // Only the better half continues:
+    auto const numberOfContinuingTrials = (remainingTrials.size() + 1) / 2;
+    for (auto trial = remainingTrials.begin() + static_cast<ptrdiff_t>(numberOfContinuingTrials); trial != remainingTrials.end(); ++trial) {
+      (*trial)->logic.reset();
+    }
+    remainingTrials.resize(numberOfContinuingTrials);
+
+    lastEpoch = std::min(lastEpoch * 2, options.NumberOfEpochs);
+  }
+
+  torch::set_num_threads(options.NumberOfThreads);
+
+  // Finished trials are ranked by their errors and are better than all sorted out trials. A trial which was trained in more rounds
+  // is better than all trials which were sorted out before:
+  std::vector<Trial*> rankedTrials{};
+  for (auto& trial : trials) {
+    rankedTrials.push_back(&trial);
+  }
+  std::stable_sort(rankedTrials.begin(), rankedTrials.end(), [](Trial const* lhs, Trial const* rhs) {
+    if (lhs->finished != rhs->finished) {
+      return lhs->finished;
+    }
+    return (!lhs->finished && lhs->numberOfRounds != rhs->numberOfRounds) ? lhs->numberOfRounds > rhs->numberOfRounds : lhs->error < rhs->error;
+  });
+
+  SweepResultVector results{};
+  std::cout << "\nSweep results:" << std::endl;
+  for (size_t i = 0; i < rankedTrials.size(); ++i) {
+    auto& result = rankedTrials[i]->result;
+    result.rank = static_cast<uint32_t>(i + 1);
+    results.push_back(result);
+
+    std::cout << result.rank << ". layers: " << result.numberOfLayers << ", nodes: " << result.numberOfNodesPerLayer << ", learnRate: " << result.learnRate <<
+                 ", scaling: " << result.scaling << ", optimizer: " << result.optimizer <<
+                 ", miniBatch: " << (result.miniBatchSize ? std::to_string(*result.miniBatchSize) : NO_MINI_BATCH) << " -- epochs: " << result.epochs <<
+                 ", mean squared error: " << result.meanSquaredError;
+    if (options.ValidateAfterTraining) {
+      std::cout << ", validation: " << result.validationMeanSquaredError;
+    }
+    std::cout << std::endl;
+  }
+
+  if (options.SweepResultFilePath != Utilities::DefaultValues::SWEEP_RESULT_FILE_PATH) {
+    Utilities::FileParser::SaveSweepResults(results, options.SweepResultFilePath, options.ValidateAfterTraining);
+  }
+
+  auto const& bestTrial = *rankedTrials.front();
+  if (bestTrial.logic) {
+    if (options.OutputNetworkParameters != Utilities::DefaultValues::OUTPUT_NETWORK_PARAMETERS) {
+      saveNetwork(bestTrial.logic->getNetwork(), options.OutputNetworkParameters);
+    }
+    if (options.OutputMinMaxFilePath != Utilities::DefaultValues::OUTPUT_MIN_MAX_FILE_PATH) {
+      bestTrial.logic->saveMinMaxToFile();
+    }
+  }
+
+  return true;
+}
+
+std::optional<std::vector<Utilities::ProgramOptions>> Sweep::createTrialOptions(SweepSpecification const& specification) const
+{
+  // The trials are trained concurrently and quietly, every trial trains in a single worker without checkpoints:
+  auto baseOptions = options;
+  baseOptions.ShowProgressDuringTraining = false;
+  baseOptions.DebugOutput = false;
+  baseOptions.DataParallelWorkers = 1;
+  baseOptions.CheckpointInterval = std::nullopt;
+  baseOptions.SaveProgressFilePath = Utilities::DefaultValues::PROGRESS_FILE_PATH;
+  baseOptions.RNGSeed = options.RNGSeed.value_or(std::random_device{}()); // the same validation split and initialization for all trials
+
+  std::vector<Utilities::ProgramOptions> trialOptions{baseOptions};
+
+  for (auto const& [parameter, values] : specification) {
+    std::vector<Utilities::ProgramOptions> combinedOptions{};
+    combinedOptions.reserve(trialOptions.size() * values.size());
+
+    for (auto const& trialOption : trialOptions) {
+      for (auto const& value : values) {
+        auto combinedOption = trialOption;
+        if (!applySweepValue(combinedOption, parameter, value)) {
+          return std::nullopt;
+        }
+        combinedOptions.push_back(combinedOption);
+      }
+    }
+
+    trialOptions = std::move(combinedOptions);
+  }
+
+  // Like on the command line, trials without a given learning rate use the default learning rate of their optimizer:
+  for (auto& trialOption : trialOptions) {
+    if (!trialOption.LearnRateSet) {
+      trialOption.LearnRate = (trialOption.Optimizer == Utilities::OptimizerType::LBFGS) ? Utilities::DefaultValues::LBFGS_LEARN_RATE
+                                                                                          : Utilities::DefaultValues::LEARN_RATE;
+    }
+  }
+
+  for (auto const& trialOption : trialOptions) {
+    if (!trialOptionsAreValid(trialOption, options)) {
+      return std::nullopt;
+    }
+  }
+
+  return std::make_optional(trialOptions);
+}
+
+void Sweep::trainTrials(std::vector<Trial*> const& trialsToTrain, uint32_t const lastEpoch, bool const isLastRound)
+{
+  std::atomic<size_t> nextTrial{0};
+
+  auto trainRemainingTrials = [&]() {
+    for (auto i = nextTrial++; i < trialsToTrain.size(); i = nextTrial++) {
+      auto& trial = *trialsToTrain[i];
+      trial.trainingStopped = !trial.logic->train(lastEpoch, isLastRound);
+      trial.finished = isLastRound || trial.logic->stoppedByValidation();
+      trial.logic->pauseTraining();
+      ++trial.numberOfRounds;
+      evaluateTrial(trial, isLastRound || trial.trainingStopped);
+    }
+  };
+
+  // The intra-op threads of torch are a global setting, so they are only divided between the concurrently trained trials before a round starts.
+  // Every round divides them anew, so the fewer trials of the later rounds get more threads:
+  auto const numberOfThreads = std::min<size_t>(options.SweepParallelTrials, trialsToTrain.size());
+  torch::set_num_threads(std::max(1, options.NumberOfThreads / static_cast<int32_t>(numberOfThreads)));
+
+  std::vector<std::thread> threads{};
+  for (size_t i = 1; i < numberOfThreads; ++i) {
+    threads.emplace_back(trainRemainingTrials);
+  }
+
+  trainRemainingTrials();
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+void Sweep::evaluateTrial(Trial& trial, bool const trainingFinished) const
+{
+  auto& logic = *trial.logic;
+
+  // Restores the weights with the lowest validation error, if the user activated early stopping:
+  if (trainingFinished) {
+    logic.finishTraining();
+  }
+
+  auto& result = trial.result;
+  result.numberOfLayers = trial.options.NumberOfLayers;
+  result.numberOfNodesPerLayer = trial.options.NumberOfNodesPerLayer;
+  result.learnRate = trial.options.LearnRate;
+  result.scaling = scalingName(trial.options);
+  result.optimizer = optimizerName(trial.options.Optimizer);
+  result.miniBatchSize = trial.options.MiniBatchSize;
+  result.epochs = logic.numberOfTrainedEpochs();
+  result.meanSquaredError = logic.trainingMeanSquaredError();
+  result.validationMeanSquaredError = options.ValidateAfterTraining ? logic.validationMeanSquaredError() : std::numeric_limits<double>::quiet_NaN();
+
+  // NaN errors (diverged trials) are ranked last:
+  trial.error = options.ValidateAfterTraining ? result.validationMeanSquaredError : result.meanSquaredError;
+  if (std::isnan(trial.error)) {
+    trial.error = std::numeric_limits<double>::infinity();
+  }
+}
+
+}
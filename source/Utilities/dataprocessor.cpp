@@ -1,56 +1,74 @@
 #include "Utilities/dataprocessor.h"
-#include "Utilities/datasplitter.h"
 #include "Utilities/fileparser.h"
 
+#include <algorithm>
+
 namespace Utilities {
 
 namespace {
 
 const TensorDataType MINIMUM_ALLOWED_VALUE = 1e-30;
 
+/*
+ * Returns a view [rows, columns] on the given rows if they are contiguous, equally spaced and non-overlapping rows of the same storage.
+ */
+std::optional<torch::Tensor> rowsView(std::vector<torch::Tensor const*> const& rows)
+{
+  auto const& firstRow = *rows.front();
+  if (firstRow.dim() != 1 || (firstRow.numel() > 1 && firstRow.stride(0) != 1)) {
+    return std::nullopt;
+  }
+
+  auto const numberOfColumns = firstRow.size(0);
+  auto const firstOffset = firstRow.storage_offset();
+  auto const rowStride = (rows.size() > 1) ? rows[1]->storage_offset() - firstOffset : numberOfColumns;
+  if (rowStride < std::max<int64_t>(numberOfColumns, 1)) {
+    return std::nullopt;
+  }
+
+  for (size_t i = 1; i < rows.size(); ++i) {
+    auto const& row = *rows[i];
+    if (row.dim() != 1 || row.size(0) != numberOfColumns || row.scalar_type() != firstRow.scalar_type() || (numberOfColumns > 1 && row.stride(0) != 1) ||
+        !row.is_alias_of(firstRow) || row.storage_offset() != firstOffset + static_cast<int64_t>(i) * rowStride) {
+      return std::nullopt;
+    }
+  }
+
+  return std::make_optional(firstRow.as_strided({static_cast<int64_t>(rows.size()), numberOfColumns}, {rowStride, 1}, firstOffset));
+}
+
 }
 
 void DataProcessor::CalculateMinMax(DataVector const& data, MinMaxValues& minMaxVectors)
 {
   if (data.empty()) return;
-  auto& inputMinMax = minMaxVectors.first;
-  auto& outputMinMax = minMaxVectors.second;
-  auto numberOfInputNodes = data.front().first.size(0);
-  auto numberOfOutputNodes = data.front().second.size(0);
-
-  // Initialize minMaxVectors:
-  inputMinMax = MinMaxVector(numberOfInputNodes, std::make_pair(std::numeric_limits<TensorDataType>::max(), std::numeric_limits<TensorDataType>::lowest()));
-  outputMinMax = MinMaxVector(numberOfOutputNodes, std::make_pair(std::numeric_limits<TensorDataType>::max(), std::numeric_limits<TensorDataType>::lowest()));
-
-  // Calculate min and max:
-  for (auto& [inputTensor, outputTensor] : data) {
-    for (int64_t i = 0; i < numberOfInputNodes; ++i) {
-      inputMinMax[i].first = std::min(inputMinMax[i].first, inputTensor[i].item<TensorDataType>());
-      inputMinMax[i].second = std::max(inputMinMax[i].second, inputTensor[i].item<TensorDataType>());
-    }
 
-    for (int64_t i = 0; i < numberOfOutputNodes; ++i) {
-      outputMinMax[i].first = std::min(outputMinMax[i].first, outputTensor[i].item<TensorDataType>());
-      outputMinMax[i].second = std::max(outputMinMax[i].second, outputTensor[i].item<TensorDataType>());
-    }
-  }
+  minMaxVectors = CollectStatistics(data).minMax();
 }
 
 void DataProcessor::CalculateMixedMinMax(DataVector const& data, uint32_t thresholdVariable, TensorDataType threshold, MixedMinMaxValues& mixedMinMaxValues)
 {
   mixedMinMaxValues = std::make_pair(MinMaxValues(), MinMaxValues());
+  if (data.empty()) return;
 
-  auto splitData = DataSplitter::splitDataWithThreshold(data, thresholdVariable, threshold);
+  // The input min/max values are the same for both parts, only the output min/max values are split:
+  mixedMinMaxValues = CollectStatistics(data, ScalingThreshold{thresholdVariable, threshold}).mixedMinMax();
+}
 
-  CalculateMinMax(splitData.first, mixedMinMaxValues.first);
-  CalculateMinMax(splitData.second, mixedMinMaxValues.second);
+DataStatistics DataProcessor::CollectStatistics(DataVector const& data, std::optional<ScalingThreshold> const scalingThreshold)
+{
+  if (data.empty()) {
+    return DataStatistics(0, 0, scalingThreshold);
+  }
 
-  // Only split min/max values for the output tensor:
-  MinMaxValues globalMinMax{};
+  DataStatistics statistics(static_cast<uint32_t>(data.front().first.size(0)), static_cast<uint32_t>(data.front().second.size(0)), scalingThreshold);
+  for (auto const& [inputTensor, outputTensor] : data) {
+    auto const inputValues = inputTensor.to(TORCH_DATA_TYPE).contiguous();
+    auto const outputValues = outputTensor.to(TORCH_DATA_TYPE).contiguous();
+    statistics.addRow(inputValues.data_ptr<TensorDataType>(), outputValues.data_ptr<TensorDataType>());
+  }
 
-  CalculateMinMax(data, globalMinMax);
-  mixedMinMaxValues.first.first = globalMinMax.first;
-  mixedMinMaxValues.second.first = globalMinMax.first;
+  return statistics;
 }
 
 std::optional<MinMaxValues> DataProcessor::GetMinMaxFromFile(FilePath const& filePath, uint32_t numberOfInputVariables, uint32_t numberOfOutputVariables)
@@ -136,68 +154,109 @@ void DataProcessor::Normalize(DataVector& data, std::pair<MinMaxVector const, Mi
   auto const& inputMinMax = minMaxVectors.first;
   auto const& outputMinMax = minMaxVectors.second;
 
+  Normalize(data, Normalizer(inputMinMax, newMinValue, newMaxValue), Normalizer(outputMinMax, newMinValue, newMaxValue));
+}
+
+void DataProcessor::Normalize(DataVector& data, Normalizer const& inputNormalizer, Normalizer const& outputNormalizer)
+{
+  if (auto batch = BatchView(data)) {
+    inputNormalizer.normalize(batch->first);
+    outputNormalizer.normalize(batch->second);
+    return;
+  }
+
   for (auto& [inputTensor, outputTensor] : data) {
-    Normalize(inputTensor, inputMinMax, newMinValue, newMaxValue);
-    Normalize(outputTensor, outputMinMax, newMinValue, newMaxValue);
+    inputNormalizer.normalize(inputTensor);
+    outputNormalizer.normalize(outputTensor);
   }
 }
 
 void DataProcessor::Normalize(torch::Tensor& tensor, MinMaxVector const& minMaxVector, TensorDataType const newMinValue, TensorDataType const newMaxValue)
 {
-  // Normalize data -- use '(X - min) / (max - min)' to get values between 0 and 1:
-  for (int64_t i = 0; i < tensor.size(0); ++i) {
-    TensorDataType normalizationFactor = newMaxValue - newMinValue;
-    tensor[i] = ((tensor[i].item<TensorDataType>() - minMaxVector[i].first) / (minMaxVector[i].second - minMaxVector[i].first)) * normalizationFactor + newMinValue;
-  }
+  Normalizer(minMaxVector, newMinValue, newMaxValue).normalize(tensor);
 }
 
 void DataProcessor::Denormalize(torch::Tensor& tensor, MinMaxVector const& minMaxVector, TensorDataType const oldMinValue, TensorDataType const oldMaxValue, bool const limitValues)
 {
-  if (tensor.size(0) != static_cast<int64_t>(minMaxVector.size())) {
+  Normalizer(minMaxVector, oldMinValue, oldMaxValue).denormalize(tensor, limitValues);
+}
+
+void DataProcessor::ConvertDataType(DataVector& data, torch::ScalarType const dataType)
+{
+  if (data.empty()) {
     return;
   }
 
-  TensorDataType normalizationFactor = oldMaxValue - oldMinValue;
-  for (size_t i = 0; i < minMaxVector.size(); ++i) {
-    if (limitValues) {
-      tensor[i] = std::max(oldMinValue, (std::min(oldMaxValue, tensor[i].item<TensorDataType>())));
-    }
-    tensor[i] = (((tensor[i] - oldMinValue) / normalizationFactor) * (minMaxVector[i].second - minMaxVector[i].first)) + minMaxVector[i].first;
+  // The data is converted in one operation per tensor, the rows of the converted data are views of the converted tensors again:
+  auto batch = BatchView(data);
+  auto [inputs, outputs] = batch ? std::move(*batch) : StackData(data);
+  auto inputRows = inputs.to(dataType).unbind(0);
+  auto outputRows = outputs.to(dataType).unbind(0);
+
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = std::make_pair(std::move(inputRows[i]), std::move(outputRows[i]));
   }
 }
 
-void DataProcessor::ScaleLogarithmic(torch::Tensor& data)
+std::pair<torch::Tensor, torch::Tensor> DataProcessor::StackData(DataVector const& data)
 {
-  for (int64_t i = 0; i < data.size(0); ++i) {
-    if (data[i].item<TensorDataType>() < MINIMUM_ALLOWED_VALUE) {
-      data[i] = MINIMUM_ALLOWED_VALUE;
-    }
-    data[i] = std::log(data[i].item<TensorDataType>());
+  std::vector<torch::Tensor> inputTensors{};
+  std::vector<torch::Tensor> outputTensors{};
+  inputTensors.reserve(data.size());
+  outputTensors.reserve(data.size());
+
+  for (auto const& [inputTensor, outputTensor] : data) {
+    inputTensors.push_back(inputTensor);
+    outputTensors.push_back(outputTensor);
   }
+
+  return std::make_pair(torch::stack(inputTensors), torch::stack(outputTensors));
 }
 
-void DataProcessor::UnscaleLogarithmic(torch::Tensor& data)
+std::optional<std::pair<torch::Tensor, torch::Tensor>> DataProcessor::BatchView(DataVector const& data)
 {
-  for (int64_t i = 0; i < data.size(0); ++i) {
-    data[i] = std::exp(data[i].item<TensorDataType>());
+  if (data.empty()) {
+    return std::nullopt;
   }
+
+  std::vector<torch::Tensor const*> inputRows{};
+  std::vector<torch::Tensor const*> outputRows{};
+  inputRows.reserve(data.size());
+  outputRows.reserve(data.size());
+  for (auto const& [inputTensor, outputTensor] : data) {
+    inputRows.push_back(&inputTensor);
+    outputRows.push_back(&outputTensor);
+  }
+
+  auto inputs = rowsView(inputRows);
+  if (!inputs) {
+    return std::nullopt;
+  }
+  auto outputs = rowsView(outputRows);
+  if (!outputs) {
+    return std::nullopt;
+  }
+  return std::make_optional(std::make_pair(*inputs, *outputs));
+}
+
+void DataProcessor::ScaleLogarithmic(torch::Tensor& data)
+{
+  data.clamp_min_(MINIMUM_ALLOWED_VALUE).log_();
+}
+
+void DataProcessor::UnscaleLogarithmic(torch::Tensor& data)
+{
+  data.exp_();
 }
 
 void DataProcessor::ScaleSquareRoot(torch::Tensor& data)
 {
-  for (int64_t i = 0; i < data.size(0); ++i) {
-    if (data[i].item<TensorDataType>() < MINIMUM_ALLOWED_VALUE) {
-      data[i] = MINIMUM_ALLOWED_VALUE;
-    }
-    data[i] = std::sqrt(data[i].item<TensorDataType>());
-  }
+  data.clamp_min_(MINIMUM_ALLOWED_VALUE).sqrt_();
 }
 
 void DataProcessor::UnscaleSquareRoot(torch::Tensor& data)
 {
-  for (int64_t i = 0; i < data.size(0); ++i) {
-    data[i] = std::pow(data[i].item<TensorDataType>(), 2.0);
-  }
+  data.pow_(2.0);
 }
 
 }
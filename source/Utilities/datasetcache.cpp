@@ -0,0 +1,320 @@
+#include "Utilities/datasetcache.h"
+
+#include <ATen/Parallel.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Utilities {
+
+namespace {
+
+const char CACHE_MAGIC[8] = {'N', 'N', 'A', 'C', 'A', 'C', 'H', 'E'};
+const uint32_t CACHE_VERSION = 4;
+const std::string CACHE_FILE_EXTENSION = ".nncache";
+const size_t HASH_BLOCK_SIZE = 4 * 1024 * 1024; // bytes, the blocks of the input file are hashed in parallel
+const int64_t HASH_GRAIN_SIZE = 1;
+const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+const uint64_t FNV_PRIME = 1099511628211ull;
+
+/*
+ * Layout of the cache file (all sections start at a multiple of 8 bytes):
+ * CacheHeader | file header | statistics (see DataStatistics::toValues) | input values [rows, inputs] | output values [rows, outputs]
+ */
+struct CacheHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t dataType;
+  uint64_t sourceSize;
+  int64_t sourceModificationTime;
+  int64_t sourceChangeTime;
+  uint64_t sourceInode;
+  uint64_t sourceHash;
+  uint64_t numberOfRows;
+  uint32_t numberOfInputs;
+  uint32_t numberOfOutputs;
+  uint64_t fileHeaderLength;
+  uint64_t numberOfStatisticsValues;
+  uint64_t columnSelectionHash;
+};
+
+struct SourceKey
+{
+  uint64_t size;
+  int64_t modificationTime;
+  int64_t changeTime;
+  uint64_t inode;
+};
+
+[[nodiscard]]
+size_t alignedSize(size_t const size)
+{
+  return (size + 7) / 8 * 8;
+}
+
+[[nodiscard]]
+uint64_t hashBytes(char const* data, size_t const size, uint64_t hash)
+{
+  for (size_t i = 0; i < size; ++i) {
+    hash = (hash ^ static_cast<unsigned char>(data[i])) * FNV_PRIME;
+  }
+  return hash;
+}
+
+/*
+ * Returns a hash of the given bytes, which processes 8 bytes per step. Every step is a bijection of the hash, so a single changed word always
+ * changes the hash.
+ */
+[[nodiscard]]
+uint64_t hashWords(char const* data, size_t const size, uint64_t hash)
+{
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word = 0;
+    std::memcpy(&word, data + i, sizeof(uint64_t));
+    hash = (hash ^ word) * FNV_PRIME;
+  }
+  return hashBytes(data + i, size - i, hash);
+}
+
+/*
+ * Returns a hash of the selected column names (the same for every run without selected columns).
+ */
+[[nodiscard]]
+uint64_t hashColumnNames(std::vector<std::string> const& inputColumnNames, std::vector<std::string> const& outputColumnNames)
+{
+  auto hash = FNV_OFFSET_BASIS;
+  for (auto const* names : {&inputColumnNames, &outputColumnNames}) {
+    for (auto const& name : *names) {
+      hash = hashBytes(name.c_str(), name.size() + 1, hash); // including the null character to separate the names
+    }
+    hash = hashBytes("", 1, hash);
+  }
+  return hash;
+}
+
+/*
+ * Returns the size, the modification time, the status change time and the inode of the given file without reading it.
+ * Unlike the modification time, the status change time cannot be set by the user, so it also detects edits which preserve the size and the
+ * modification time (e.g. cp -p or touch -r).
+ */
+[[nodiscard]]
+std::optional<SourceKey> createSourceKey(FilePath const& path)
+{
+  struct stat status{};
+  if (stat(path.c_str(), &status) != 0) {
+    return std::nullopt;
+  }
+
+  auto const nanoseconds = [](timespec const& time) { return static_cast<int64_t>(time.tv_sec) * 1000000000 + time.tv_nsec; };
+  return SourceKey{static_cast<uint64_t>(status.st_size), nanoseconds(status.st_mtim), nanoseconds(status.st_ctim), static_cast<uint64_t>(status.st_ino)};
+}
+
+/*
+ * Returns a hash of the whole given file. The blocks of the file are hashed in parallel, which is much faster than parsing the file.
+ * The hash is only compared if the status change time or the inode of the input file changed (e.g. the input file and its cache were copied).
+ */
+[[nodiscard]]
+std::optional<uint64_t> hashSourceFile(FilePath const& path)
+{
+  MappedFile file(path);
+  if (!file.isOpen()) {
+    return std::nullopt;
+  }
+
+  auto const size = file.size();
+  auto const numberOfBlocks = static_cast<int64_t>((size + HASH_BLOCK_SIZE - 1) / HASH_BLOCK_SIZE);
+  std::vector<uint64_t> blockHashes(numberOfBlocks);
+  at::parallel_for(0, numberOfBlocks, HASH_GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (auto block = begin; block < end; ++block) {
+      auto const offset = static_cast<size_t>(block) * HASH_BLOCK_SIZE;
+      blockHashes[block] = hashWords(file.data() + offset, std::min(HASH_BLOCK_SIZE, size - offset), FNV_OFFSET_BASIS);
+    }
+  });
+
+  auto hash = FNV_OFFSET_BASIS;
+  for (auto const blockHash : blockHashes) {
+    hash = (hash ^ blockHash) * FNV_PRIME;
+  }
+
+  return std::make_optional(hash);
+}
+
+}
+
+FilePath DatasetCache::CachePath(FilePath const& sourceFilePath)
+{
+  return sourceFilePath + CACHE_FILE_EXTENSION;
+}
+
+DatasetCacheReader::DatasetCacheReader(FilePath const& cacheFilePath, bool const copyOnWrite) :
+  file(std::make_shared<MappedFile>(cacheFilePath, copyOnWrite))
+{
+}
+
+std::unique_ptr<DatasetCacheReader> DatasetCacheReader::Open(FilePath const& sourceFilePath, uint32_t const numberOfInputVariables,
+                                                             uint32_t const numberOfOutputVariables, std::vector<std::string> const& inputColumnNames,
+                                                             std::vector<std::string> const& outputColumnNames, bool const copyOnWrite)
+{
+  auto const key = createSourceKey(sourceFilePath);
+  if (!key) {
+    return nullptr;
+  }
+
+  std::unique_ptr<DatasetCacheReader> reader(new DatasetCacheReader(DatasetCache::CachePath(sourceFilePath), copyOnWrite));
+  auto const& file = *reader->file;
+  if (!file.isOpen() || file.size() < sizeof(CacheHeader)) {
+    return nullptr;
+  }
+
+  CacheHeader header{};
+  std::memcpy(&header, file.data(), sizeof(CacheHeader));
+  if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.version != CACHE_VERSION ||
+      header.dataType != static_cast<uint32_t>(TORCH_DATA_TYPE)) {
+    return nullptr;
+  }
+  if (header.sourceSize != key->size || header.sourceModificationTime != key->modificationTime) {
+    return nullptr; // outdated
+  }
+  if (header.sourceChangeTime != key->changeTime || header.sourceInode != key->inode) {
+    auto const hash = hashSourceFile(sourceFilePath);
+    if (!hash || *hash != header.sourceHash) {
+      return nullptr; // outdated
+    }
+  }
+  if (header.numberOfInputs != numberOfInputVariables || header.numberOfOutputs != numberOfOutputVariables ||
+      header.columnSelectionHash != hashColumnNames(inputColumnNames, outputColumnNames)) {
+    return nullptr;
+  }
+
+  auto const fileHeaderOffset = sizeof(CacheHeader);
+  auto const statisticsOffset = fileHeaderOffset + alignedSize(header.fileHeaderLength);
+  auto const inputValuesOffset = statisticsOffset + header.numberOfStatisticsValues * sizeof(double);
+  auto const outputValuesOffset = inputValuesOffset + header.numberOfRows * header.numberOfInputs * sizeof(TensorDataType);
+  if (file.size() != outputValuesOffset + header.numberOfRows * header.numberOfOutputs * sizeof(TensorDataType)) {
+    return nullptr;
+  }
+
+  auto const* statisticsValues = reinterpret_cast<double const*>(file.data() + statisticsOffset);
+  auto statistics = DataStatistics::FromValues(std::vector<double>(statisticsValues, statisticsValues + header.numberOfStatisticsValues));
+  if (!statistics || statistics->inputColumns().size() != header.numberOfInputs || statistics->outputColumns().size() != header.numberOfOutputs) {
+    return nullptr;
+  }
+
+  reader->header = std::string(file.data() + fileHeaderOffset, header.fileHeaderLength);
+  reader->rows = header.numberOfRows;
+  reader->numberOfInputs = header.numberOfInputs;
+  reader->numberOfOutputs = header.numberOfOutputs;
+  reader->columnStatistics = std::move(*statistics);
+  reader->columnMinMax = reader->columnStatistics.minMax();
+  reader->inputValues = reinterpret_cast<TensorDataType const*>(file.data() + inputValuesOffset);
+  reader->outputValues = reinterpret_cast<TensorDataType const*>(file.data() + outputValuesOffset);
+
+  return reader;
+}
+
+std::pair<torch::Tensor, torch::Tensor> DatasetCacheReader::readRows(uint64_t const firstRow, uint64_t const numberOfRowsToRead) const
+{
+  auto const first = static_cast<int64_t>(firstRow);
+  auto const length = static_cast<int64_t>(numberOfRowsToRead);
+  auto const numberOfRows = static_cast<int64_t>(rows);
+
+  // The rows are copied from the mapping (one contiguous block per tensor), so the tensors can outlive the mapping and be changed:
+  auto inputs = torch::from_blob(const_cast<TensorDataType*>(inputValues), {numberOfRows, numberOfInputs}, TORCH_DATA_TYPE).narrow(0, first, length);
+  auto outputs = torch::from_blob(const_cast<TensorDataType*>(outputValues), {numberOfRows, numberOfOutputs}, TORCH_DATA_TYPE).narrow(0, first, length);
+
+  return std::make_pair(inputs.clone(), outputs.clone());
+}
+
+std::pair<torch::Tensor, torch::Tensor> DatasetCacheReader::mapRows() const
+{
+  auto const numberOfRows = static_cast<int64_t>(rows);
+  auto const writable = [&](TensorDataType const* values) { return file->writableData() + (reinterpret_cast<char const*>(values) - file->data()); };
+
+  // Zero-copy: every tensor keeps the mapping until it is destroyed:
+  auto release = [file = file](void*) mutable { file.reset(); };
+  return std::make_pair(torch::from_blob(writable(inputValues), {numberOfRows, numberOfInputs}, release, TORCH_DATA_TYPE),
+                        torch::from_blob(writable(outputValues), {numberOfRows, numberOfOutputs}, release, TORCH_DATA_TYPE));
+}
+
+std::optional<CachedDataset> DatasetCache::Load(FilePath const& sourceFilePath, uint32_t const numberOfInputVariables, uint32_t const numberOfOutputVariables,
+                                                std::vector<std::string> const& inputColumnNames, std::vector<std::string> const& outputColumnNames)
+{
+  auto reader = DatasetCacheReader::Open(sourceFilePath, numberOfInputVariables, numberOfOutputVariables, inputColumnNames, outputColumnNames, true);
+  if (!reader) {
+    return std::nullopt;
+  }
+
+  CachedDataset dataset{};
+  dataset.fileHeader = reader->fileHeader();
+  dataset.statistics = reader->statistics();
+  std::tie(dataset.inputs, dataset.outputs) = reader->mapRows();
+
+  return std::make_optional(dataset);
+}
+
+bool DatasetCache::Save(FilePath const& sourceFilePath, std::string const& fileHeader, torch::Tensor const& inputs, torch::Tensor const& outputs,
+                        DataStatistics const& statistics, std::vector<std::string> const& inputColumnNames,
+                        std::vector<std::string> const& outputColumnNames)
+{
+  auto const key = createSourceKey(sourceFilePath);
+  auto const hash = key ? hashSourceFile(sourceFilePath) : std::nullopt;
+  if (!hash || inputs.size(0) == 0) {
+    return false;
+  }
+
+  auto const inputValues = inputs.to(TORCH_DATA_TYPE).contiguous();
+  auto const outputValues = outputs.to(TORCH_DATA_TYPE).contiguous();
+  auto const statisticsValues = statistics.toValues();
+
+  CacheHeader header{};
+  std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+  header.version = CACHE_VERSION;
+  header.dataType = static_cast<uint32_t>(TORCH_DATA_TYPE);
+  header.sourceSize = key->size;
+  header.sourceModificationTime = key->modificationTime;
+  header.sourceChangeTime = key->changeTime;
+  header.sourceInode = key->inode;
+  header.sourceHash = *hash;
+  header.numberOfRows = static_cast<uint64_t>(inputs.size(0));
+  header.numberOfInputs = static_cast<uint32_t>(inputs.size(1));
+  header.numberOfOutputs = static_cast<uint32_t>(outputs.size(1));
+  header.fileHeaderLength = fileHeader.size();
+  header.numberOfStatisticsValues = statisticsValues.size();
+  header.columnSelectionHash = hashColumnNames(inputColumnNames, outputColumnNames);
+
+  auto const cachePath = CachePath(sourceFilePath);
+  auto const temporaryPath = cachePath + ".tmp" + std::to_string(getpid());
+  std::error_code error{};
+  {
+    std::ofstream cacheFile(temporaryPath, std::ios::binary);
+    std::string const padding(alignedSize(fileHeader.size()) - fileHeader.size(), '\0');
+
+    cacheFile.write(reinterpret_cast<char const*>(&header), sizeof(CacheHeader));
+    cacheFile.write(fileHeader.data(), fileHeader.size());
+    cacheFile.write(padding.data(), padding.size());
+    cacheFile.write(reinterpret_cast<char const*>(statisticsValues.data()), statisticsValues.size() * sizeof(double));
+    cacheFile.write(reinterpret_cast<char const*>(inputValues.data_ptr<TensorDataType>()), inputValues.numel() * sizeof(TensorDataType));
+    cacheFile.write(reinterpret_cast<char const*>(outputValues.data_ptr<TensorDataType>()), outputValues.numel() * sizeof(TensorDataType));
+
+    if (!cacheFile) {
+      cacheFile.close();
+      std::filesystem::remove(temporaryPath, error);
+      return false;
+    }
+  }
+
+  std::filesystem::rename(temporaryPath, cachePath, error);
+  if (error) {
+    std::filesystem::remove(temporaryPath, error);
+    return false;
+  }
+
+  return true;
+}
+
+}
@@ -1,30 +1,106 @@
 #include "Utilities/datasplitter.h"
+#include "Utilities/dataprocessor.h"
 
+#include <algorithm>
+#include <numeric>
 #include <random>
+#include <string_view>
 
 namespace Utilities {
 
-std::pair<DataVector, DataVector> DataSplitter::splitDataRandomly(DataVector const& inputData, double trainingPercentage)
+namespace {
+
+const int64_t GROUP_BY_GRAIN_SIZE = 4096;
+
+}
+
+std::pair<DataVector, DataVector> DataSplitter::splitDataRandomly(DataVector const& inputData, double trainingPercentage, uint64_t const seed)
 {
-  if (trainingPercentage == 0) {
-    return std::make_pair(DataVector(), inputData);
-  }
+  auto const trainingRows = trainingRowsOfRandomSplit(inputData.size(), trainingPercentage, seed);
+  auto const* trainingRow = trainingRows.data_ptr<int64_t>();
+  auto const* const lastTrainingRow = trainingRow + trainingRows.numel();
+
   DataVector trainingData{};
   DataVector validationData{};
+  trainingData.reserve(static_cast<size_t>(trainingRows.numel()));
+  validationData.reserve(inputData.size() - static_cast<size_t>(trainingRows.numel()));
 
-  std::random_device rd;
-  std::mt19937 gen(rd());
+  for (size_t i = 0; i < inputData.size(); ++i) {
+    if (trainingRow != lastTrainingRow && *trainingRow == static_cast<int64_t>(i)) {
+      trainingData.push_back(inputData[i]);
+      ++trainingRow;
+    } else {
+      validationData.push_back(inputData[i]);
+    }
+  }
+
+  return std::make_pair(std::move(trainingData), std::move(validationData));
+}
+
+torch::Tensor DataSplitter::trainingRowsOfRandomSplit(size_t const numberOfDataPoints, double const trainingPercentage, uint64_t const seed)
+{
+  std::vector<int64_t> trainingRows{};
+  if (trainingPercentage == 0) {
+    return torch::tensor(trainingRows, torch::kLong);
+  }
+
+  std::mt19937_64 gen(seed);
   std::uniform_real_distribution<double> dis(0.0, 100.0);
 
-  for (auto const& entry : inputData) {
+  for (size_t i = 0; i < numberOfDataPoints; ++i) {
     if (dis(gen) <= trainingPercentage) {
-      trainingData.push_back(entry);
+      trainingRows.push_back(static_cast<int64_t>(i));
+    }
+  }
+
+  return torch::tensor(trainingRows, torch::kLong);
+}
+
+std::vector<uint32_t> DataSplitter::assignFolds(size_t const numberOfDataPoints, uint32_t const numberOfFolds, uint64_t const seed)
+{
+  std::vector<uint32_t> foldAssignment(numberOfDataPoints);
+  for (size_t i = 0; i < numberOfDataPoints; ++i) {
+    foldAssignment[i] = static_cast<uint32_t>(i % numberOfFolds);
+  }
+
+  std::mt19937_64 gen(seed);
+  std::shuffle(foldAssignment.begin(), foldAssignment.end(), gen);
+
+  return foldAssignment;
+}
+
+std::pair<DataVector, DataVector> DataSplitter::splitDataByFold(DataVector const& data, std::vector<uint32_t> const& foldAssignment, uint32_t const validationFold)
+{
+  auto const numberOfValidationDataPoints = static_cast<size_t>(std::count(foldAssignment.begin(), foldAssignment.end(), validationFold));
+
+  DataVector trainingData{};
+  DataVector validationData{};
+  trainingData.reserve(data.size() - numberOfValidationDataPoints);
+  validationData.reserve(numberOfValidationDataPoints);
+
+  for (size_t i = 0; i < data.size(); ++i) {
+    if (foldAssignment[i] == validationFold) {
+      validationData.push_back(data[i]);
     } else {
-      validationData.push_back(entry);
+      trainingData.push_back(data[i]);
+    }
+  }
+
+  return std::make_pair(std::move(trainingData), std::move(validationData));
+}
+
+torch::Tensor DataSplitter::trainingRowsOfFold(std::vector<uint32_t> const& foldAssignment, uint32_t const validationFold)
+{
+  std::vector<int64_t> trainingRows{};
+  trainingRows.reserve(foldAssignment.size());
+
+  for (size_t i = 0; i < foldAssignment.size(); ++i) {
+    if (foldAssignment[i] != validationFold) {
+      trainingRows.push_back(static_cast<int64_t>(i));
     }
   }
 
-  return std::make_pair(trainingData, validationData);
+  return torch::tensor(trainingRows, torch::kLong);
 }
 
 std::pair<DataVector, DataVector> DataSplitter::splitDataWithThreshold(DataVector const& data, uint32_t const thresholdVariable, TensorDataType const threshold)
@@ -43,22 +119,77 @@ std::pair<DataVector, DataVector> DataSplitter::splitDataWithThreshold(DataVecto
   return std::make_pair(belowAndEqualThreshold, aboveThreshold);
 }
 
-BatchMap DataSplitter::splitDataIntoBatches(DataVector const& data, uint32_t const batchVariable) {
-  BatchMap batches{};
+BatchVector DataSplitter::splitDataIntoBatches(DataVector const& data, uint32_t const batchVariable)
+{
+  if (data.empty()) {
+    return BatchVector();
+  }
 
-  for (auto const& entry : data) {
-    std::string identifier {};
-    for (int64_t i = 0; i < entry.first.size(0); ++i) {
-      if (i != batchVariable) {
-        identifier += std::to_string(i) + "->" + std::to_string(entry.first[i].item<TensorDataType>());
-      }
+  auto [inputs, outputs] = DataProcessor::StackData(data);
+  auto const numberOfRows = inputs.size(0);
+
+  // The identifier of a batch are the values of all input variables except the batch variable (-0.0 + 0.0 = 0.0, so both zeros are equal):
+  std::vector<int64_t> identifierColumns{};
+  for (int64_t i = 0; i < inputs.size(1); ++i) {
+    if (i != batchVariable) {
+      identifierColumns.push_back(i);
     }
+  }
+  auto identifiers = inputs.index_select(1, torch::tensor(identifierColumns, torch::kLong)).to(torch::kDouble).add(0.0).contiguous();
+  auto const identifierSize = static_cast<size_t>(identifiers.size(1)) * sizeof(double);
+  auto const* identifierData = reinterpret_cast<char const*>(identifiers.data_ptr<double>());
 
-    auto result = batches.insert(std::make_pair(identifier, DataVector{entry}));
+  auto identifierOf = [&](int64_t row) {
+    return std::string_view(identifierData + row * identifierSize, identifierSize);
+  };
 
-    if (!result.second) {
-      result.first->second.push_back(entry);
+  std::vector<size_t> hashes(numberOfRows);
+  at::parallel_for(0, numberOfRows, GROUP_BY_GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (auto row = begin; row < end; ++row) {
+      hashes[row] = std::hash<std::string_view>{}(identifierOf(row));
     }
+  });
+
+  // Sort by hash first, equal identifiers end up next to each other and keep the order of the data points:
+  std::vector<int64_t> order(numberOfRows);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](int64_t a, int64_t b) {
+    if (hashes[a] != hashes[b]) {
+      return hashes[a] < hashes[b];
+    }
+    auto comparison = identifierOf(a).compare(identifierOf(b));
+    return (comparison != 0) ? comparison < 0 : a < b;
+  });
+
+  std::vector<std::pair<size_t, size_t>> groups{}; // [first, last) in order
+  for (size_t i = 0; i < order.size(); ++i) {
+    if (i == 0 || hashes[order[i]] != hashes[order[i - 1]] || identifierOf(order[i]) != identifierOf(order[i - 1])) {
+      groups.emplace_back(i, i);
+    }
+    groups.back().second = i + 1;
+  }
+
+  std::sort(groups.begin(), groups.end(), [&](auto const& a, auto const& b) {
+    return order[a.first] < order[b.first];
+  });
+
+  // Pack all batches into one tensor, each batch is a contiguous range of rows:
+  std::vector<int64_t> packedOrder{};
+  packedOrder.reserve(order.size());
+  for (auto const& [first, last] : groups) {
+    packedOrder.insert(packedOrder.end(), order.begin() + first, order.begin() + last);
+  }
+  auto packedIndices = torch::from_blob(packedOrder.data(), {numberOfRows}, torch::kLong);
+  auto packedInputs = inputs.index_select(0, packedIndices);
+  auto packedOutputs = outputs.index_select(0, packedIndices);
+
+  BatchVector batches{};
+  batches.reserve(groups.size());
+  int64_t offset = 0;
+  for (auto const& [first, last] : groups) {
+    auto size = static_cast<int64_t>(last - first);
+    batches.emplace_back(packedInputs.narrow(0, offset, size), packedOutputs.narrow(0, offset, size));
+    offset += size;
   }
 
   return batches;
@@ -0,0 +1,279 @@
+#include "Utilities/datastatistics.h"
+
+#include <algorithm>
+
+namespace Utilities {
+
+namespace {
+
+const int64_t ROWS_PER_BLOCK = 65536; // fixed blocks, so the merged mean and variance do not depend on the number of threads
+const int64_t BLOCK_GRAIN_SIZE = 1;
+const size_t VALUES_PER_ACCUMULATOR = 5;
+const size_t VALUES_BEFORE_COLUMNS = 8; // the numbers of columns and rows, the scaling threshold and the number of rows of both parts
+
+[[nodiscard]]
+MinMaxVector createMinMaxVector(size_t const size)
+{
+  return MinMaxVector(size, std::make_pair(std::numeric_limits<TensorDataType>::max(), std::numeric_limits<TensorDataType>::lowest()));
+}
+
+/*
+ * Returns the given tensor [rows, columns] if its values are of TensorDataType and the values of every row are contiguous, otherwise a contiguous copy.
+ */
+[[nodiscard]]
+torch::Tensor rowsWithContiguousValues(torch::Tensor const& values)
+{
+  if (values.scalar_type() == TORCH_DATA_TYPE && (values.stride(1) == 1 || values.size(1) <= 1)) {
+    return values;
+  }
+  return values.to(TORCH_DATA_TYPE).contiguous();
+}
+
+void mergeMinMax(MinMaxVector& minMaxVector, MinMaxVector const& other)
+{
+  for (size_t i = 0; i < minMaxVector.size(); ++i) {
+    minMaxVector[i].first = std::min(minMaxVector[i].first, other[i].first);
+    minMaxVector[i].second = std::max(minMaxVector[i].second, other[i].second);
+  }
+}
+
+}
+
+std::optional<ScalingThreshold> ScalingThreshold::FromOptions(ProgramOptions const& options)
+{
+  if (!options.LogLinScaling && !options.LogSqrtScaling) {
+    return std::nullopt;
+  }
+  return ScalingThreshold{options.MixedScalingInputVariable, options.MixedScalingThreshold};
+}
+
+void ValueAccumulator::add(TensorDataType const value)
+{
+  minimumValue = std::min(minimumValue, value);
+  maximumValue = std::max(maximumValue, value);
+
+  ++numberOfValues;
+  auto const delta = value - meanValue;
+  meanValue += delta / static_cast<double>(numberOfValues);
+  squaredDistanceSum += delta * (value - meanValue);
+}
+
+void ValueAccumulator::merge(ValueAccumulator const& other)
+{
+  if (other.numberOfValues == 0) {
+    return;
+  }
+
+  minimumValue = std::min(minimumValue, other.minimumValue);
+  maximumValue = std::max(maximumValue, other.maximumValue);
+
+  auto const count = static_cast<double>(numberOfValues);
+  auto const otherCount = static_cast<double>(other.numberOfValues);
+  auto const delta = other.meanValue - meanValue;
+  numberOfValues += other.numberOfValues;
+  meanValue += delta * otherCount / (count + otherCount);
+  squaredDistanceSum += other.squaredDistanceSum + delta * delta * count * otherCount / (count + otherCount);
+}
+
+double ValueAccumulator::variance() const
+{
+  return (numberOfValues == 0) ? 0.0 : squaredDistanceSum / static_cast<double>(numberOfValues);
+}
+
+void ValueAccumulator::appendValues(std::vector<double>& values) const
+{
+  values.insert(values.end(), {static_cast<double>(numberOfValues), minimumValue, maximumValue, meanValue, squaredDistanceSum});
+}
+
+ValueAccumulator ValueAccumulator::FromValues(double const* values)
+{
+  ValueAccumulator accumulator{};
+  accumulator.numberOfValues = static_cast<uint64_t>(values[0]);
+  accumulator.minimumValue = static_cast<TensorDataType>(values[1]);
+  accumulator.maximumValue = static_cast<TensorDataType>(values[2]);
+  accumulator.meanValue = values[3];
+  accumulator.squaredDistanceSum = values[4];
+  return accumulator;
+}
+
+DataStatistics::DataStatistics(uint32_t const numberOfInputs, uint32_t const numberOfOutputs, std::optional<ScalingThreshold> const scalingThreshold) :
+  inputAccumulators(numberOfInputs), outputAccumulators(numberOfOutputs), threshold(scalingThreshold)
+{
+  if (threshold) {
+    thresholdOutputMinMax = std::make_pair(createMinMaxVector(numberOfOutputs), createMinMaxVector(numberOfOutputs));
+  }
+}
+
+DataStatistics DataStatistics::Collect(torch::Tensor const& inputs, torch::Tensor const& outputs, std::optional<ScalingThreshold> const scalingThreshold)
+{
+  // Views of wider arrays (e.g. the input and output columns of one array) are read in place, their rows only have to be contiguous:
+  auto const inputValues = rowsWithContiguousValues(inputs);
+  auto const outputValues = rowsWithContiguousValues(outputs);
+  auto const inputRowStride = inputValues.stride(0);
+  auto const outputRowStride = outputValues.stride(0);
+  auto const numberOfRows = inputValues.size(0);
+  auto const numberOfInputs = static_cast<uint32_t>(inputValues.size(1));
+  auto const numberOfOutputs = static_cast<uint32_t>(outputValues.size(1));
+  auto const* inputData = inputValues.data_ptr<TensorDataType>();
+  auto const* outputData = outputValues.data_ptr<TensorDataType>();
+
+  auto const numberOfBlocks = (numberOfRows + ROWS_PER_BLOCK - 1) / ROWS_PER_BLOCK;
+  std::vector<DataStatistics> blockStatistics(static_cast<size_t>(numberOfBlocks), DataStatistics(numberOfInputs, numberOfOutputs, scalingThreshold));
+  at::parallel_for(0, numberOfBlocks, BLOCK_GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (auto block = begin; block < end; ++block) {
+      auto const lastRow = std::min(numberOfRows, (block + 1) * ROWS_PER_BLOCK);
+      for (auto row = block * ROWS_PER_BLOCK; row < lastRow; ++row) {
+        blockStatistics[block].addRow(inputData + row * inputRowStride, outputData + row * outputRowStride);
+      }
+    }
+  });
+
+  DataStatistics statistics(numberOfInputs, numberOfOutputs, scalingThreshold);
+  for (auto const& block : blockStatistics) {
+    statistics.merge(block);
+  }
+  return statistics;
+}
+
+void DataStatistics::addRow(TensorDataType const* inputs, TensorDataType const* outputs)
+{
+  ++numberOfRows;
+  for (size_t i = 0; i < inputAccumulators.size(); ++i) {
+    inputAccumulators[i].add(inputs[i]);
+  }
+  for (size_t i = 0; i < outputAccumulators.size(); ++i) {
+    outputAccumulators[i].add(outputs[i]);
+  }
+
+  if (threshold) {
+    auto const belowThreshold = inputs[threshold->inputVariable] <= threshold->threshold;
+    auto& minMaxVector = belowThreshold ? thresholdOutputMinMax.first : thresholdOutputMinMax.second;
+    ++(belowThreshold ? thresholdCounts.first : thresholdCounts.second);
+
+    for (size_t i = 0; i < minMaxVector.size(); ++i) {
+      minMaxVector[i].first = std::min(minMaxVector[i].first, outputs[i]);
+      minMaxVector[i].second = std::max(minMaxVector[i].second, outputs[i]);
+    }
+  }
+}
+
+void DataStatistics::merge(DataStatistics const& other)
+{
+  numberOfRows += other.numberOfRows;
+  for (size_t i = 0; i < inputAccumulators.size(); ++i) {
+    inputAccumulators[i].merge(other.inputAccumulators[i]);
+  }
+  for (size_t i = 0; i < outputAccumulators.size(); ++i) {
+    outputAccumulators[i].merge(other.outputAccumulators[i]);
+  }
+
+  if (threshold) {
+    mergeMinMax(thresholdOutputMinMax.first, other.thresholdOutputMinMax.first);
+    mergeMinMax(thresholdOutputMinMax.second, other.thresholdOutputMinMax.second);
+    thresholdCounts.first += other.thresholdCounts.first;
+    thresholdCounts.second += other.thresholdCounts.second;
+  }
+}
+
+bool DataStatistics::hasScalingThreshold(std::optional<ScalingThreshold> const scalingThreshold) const
+{
+  if (!threshold || !scalingThreshold) {
+    return !threshold && !scalingThreshold;
+  }
+  return threshold->inputVariable == scalingThreshold->inputVariable && threshold->threshold == scalingThreshold->threshold;
+}
+
+MinMaxValues DataStatistics::minMax() const
+{
+  MinMaxValues minMaxValues{};
+  if (numberOfRows == 0) {
+    return minMaxValues;
+  }
+
+  for (auto const& column : inputAccumulators) {
+    minMaxValues.first.emplace_back(column.minimum(), column.maximum());
+  }
+  for (auto const& column : outputAccumulators) {
+    minMaxValues.second.emplace_back(column.minimum(), column.maximum());
+  }
+  return minMaxValues;
+}
+
+MixedMinMaxValues DataStatistics::mixedMinMax() const
+{
+  auto const globalMinMax = minMax();
+
+  MixedMinMaxValues mixedMinMaxValues{};
+  mixedMinMaxValues.first.first = globalMinMax.first;
+  mixedMinMaxValues.second.first = globalMinMax.first;
+  if (thresholdCounts.first > 0) {
+    mixedMinMaxValues.first.second = thresholdOutputMinMax.first;
+  }
+  if (thresholdCounts.second > 0) {
+    mixedMinMaxValues.second.second = thresholdOutputMinMax.second;
+  }
+  return mixedMinMaxValues;
+}
+
+std::vector<double> DataStatistics::toValues() const
+{
+  std::vector<double> values{static_cast<double>(inputAccumulators.size()), static_cast<double>(outputAccumulators.size()),
+                             static_cast<double>(numberOfRows), threshold ? 1.0 : 0.0,
+                             threshold ? static_cast<double>(threshold->inputVariable) : 0.0, threshold ? threshold->threshold : 0.0,
+                             static_cast<double>(thresholdCounts.first), static_cast<double>(thresholdCounts.second)};
+  for (auto const* accumulators : {&inputAccumulators, &outputAccumulators}) {
+    for (auto const& accumulator : *accumulators) {
+      accumulator.appendValues(values);
+    }
+  }
+  if (threshold) {
+    for (auto const* minMaxVector : {&thresholdOutputMinMax.first, &thresholdOutputMinMax.second}) {
+      for (auto const& [minimum, maximum] : *minMaxVector) {
+        values.insert(values.end(), {minimum, maximum});
+      }
+    }
+  }
+  return values;
+}
+
+std::optional<DataStatistics> DataStatistics::FromValues(std::vector<double> const& values)
+{
+  if (values.size() < VALUES_BEFORE_COLUMNS) {
+    return std::nullopt;
+  }
+
+  auto const numberOfInputs = static_cast<uint32_t>(values[0]);
+  auto const numberOfOutputs = static_cast<uint32_t>(values[1]);
+  auto const hasThreshold = values[3] != 0.0;
+  auto const numberOfColumns = static_cast<size_t>(numberOfInputs) + numberOfOutputs;
+  auto const numberOfThresholdValues = hasThreshold ? 4 * static_cast<size_t>(numberOfOutputs) : 0;
+  if (values.size() != VALUES_BEFORE_COLUMNS + numberOfColumns * VALUES_PER_ACCUMULATOR + numberOfThresholdValues) {
+    return std::nullopt;
+  }
+
+  auto const scalingThreshold = hasThreshold ? std::make_optional(ScalingThreshold{static_cast<uint32_t>(values[4]), static_cast<TensorDataType>(values[5])})
+                                             : std::nullopt;
+  DataStatistics statistics(numberOfInputs, numberOfOutputs, scalingThreshold);
+  statistics.numberOfRows = static_cast<uint64_t>(values[2]);
+  statistics.thresholdCounts = std::make_pair(static_cast<uint64_t>(values[6]), static_cast<uint64_t>(values[7]));
+
+  auto const* position = values.data() + VALUES_BEFORE_COLUMNS;
+  for (auto* accumulators : {&statistics.inputAccumulators, &statistics.outputAccumulators}) {
+    for (auto& accumulator : *accumulators) {
+      accumulator = ValueAccumulator::FromValues(position);
+      position += VALUES_PER_ACCUMULATOR;
+    }
+  }
+  if (hasThreshold) {
+    for (auto* minMaxVector : {&statistics.thresholdOutputMinMax.first, &statistics.thresholdOutputMinMax.second}) {
+      for (auto& [minimum, maximum] : *minMaxVector) {
+        minimum = static_cast<TensorDataType>(position[0]);
+        maximum = static_cast<TensorDataType>(position[1]);
+        position += 2;
+      }
+    }
+  }
+  return statistics;
+}
+
+}
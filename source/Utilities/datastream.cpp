@@ -0,0 +1,219 @@
+#include "Utilities/datastream.h"
+#include "Utilities/fileparser.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+namespace Utilities {
+
+namespace {
+
+const size_t READ_AHEAD_CHUNKS = 1;
+
+// Every value of the input file takes at least two bytes of text (a digit and a separator), so the tensors of a chunk take at most
+// sizeof(TensorDataType) / 2 times the bytes of its text:
+const uint64_t MINIMUM_TEXT_BYTES_PER_VALUE = 2;
+
+}
+
+DataStream::DataStream(ProgramOptions const& options, uint64_t const maximumChunkSizeInBytes) :
+  path(options.InputDataFilePath), numberOfInputs(options.NumberOfInputVariables), numberOfOutputs(options.NumberOfOutputVariables)
+{
+  if (options.UseDatasetCache) {
+    cacheReader = DatasetCacheReader::Open(path, numberOfInputs, numberOfOutputs, options.InputColumnNames, options.OutputColumnNames);
+    if (!cacheReader) {
+      std::cout << "[Warning] The dataset cache is missing or outdated, the input file is parsed in every pass. "
+                   "Run once without --memoryBudget to create the cache." << std::endl;
+    }
+  }
+
+  if (cacheReader) {
+    auto const rowSizeInBytes = (static_cast<uint64_t>(numberOfInputs) + numberOfOutputs) * sizeof(TensorDataType);
+    header = cacheReader->fileHeader();
+    numberOfRowsPerChunk = std::max<uint64_t>(1, maximumChunkSizeInBytes / rowSizeInBytes);
+    numberOfChunks = (cacheReader->numberOfRows() + numberOfRowsPerChunk - 1) / numberOfRowsPerChunk;
+    knownNumberOfRows = cacheReader->numberOfRows();
+    open = true;
+    return;
+  }
+
+  if (path.empty()) {
+    std::cout << "Error: \"" << path << "\" is not a valid path to a file for the input data." << std::endl;
+    return;
+  }
+
+  inputFile = std::make_unique<MappedFile>(path);
+  if (!inputFile->isOpen() || inputFile->size() == 0) {
+    std::cout << "Error: Inputfile is empty or not valid." << std::endl;
+    return;
+  }
+
+  auto const content = inputFile->content();
+  auto const headerEnd = content.find('\n');
+  header = std::string(content.substr(0, headerEnd));
+  auto selectedColumns = FileParser::SelectColumns(header, options.InputColumnNames, options.OutputColumnNames, numberOfInputs, numberOfOutputs, path);
+  if (!selectedColumns) {
+    return;
+  }
+  columns = std::move(*selectedColumns);
+  auto const body = (headerEnd == std::string_view::npos) ? std::string_view() : content.substr(headerEnd + 1);
+
+  // The chunks end with a newline character. Only the pages around their ends are read here, the line numbers are only counted for an error message:
+  auto const chunkTextSize = std::max<uint64_t>(1, maximumChunkSizeInBytes * MINIMUM_TEXT_BYTES_PER_VALUE / sizeof(TensorDataType));
+  size_t begin = 0;
+  while (begin < body.size()) {
+    auto end = body.find('\n', begin + chunkTextSize - 1);
+    end = (end == std::string_view::npos) ? body.size() : end + 1;
+
+    lineChunks.push_back(body.substr(begin, end - begin));
+    begin = end;
+  }
+  numberOfChunks = lineChunks.size();
+  open = true;
+}
+
+DataStream::~DataStream()
+{
+  stop();
+}
+
+std::optional<MinMaxValues> DataStream::cachedMinMax() const
+{
+  if (!cacheReader) {
+    return std::nullopt;
+  }
+  return std::make_optional(cacheReader->minMax());
+}
+
+std::optional<uint64_t> DataStream::numberOfDataPoints() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return knownNumberOfRows;
+}
+
+void DataStream::setPreparation(ChunkPreparation chunkPreparation)
+{
+  stop();
+  preparation = std::move(chunkPreparation);
+}
+
+void DataStream::start(std::optional<uint64_t> const shuffleSeed)
+{
+  stop();
+
+  std::vector<size_t> order(numberOfChunks);
+  std::iota(order.begin(), order.end(), 0);
+  if (shuffleSeed) {
+    std::mt19937_64 generator(*shuffleSeed);
+    std::shuffle(order.begin(), order.end(), generator);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    readyChunks.clear();
+    numberOfReadRows = 0;
+    finished = false;
+    stopped = false;
+    readError = false;
+  }
+  reader = std::thread(&DataStream::readAhead, this, std::move(order));
+}
+
+std::optional<std::pair<torch::Tensor, torch::Tensor>> DataStream::next()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  condition.wait(lock, [&]() { return !readyChunks.empty() || finished; });
+  if (readyChunks.empty()) {
+    return std::nullopt;
+  }
+
+  auto chunk = std::move(readyChunks.front());
+  readyChunks.pop_front();
+  lock.unlock();
+  condition.notify_all();
+
+  return std::make_optional(std::move(chunk));
+}
+
+bool DataStream::failed() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return readError;
+}
+
+void DataStream::readAhead(std::vector<size_t> order)
+{
+  for (auto chunk : order) {
+    auto data = readChunk(chunk);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!data) {
+      readError = true;
+      break;
+    }
+
+    condition.wait(lock, [&]() { return stopped || readyChunks.size() < READ_AHEAD_CHUNKS; });
+    if (stopped) {
+      return;
+    }
+    numberOfReadRows += data->first.size(0);
+    readyChunks.push_back(std::move(*data));
+    lock.unlock();
+    condition.notify_all();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!readError) {
+      knownNumberOfRows = numberOfReadRows;
+    }
+    finished = true;
+  }
+  condition.notify_all();
+}
+
+std::optional<std::pair<torch::Tensor, torch::Tensor>> DataStream::readChunk(size_t const chunk) const
+{
+  std::optional<std::pair<torch::Tensor, torch::Tensor>> data{};
+  if (cacheReader) {
+    auto const firstRow = chunk * numberOfRowsPerChunk;
+    data = cacheReader->readRows(firstRow, std::min(numberOfRowsPerChunk, cacheReader->numberOfRows() - firstRow));
+  } else {
+    auto const& lines = lineChunks[chunk];
+    FileParser::ParseError error{};
+    data = FileParser::ParseLines(lines, 1, numberOfInputs, numberOfOutputs, columns, path, nullptr, &error);
+    inputFile->release(lines);
+
+    if (!data) {
+      auto const content = inputFile->content();
+      auto const precedingLines = std::count(content.begin(), content.begin() + (lines.data() - content.data()), '\n');
+      std::cout << "Error: " << error.second << " in line " << (precedingLines + error.first) << " of " << path << "." << std::endl;
+      return std::nullopt;
+    }
+  }
+
+  if (data && preparation) {
+    preparation(data->first, data->second);
+  }
+  return data;
+}
+
+void DataStream::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopped = true;
+  }
+  condition.notify_all();
+
+  if (reader.joinable()) {
+    reader.join();
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+  readyChunks.clear();
+  finished = true;
+}
+
+}
@@ -0,0 +1,162 @@
+#include "Utilities/erroraccumulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Utilities {
+
+QuantileSketch::QuantileSketch(double const relativeAccuracy) :
+  gamma((1.0 + relativeAccuracy) / (1.0 - relativeAccuracy)), logGamma(std::log(gamma))
+{
+}
+
+void QuantileSketch::add(double const value)
+{
+  if (!(value >= 0.0)) {
+    return;
+  }
+
+  if (value < std::numeric_limits<double>::min()) {
+    ++zeroCount;
+    return;
+  }
+
+  auto index = bucketIndex(value);
+  if (buckets.empty()) {
+    firstBucketIndex = index;
+    buckets.push_back(0);
+  } else if (index < firstBucketIndex) {
+    buckets.insert(buckets.begin(), static_cast<size_t>(firstBucketIndex - index), 0);
+    firstBucketIndex = index;
+  } else if (index >= firstBucketIndex + static_cast<int32_t>(buckets.size())) {
+    buckets.resize(static_cast<size_t>(index - firstBucketIndex + 1), 0);
+  }
+
+  ++buckets[static_cast<size_t>(index - firstBucketIndex)];
+}
+
+void QuantileSketch::merge(QuantileSketch const& other)
+{
+  zeroCount += other.zeroCount;
+
+  for (size_t i = 0; i < other.buckets.size(); ++i) {
+    if (other.buckets[i] == 0) {
+      continue;
+    }
+
+    auto index = other.firstBucketIndex + static_cast<int32_t>(i);
+    if (buckets.empty()) {
+      firstBucketIndex = index;
+      buckets.push_back(0);
+    } else if (index < firstBucketIndex) {
+      buckets.insert(buckets.begin(), static_cast<size_t>(firstBucketIndex - index), 0);
+      firstBucketIndex = index;
+    } else if (index >= firstBucketIndex + static_cast<int32_t>(buckets.size())) {
+      buckets.resize(static_cast<size_t>(index - firstBucketIndex + 1), 0);
+    }
+
+    buckets[static_cast<size_t>(index - firstBucketIndex)] += other.buckets[i];
+  }
+}
+
+double QuantileSketch::quantile(double const q) const
+{
+  auto totalCount = count();
+  if (totalCount == 0) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+
+  auto rank = static_cast<uint64_t>(std::clamp(q, 0.0, 1.0) * static_cast<double>(totalCount - 1));
+  if (rank < zeroCount) {
+    return 0.0;
+  }
+
+  uint64_t cumulativeCount = zeroCount;
+  for (size_t i = 0; i < buckets.size(); ++i) {
+    cumulativeCount += buckets[i];
+    if (cumulativeCount > rank) {
+      return bucketValue(firstBucketIndex + static_cast<int32_t>(i));
+    }
+  }
+
+  return bucketValue(firstBucketIndex + static_cast<int32_t>(buckets.size()) - 1);
+}
+
+uint64_t QuantileSketch::count() const
+{
+  uint64_t totalCount = zeroCount;
+  for (auto bucketCount : buckets) {
+    totalCount += bucketCount;
+  }
+  return totalCount;
+}
+
+int32_t QuantileSketch::bucketIndex(double const value) const
+{
+  return static_cast<int32_t>(std::ceil(std::log(value) / logGamma));
+}
+
+double QuantileSketch::bucketValue(int32_t const index) const
+{
+  // Bucket i contains the values in (gamma^(i-1), gamma^i], return the value with the smallest relative error:
+  return 2.0 * std::pow(gamma, index) / (gamma + 1.0);
+}
+
+ErrorAccumulator::ErrorAccumulator(size_t const numberOfColumns) :
+  columns(numberOfColumns)
+{
+}
+
+void ErrorAccumulator::add(size_t const column, double const wantedValue, double const actualValue)
+{
+  auto& accumulator = columns[column];
+  auto absoluteError = std::abs(wantedValue - actualValue);
+
+  ++accumulator.count;
+  accumulator.absoluteErrorSum += absoluteError;
+  accumulator.maxAbsoluteError = std::max(accumulator.maxAbsoluteError, absoluteError);
+  if (wantedValue != 0.0) {
+    accumulator.maxRelativeError = std::max(accumulator.maxRelativeError, absoluteError / std::abs(wantedValue));
+  }
+  accumulator.absoluteErrors.add(absoluteError);
+}
+
+void ErrorAccumulator::merge(ErrorAccumulator const& other)
+{
+  if (columns.size() < other.columns.size()) {
+    columns.resize(other.columns.size());
+  }
+
+  for (size_t i = 0; i < other.columns.size(); ++i) {
+    auto& accumulator = columns[i];
+    auto const& otherAccumulator = other.columns[i];
+
+    accumulator.count += otherAccumulator.count;
+    accumulator.absoluteErrorSum += otherAccumulator.absoluteErrorSum;
+    accumulator.maxAbsoluteError = std::max(accumulator.maxAbsoluteError, otherAccumulator.maxAbsoluteError);
+    accumulator.maxRelativeError = std::max(accumulator.maxRelativeError, otherAccumulator.maxRelativeError);
+    accumulator.absoluteErrors.merge(otherAccumulator.absoluteErrors);
+  }
+}
+
+std::vector<ErrorStatistics> ErrorAccumulator::statistics() const
+{
+  std::vector<ErrorStatistics> result{};
+
+  for (auto const& accumulator : columns) {
+    result.push_back(ErrorStatistics{
+      accumulator.count,
+      (accumulator.count > 0) ? accumulator.absoluteErrorSum / static_cast<double>(accumulator.count) : std::numeric_limits<double>::quiet_NaN(),
+      accumulator.maxAbsoluteError,
+      accumulator.maxRelativeError,
+      accumulator.absoluteErrors.quantile(0.50),
+      accumulator.absoluteErrors.quantile(0.95),
+      accumulator.absoluteErrors.quantile(0.99)
+    });
+  }
+
+  return result;
+}
+
+}
@@ -1,57 +1,569 @@
 #include "Utilities/fileparser.h"
+#include "Utilities/datasetcache.h"
+#include "Utilities/mappedfile.h"
+#include "Utilities/npyfile.h"
 
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
 #include <iostream>
+#include <limits>
 
 namespace Utilities {
 
-std::optional<DataVector> FileParser::ParseInputFile(std::string const& path, uint32_t const numberOfInputNodes, uint32_t const numberOfOutputNodes, std::string& fileHeader)
+namespace {
+
+const size_t MINIMUM_CHUNK_SIZE = 1 << 20; // bytes, smaller files are parsed by one thread
+const size_t CHUNKS_PER_THREAD = 4; // some lines are longer than others, more chunks balance the work
+const int64_t CHUNK_GRAIN_SIZE = 1;
+const int64_t SKIPPED_FIELD = -1;
+const int64_t ROWS_PER_WRITE_BLOCK = 16384; // rows formatted by one task before the block is written
+const size_t MAXIMUM_VALUE_LENGTH = 16; // "-1.23457e-308" with a precision of 6 significant digits (the default of std::ostream)
+const int VALUE_PRECISION = 6;
+const char VALUE_SEPARATOR[] = ", ";
+
+/*
+ * Splits the given text into chunks which end with a newline character (besides the last chunk). One chunk per MINIMUM_CHUNK_SIZE bytes,
+ * but not more than CHUNKS_PER_THREAD chunks per thread.
+ */
+[[nodiscard]]
+std::vector<std::string_view> splitIntoChunks(std::string_view const text)
+{
+  auto const maximumNumberOfChunks = CHUNKS_PER_THREAD * static_cast<size_t>(std::max(1, at::get_num_threads()));
+  auto const numberOfChunks = std::clamp<size_t>(text.size() / MINIMUM_CHUNK_SIZE, 1, maximumNumberOfChunks);
+  auto const chunkSize = text.size() / numberOfChunks;
+
+  std::vector<std::string_view> chunks{};
+  size_t begin = 0;
+  while (begin < text.size()) {
+    auto end = (chunks.size() + 1 == numberOfChunks) ? std::string_view::npos : text.find('\n', std::max(begin, chunks.size() * chunkSize + chunkSize - 1));
+    end = (end == std::string_view::npos) ? text.size() : end + 1;
+    chunks.push_back(text.substr(begin, end - begin));
+    begin = end;
+  }
+
+  return chunks;
+}
+
+/*
+ * Calls the given function for every line (without the newline character) of the given chunk until the function returns false.
+ */
+template<typename Function>
+void forEachLine(std::string_view const chunk, Function&& function)
 {
+  auto const* position = chunk.data();
+  auto const* const end = chunk.data() + chunk.size();
+
+  while (position < end) {
+    auto const* lineEnd = static_cast<char const*>(std::memchr(position, '\n', end - position));
+    if (!lineEnd) {
+      lineEnd = end;
+    }
+    if (!function(std::string_view(position, lineEnd - position))) {
+      return;
+    }
+    position = lineEnd + 1;
+  }
+}
+
+[[nodiscard]]
+bool isSeparator(char const character)
+{
+  return character == ',' || character == ' ' || character == '\t' || character == '\r';
+}
+
+[[nodiscard]]
+bool isEmptyLine(std::string_view const line)
+{
+  return std::all_of(line.begin(), line.end(), [](char character) { return character == ' ' || character == '\t' || character == '\r'; });
+}
+
+/*
+ * Parses the next value of a line (separated by commas and/or whitespaces). Returns the position after the value or nullptr if there is no valid value.
+ */
+[[nodiscard]]
+char const* parseValue(char const* position, char const* const lineEnd, TensorDataType& value)
+{
+  while (position < lineEnd && isSeparator(*position)) {
+    ++position;
+  }
+  if (position < lineEnd && *position == '+') { // not accepted by std::from_chars
+    ++position;
+  }
+
+  auto [valueEnd, error] = std::from_chars(position, lineEnd, value);
+  return (error == std::errc()) ? valueEnd : nullptr;
+}
+
+/*
+ * Skips the next value of a line without converting it. Returns the position after the value or nullptr if there is no value.
+ */
+[[nodiscard]]
+char const* skipValue(char const* position, char const* const lineEnd)
+{
+  while (position < lineEnd && isSeparator(*position)) {
+    ++position;
+  }
+  if (position == lineEnd) {
+    return nullptr;
+  }
+
+  while (position < lineEnd && !isSeparator(*position)) {
+    ++position;
+  }
+  return position;
+}
+
+/*
+ * Loads the input and output tensors [rows, columns] from NumPy arrays. Without a target file, the first columns of the input array are the
+ * input and the following columns the output variables. The tensors are views of the arrays (see NpyFile::Load).
+ */
+[[nodiscard]]
+std::optional<std::pair<torch::Tensor, torch::Tensor>> loadNpyTensors(FilePath const& inputPath, FilePath const& targetPath,
+                                                                      uint32_t const numberOfInputNodes, uint32_t const numberOfOutputNodes)
+{
+  auto inputArray = NpyFile::Load(inputPath);
+  if (!inputArray) {
+    return std::nullopt;
+  }
+
+  auto outputArray = std::make_optional(*inputArray);
+  auto firstOutputColumn = static_cast<int64_t>(numberOfInputNodes);
+  if (!targetPath.empty()) {
+    outputArray = NpyFile::Load(targetPath);
+    firstOutputColumn = 0;
+    if (!outputArray) {
+      return std::nullopt;
+    }
+  }
+
+  if (inputArray->size(0) != outputArray->size(0)) {
+    std::cout << "Error: The array in " << inputPath << " has " << inputArray->size(0) << " rows, but the array in " << targetPath << " has "
+              << outputArray->size(0) << " rows." << std::endl;
+    return std::nullopt;
+  }
+  if (inputArray->size(1) < numberOfInputNodes || outputArray->size(1) < firstOutputColumn + numberOfOutputNodes) {
+    std::cout << "Error: The array in " << (targetPath.empty() ? inputPath : targetPath) << " has not enough columns for " << numberOfInputNodes
+              << " input and " << numberOfOutputNodes << " output variables." << std::endl;
+    return std::nullopt;
+  }
+
+  return std::make_optional(std::make_pair(inputArray->narrow(1, 0, numberOfInputNodes), outputArray->narrow(1, firstOutputColumn, numberOfOutputNodes)));
+}
+
+/*
+ * Returns the file header for data without column names, e.g. "input1, input2, output1".
+ */
+[[nodiscard]]
+std::string createFileHeader(uint32_t const numberOfInputNodes, uint32_t const numberOfOutputNodes)
+{
+  std::string fileHeader{};
+  for (uint32_t i = 1; i <= numberOfInputNodes; ++i) {
+    fileHeader += (fileHeader.empty() ? "input" : ", input") + std::to_string(i);
+  }
+  for (uint32_t i = 1; i <= numberOfOutputNodes; ++i) {
+    fileHeader += (fileHeader.empty() ? "output" : ", output") + std::to_string(i);
+  }
+  return fileHeader;
+}
+
+/*
+ * Returns the rows of the given tensors as data points. The data points are views of the rows, no values are copied.
+ */
+[[nodiscard]]
+DataVector createDataPoints(torch::Tensor const& inputs, torch::Tensor const& outputs)
+{
+  auto inputRows = inputs.unbind(0);
+  auto outputRows = outputs.unbind(0);
+
   auto data = DataVector();
+  data.reserve(inputRows.size());
+  for (size_t i = 0; i < inputRows.size(); ++i) {
+    data.emplace_back(std::move(inputRows[i]), std::move(outputRows[i]));
+  }
+
+  return data;
+}
+
+/*
+ * Formats the given rows of the given row-major values as CSV lines into the given buffer (which is overwritten).
+ * The values are formatted like std::ostream with its default precision does, so the output is the same as with operator<<.
+ */
+void formatRows(std::string& buffer, TensorDataType const* inputs, TensorDataType const* outputs, int64_t const firstRow, int64_t const lastRow,
+                int64_t const numberOfInputs, int64_t const numberOfOutputs)
+{
+  auto const numberOfColumns = numberOfInputs + numberOfOutputs;
+  auto const separatorLength = sizeof(VALUE_SEPARATOR) - 1;
+  buffer.resize(static_cast<size_t>((lastRow - firstRow) * (numberOfColumns * (MAXIMUM_VALUE_LENGTH + separatorLength) + 1)));
+
+  auto* position = buffer.data();
+  auto* const end = buffer.data() + buffer.size();
+  auto writeValue = [&](TensorDataType const value, bool const first) {
+    if (!first) {
+      std::memcpy(position, VALUE_SEPARATOR, separatorLength);
+      position += separatorLength;
+    }
+    position = std::to_chars(position, end, value, std::chars_format::general, VALUE_PRECISION).ptr;
+  };
 
+  for (auto row = firstRow; row < lastRow; ++row) {
+    for (int64_t column = 0; column < numberOfInputs; ++column) {
+      writeValue(inputs[row * numberOfInputs + column], column == 0);
+    }
+    for (int64_t column = 0; column < numberOfOutputs; ++column) {
+      writeValue(outputs[row * numberOfOutputs + column], numberOfInputs == 0 && column == 0);
+    }
+    *position++ = '\n';
+  }
+
+  buffer.resize(static_cast<size_t>(position - buffer.data()));
+}
+
+/*
+ * Writes the given number as JSON value. JSON does not support NaN and infinity, these are written as null.
+ */
+void writeJsonNumber(std::ostream& stream, double value)
+{
+  if (std::isfinite(value)) {
+    stream << value;
+  } else {
+    stream << "null";
+  }
+}
+
+/*
+ * Writes the given text as JSON string, enclosed in quotes. Quotes, backslashes and control characters are escaped.
+ */
+void writeJsonString(std::ostream& stream, std::string_view const text)
+{
+  stream << '"';
+  for (auto const character : text) {
+    switch (character) {
+      case '"': stream << "\\\""; break;
+      case '\\': stream << "\\\\"; break;
+      case '\b': stream << "\\b"; break;
+      case '\f': stream << "\\f"; break;
+      case '\n': stream << "\\n"; break;
+      case '\r': stream << "\\r"; break;
+      case '\t': stream << "\\t"; break;
+      default:
+        if (static_cast<unsigned char>(character) < 0x20) {
+          char escapedCharacter[7];
+          std::snprintf(escapedCharacter, sizeof(escapedCharacter), "\\u%04x", static_cast<unsigned int>(static_cast<unsigned char>(character)));
+          stream << escapedCharacter;
+        } else {
+          stream << character;
+        }
+    }
+  }
+  stream << '"';
+}
+
+void writeJsonErrorStatistics(std::ostream& stream, std::vector<ErrorStatistics> const& statistics, std::vector<std::string> const& columnNames)
+{
+  stream << "[";
+  for (size_t i = 0; i < statistics.size(); ++i) {
+    auto const& columnStatistics = statistics[i];
+
+    stream << ((i == 0) ? "\n" : ",\n") << "      {\"column\": ";
+    writeJsonString(stream, (i < columnNames.size()) ? columnNames[i] : "output" + std::to_string(i + 1));
+    stream << ", \"count\": " << columnStatistics.count;
+    stream << ", \"meanAbsoluteError\": ";
+    writeJsonNumber(stream, columnStatistics.meanAbsoluteError);
+    stream << ", \"maxAbsoluteError\": ";
+    writeJsonNumber(stream, columnStatistics.maxAbsoluteError);
+    stream << ", \"maxRelativeError\": ";
+    writeJsonNumber(stream, columnStatistics.maxRelativeError);
+    stream << ", \"absoluteErrorP50\": ";
+    writeJsonNumber(stream, columnStatistics.absoluteErrorP50);
+    stream << ", \"absoluteErrorP95\": ";
+    writeJsonNumber(stream, columnStatistics.absoluteErrorP95);
+    stream << ", \"absoluteErrorP99\": ";
+    writeJsonNumber(stream, columnStatistics.absoluteErrorP99);
+    stream << "}";
+  }
+  stream << "\n    ]";
+}
+
+/*
+ * Returns the given text without the whitespaces at its beginning and end.
+ */
+[[nodiscard]]
+std::string trimmed(std::string const& text)
+{
+  auto first = text.find_first_not_of(" \t\r");
+  auto last = text.find_last_not_of(" \t\r");
+  return (first == std::string::npos) ? std::string() : text.substr(first, last - first + 1);
+}
+
+/*
+ * Splits the given text at every comma into its (trimmed) parts.
+ */
+[[nodiscard]]
+std::vector<std::string> splitAtCommas(std::string const& text)
+{
+  std::vector<std::string> parts{};
+  std::istringstream stream(text);
+  std::string part;
+
+  while (std::getline(stream, part, ',')) {
+    parts.push_back(trimmed(part));
+  }
+
+  return parts;
+}
+
+}
+
+std::optional<std::pair<torch::Tensor, torch::Tensor>> FileParser::ParseInputTensors(std::string const& path, uint32_t const numberOfInputNodes, uint32_t const numberOfOutputNodes,
+                                                                                      std::string& fileHeader, std::vector<std::string> const& inputColumnNames,
+                                                                                      std::vector<std::string> const& outputColumnNames, DataStatistics* statistics)
+{
   if (path.empty()) {
     std::cout << "Error: \"" << path << "\" is not a valid path to a file for the input data." << std::endl;
     return std::nullopt;
   }
 
-  std::ifstream inputFile(path);
-
-  std::string line;
-  if (!std::getline(inputFile, line)) {
+  MappedFile inputFile(path);
+  if (!inputFile.isOpen() || inputFile.size() == 0) {
     std::cout << "Error: Inputfile is empty or not valid." << std::endl;
     return std::nullopt;
   }
-  fileHeader = line;
 
-  while (std::getline(inputFile, line)) {
-    std::replace(line.begin(), line.end(), ',', ' '); // remove ',' from string
-    std::istringstream iss(line);
-    TensorDataType value;
-
-    // get input:
-    auto inTensor = torch::zeros(numberOfInputNodes, TORCH_DATA_TYPE);
-    for (uint32_t i = 0; i < numberOfInputNodes; ++i) {
-      if (!(iss >> value)) {
-        std::cout << "Error: Unable to parse input data." << std::endl;
-        return std::nullopt;
+  auto const content = inputFile.content();
+  auto const headerEnd = content.find('\n');
+  fileHeader = std::string(content.substr(0, headerEnd));
+  auto const body = (headerEnd == std::string_view::npos) ? std::string_view() : content.substr(headerEnd + 1);
+
+  auto const columns = SelectColumns(fileHeader, inputColumnNames, outputColumnNames, numberOfInputNodes, numberOfOutputNodes, path);
+  if (!columns) {
+    return std::nullopt;
+  }
+
+  return ParseLines(body, 2, numberOfInputNodes, numberOfOutputNodes, *columns, path, statistics); // the header is line 1
+}
+
+std::optional<std::pair<torch::Tensor, torch::Tensor>> FileParser::ParseLines(std::string_view const lines, uint64_t const firstLineNumber,
+                                                                               uint32_t const numberOfInputNodes, uint32_t const numberOfOutputNodes,
+                                                                               std::vector<uint32_t> const& columns, std::string const& path,
+                                                                               DataStatistics* statistics, ParseError* error)
+{
+  // Target of every field of a line up to the last selected column: the index in the input columns, followed by the output columns (or SKIPPED_FIELD):
+  std::vector<int64_t> fieldTargets{};
+  for (size_t i = 0; i < columns.size(); ++i) {
+    if (columns[i] >= fieldTargets.size()) {
+      fieldTargets.resize(columns[i] + 1, SKIPPED_FIELD);
+    }
+    fieldTargets[columns[i]] = static_cast<int64_t>(i);
+  }
+
+  auto const chunks = splitIntoChunks(lines);
+  auto const numberOfChunks = static_cast<int64_t>(chunks.size());
+
+  // First pass: count the lines and data points of every chunk to know where its data points are stored:
+  std::vector<uint64_t> numberOfLines(chunks.size(), 0);
+  std::vector<int64_t> numberOfRows(chunks.size(), 0);
+  at::parallel_for(0, numberOfChunks, CHUNK_GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (auto chunk = begin; chunk < end; ++chunk) {
+      forEachLine(chunks[chunk], [&](std::string_view line) {
+        ++numberOfLines[chunk];
+        if (!isEmptyLine(line)) {
+          ++numberOfRows[chunk];
+        }
+        return true;
+      });
+    }
+  });
+
+  std::vector<uint64_t> firstLine(chunks.size(), firstLineNumber);
+  std::vector<int64_t> firstRow(chunks.size(), 0);
+  for (size_t chunk = 1; chunk < chunks.size(); ++chunk) {
+    firstLine[chunk] = firstLine[chunk - 1] + numberOfLines[chunk - 1];
+    firstRow[chunk] = firstRow[chunk - 1] + numberOfRows[chunk - 1];
+  }
+  auto const totalNumberOfRows = chunks.empty() ? 0 : firstRow.back() + numberOfRows.back();
+
+  // Second pass: parse the values of every chunk straight into its rows of the two contiguous tensors:
+  auto inputs = torch::empty({totalNumberOfRows, numberOfInputNodes}, TORCH_DATA_TYPE);
+  auto outputs = torch::empty({totalNumberOfRows, numberOfOutputNodes}, TORCH_DATA_TYPE);
+  auto* inputData = inputs.data_ptr<TensorDataType>();
+  auto* outputData = outputs.data_ptr<TensorDataType>();
+
+  std::vector<std::optional<std::pair<uint64_t, std::string>>> errors(chunks.size()); // line number and message of the first error of every chunk
+  std::vector<DataStatistics> chunkStatistics{};
+  if (statistics) {
+    chunkStatistics.resize(chunks.size(), DataStatistics(numberOfInputNodes, numberOfOutputNodes, statistics->scalingThreshold()));
+  }
+  at::parallel_for(0, numberOfChunks, CHUNK_GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (auto chunk = begin; chunk < end; ++chunk) {
+      auto lineNumber = firstLine[chunk];
+      auto row = firstRow[chunk];
+
+      forEachLine(chunks[chunk], [&](std::string_view line) {
+        if (isEmptyLine(line)) {
+          ++lineNumber;
+          return true;
+        }
+
+        auto const* position = line.data();
+        auto const* const lineEnd = line.data() + line.size();
+        for (auto const target : fieldTargets) {
+          if (target == SKIPPED_FIELD) {
+            position = skipValue(position, lineEnd);
+          } else {
+            auto& value = (target < numberOfInputNodes) ? inputData[row * numberOfInputNodes + target]
+                                                        : outputData[row * numberOfOutputNodes + target - numberOfInputNodes];
+            position = parseValue(position, lineEnd, value);
+
+            // std::from_chars accepts nan and inf, they would corrupt the min/max values and the normalization:
+            if (position && !std::isfinite(value)) {
+              errors[chunk] = std::make_pair(lineNumber, "Non-finite value (nan or inf)");
+              return false;
+            }
+          }
+
+          if (!position) {
+            auto const* message = (target == SKIPPED_FIELD) ? "Missing columns" :
+                                  (target < numberOfInputNodes) ? "Unable to parse input data" : "Unable to parse output data";
+            errors[chunk] = std::make_pair(lineNumber, message);
+            return false;
+          }
+        }
+
+        if (statistics) {
+          chunkStatistics[chunk].addRow(inputData + row * numberOfInputNodes, outputData + row * numberOfOutputNodes);
+        }
+
+        ++lineNumber;
+        ++row;
+        return true;
+      });
+    }
+  });
+
+  for (auto const& chunkError : errors) {
+    if (chunkError) {
+      if (error) {
+        *error = *chunkError;
+      } else {
+        std::cout << "Error: " << chunkError->second << " in line " << chunkError->first << " of " << path << "." << std::endl;
       }
-      inTensor[i] = value;
+      return std::nullopt;
+    }
+  }
+
+  for (auto const& chunk : chunkStatistics) {
+    statistics->merge(chunk);
+  }
+
+  return std::make_optional(std::make_pair(inputs, outputs));
+}
+
+std::optional<std::vector<uint32_t>> FileParser::SelectColumns(std::string& fileHeader, std::vector<std::string> const& inputColumnNames,
+                                                               std::vector<std::string> const& outputColumnNames, uint32_t const numberOfInputNodes,
+                                                               uint32_t const numberOfOutputNodes, std::string const& path)
+{
+  std::vector<uint32_t> columns{};
+  if (inputColumnNames.empty() && outputColumnNames.empty()) {
+    for (uint32_t i = 0; i < numberOfInputNodes + numberOfOutputNodes; ++i) {
+      columns.push_back(i);
     }
+    return std::make_optional(columns);
+  }
+
+  // Empty fields of the data lines are skipped, so an empty column name would shift the following columns:
+  auto const columnNames = SplitFileHeader(fileHeader);
+  auto const emptyColumnName = std::find(columnNames.begin(), columnNames.end(), std::string());
+  if (emptyColumnName != columnNames.end()) {
+    std::cout << "Error: Column " << (emptyColumnName - columnNames.begin() + 1) << " of the file header of " << path
+              << " has no name, the columns can not be selected by name." << std::endl;
+    return std::nullopt;
+  }
 
-    // get output:
-    auto outTensor = torch::zeros(numberOfOutputNodes, TORCH_DATA_TYPE);
-    for (uint32_t i = 0; i < numberOfOutputNodes; ++i) {
-      if (!(iss >> value)) {
-        std::cout << "Error: Unable to parse output data." << std::endl;
+  std::string selectedFileHeader{};
+  for (auto const* names : {&inputColumnNames, &outputColumnNames}) {
+    for (auto const& name : *names) {
+      auto column = std::find(columnNames.begin(), columnNames.end(), name);
+      if (column == columnNames.end()) {
+        std::cout << "Error: There is no column " << name << " in the file header of " << path << "." << std::endl;
         return std::nullopt;
       }
-      outTensor[i] = value;
+
+      columns.push_back(static_cast<uint32_t>(column - columnNames.begin()));
+      selectedFileHeader += (selectedFileHeader.empty() ? "" : ", ") + name;
     }
+  }
 
-    data.emplace_back(std::make_pair(inTensor, outTensor));
+  fileHeader = selectedFileHeader;
+  return std::make_optional(columns);
+}
+
+std::optional<DataVector> FileParser::ParseInputFile(std::string const& path, uint32_t const numberOfInputNodes, uint32_t const numberOfOutputNodes, std::string& fileHeader,
+                                                     std::vector<std::string> const& inputColumnNames, std::vector<std::string> const& outputColumnNames)
+{
+  if (NpyFile::HasNpyExtension(path)) {
+    auto tensors = loadNpyTensors(path, FilePath(), numberOfInputNodes, numberOfOutputNodes);
+    if (!tensors) {
+      return std::nullopt;
+    }
+    fileHeader = createFileHeader(numberOfInputNodes, numberOfOutputNodes);
+    return std::make_optional(createDataPoints(tensors->first, tensors->second));
   }
 
-  inputFile.close();
-  return std::make_optional(data);
+  auto tensors = ParseInputTensors(path, numberOfInputNodes, numberOfOutputNodes, fileHeader, inputColumnNames, outputColumnNames);
+  if (!tensors) {
+    return std::nullopt;
+  }
+
+  return std::make_optional(createDataPoints(tensors->first, tensors->second));
+}
+
+std::optional<DataVector> FileParser::LoadInputData(ProgramOptions const& options, std::string& fileHeader, DataStatistics& statistics)
+{
+  auto const scalingThreshold = ScalingThreshold::FromOptions(options);
+  statistics = DataStatistics(options.NumberOfInputVariables, options.NumberOfOutputVariables, scalingThreshold);
+
+  if (NpyFile::HasNpyExtension(options.InputDataFilePath)) {
+    auto tensors = loadNpyTensors(options.InputDataFilePath, options.TargetDataFilePath, options.NumberOfInputVariables, options.NumberOfOutputVariables);
+    if (!tensors) {
+      return std::nullopt;
+    }
+    fileHeader = createFileHeader(options.NumberOfInputVariables, options.NumberOfOutputVariables);
+    statistics = DataStatistics::Collect(tensors->first, tensors->second, scalingThreshold);
+    return std::make_optional(createDataPoints(tensors->first, tensors->second));
+  }
+
+  if (options.UseDatasetCache) {
+    auto cachedDataset = DatasetCache::Load(options.InputDataFilePath, options.NumberOfInputVariables, options.NumberOfOutputVariables,
+                                            options.InputColumnNames, options.OutputColumnNames);
+    if (cachedDataset) {
+      fileHeader = cachedDataset->fileHeader;
+      // The statistics of the cache are only collected again if the cache was created with another scaling threshold:
+      statistics = cachedDataset->statistics.hasScalingThreshold(scalingThreshold)
+                     ? std::move(cachedDataset->statistics)
+                     : DataStatistics::Collect(cachedDataset->inputs, cachedDataset->outputs, scalingThreshold);
+      return std::make_optional(createDataPoints(cachedDataset->inputs, cachedDataset->outputs));
+    }
+    if (options.DebugOutput) {
+      std::cout << "The dataset cache is missing or outdated and is (re)created." << std::endl;
+    }
+  }
+
+  auto tensors = ParseInputTensors(options.InputDataFilePath, options.NumberOfInputVariables, options.NumberOfOutputVariables, fileHeader,
+                                   options.InputColumnNames, options.OutputColumnNames, &statistics);
+  if (!tensors) {
+    return std::nullopt;
+  }
+
+  if (options.UseDatasetCache && !DatasetCache::Save(options.InputDataFilePath, fileHeader, tensors->first, tensors->second, statistics,
+                                                     options.InputColumnNames, options.OutputColumnNames)) {
+    std::cout << "[Warning] Could not create the dataset cache " << DatasetCache::CachePath(options.InputDataFilePath) << std::endl;
+  }
+
+  return std::make_optional(createDataPoints(tensors->first, tensors->second));
 }
 
 void FileParser::SaveData(DataVector const& data, std::string const& outputFilePath, std::string const& fileHeader)
@@ -59,28 +571,66 @@ void FileParser::SaveData(DataVector const& data, std::string const& outputFileP
   if (data.empty()) {
     return;
   }
-  std::ofstream outputFile(outputFilePath);
-
-  outputFile << fileHeader << "\n";
 
+  std::vector<torch::Tensor> inputRows{};
+  std::vector<torch::Tensor> outputRows{};
+  inputRows.reserve(data.size());
+  outputRows.reserve(data.size());
   for (auto const& [inputTensor, outputTensor] : data) {
-    outputFile << inputTensor[0].item<TensorDataType>();
+    inputRows.push_back(inputTensor.to(TORCH_DATA_TYPE));
+    outputRows.push_back(outputTensor.to(TORCH_DATA_TYPE));
+  }
 
-    for (int64_t i = 1; i < inputTensor.size(0); ++i) {
-      outputFile << ", " << inputTensor[i].item<TensorDataType>();
-    }
+  SaveTensors(torch::stack(inputRows), torch::stack(outputRows), outputFilePath, fileHeader);
+}
+
+void FileParser::SaveTensors(torch::Tensor const& inputs, torch::Tensor const& outputs, std::string const& outputFilePath, std::string const& fileHeader)
+{
+  if (inputs.size(0) == 0) {
+    return;
+  }
 
-    for (int64_t i = 0; i < outputTensor.size(0); ++i) {
-      outputFile << ", " << outputTensor[i].item<TensorDataType>();
+  if (NpyFile::HasNpyExtension(outputFilePath)) {
+    if (!NpyFile::Save(torch::cat({inputs.to(TORCH_DATA_TYPE), outputs.to(TORCH_DATA_TYPE)}, 1), outputFilePath)) {
+      std::cout << "[Warning] Could not save " << outputFilePath << std::endl;
     }
+    return;
+  }
 
-    outputFile << "\n";
+  auto const inputValues = inputs.to(TORCH_DATA_TYPE).contiguous();
+  auto const outputValues = outputs.to(TORCH_DATA_TYPE).contiguous();
+  auto const numberOfRows = inputValues.size(0);
+  auto const numberOfInputs = inputValues.size(1);
+  auto const numberOfOutputs = outputValues.size(1);
+  auto const* inputData = inputValues.data_ptr<TensorDataType>();
+  auto const* outputData = outputValues.data_ptr<TensorDataType>();
+
+  std::ofstream outputFile(outputFilePath);
+  outputFile << fileHeader << "\n";
+
+  // Every thread formats one block of rows at a time, the blocks are written in order after each round:
+  auto const numberOfBlocksPerRound = static_cast<int64_t>(std::max(1, at::get_num_threads()));
+  std::vector<std::string> blocks(static_cast<size_t>(numberOfBlocksPerRound));
+  for (int64_t roundBegin = 0; roundBegin < numberOfRows; roundBegin += numberOfBlocksPerRound * ROWS_PER_WRITE_BLOCK) {
+    auto const numberOfBlocks = std::min(numberOfBlocksPerRound, (numberOfRows - roundBegin + ROWS_PER_WRITE_BLOCK - 1) / ROWS_PER_WRITE_BLOCK);
+
+    at::parallel_for(0, numberOfBlocks, CHUNK_GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      for (auto block = begin; block < end; ++block) {
+        auto const firstRow = roundBegin + block * ROWS_PER_WRITE_BLOCK;
+        auto const lastRow = std::min(numberOfRows, firstRow + ROWS_PER_WRITE_BLOCK);
+        formatRows(blocks[static_cast<size_t>(block)], inputData, outputData, firstRow, lastRow, numberOfInputs, numberOfOutputs);
+      }
+    });
+
+    for (int64_t block = 0; block < numberOfBlocks; ++block) {
+      outputFile.write(blocks[static_cast<size_t>(block)].data(), static_cast<std::streamsize>(blocks[static_cast<size_t>(block)].size()));
+    }
   }
 
   outputFile.close();
 }
 
-void FileParser::SaveProgressData(ProgressVector const& data, std::string const& filePath)
+void FileParser::SaveProgressData(ProgressVector const& data, std::string const& filePath, bool const saveLearnRate)
 {
   if (data.empty()) {
     return;
@@ -91,17 +641,163 @@ void FileParser::SaveProgressData(ProgressVector const& data, std::string const&
   for (size_t i = 1; i <= data[0].r2Score.size(); ++i) {
     outputFile << LEARN_PROGRESS_R2_SCORE_HEADER_PART << i;
   }
+  if (saveLearnRate) {
+    outputFile << LEARN_PROGRESS_LEARN_RATE_HEADER_PART;
+  }
   outputFile << "\n";
 
-  for (auto const& [epoch, r2score, meanSquaredError, elapsedTimeInMS] : data) {
+  for (auto const& [epoch, r2score, meanSquaredError, elapsedTimeInMS, learnRate] : data) {
     outputFile << epoch << ", " << meanSquaredError << ", " << elapsedTimeInMS;
     for (auto score : r2score) {
       outputFile << ", " << score;
     }
+    if (saveLearnRate) {
+      outputFile << ", " << learnRate;
+    }
+    outputFile << "\n";
+  }
+
+  outputFile.close();
+}
+
+void FileParser::SaveErrorReports(std::vector<std::pair<std::string, ErrorReport>> const& reports, std::string const& filePath, std::vector<std::string> const& columnNames)
+{
+  std::ofstream outputFile(filePath);
+  outputFile << std::setprecision(std::numeric_limits<double>::max_digits10);
+
+  outputFile << "{";
+  for (size_t i = 0; i < reports.size(); ++i) {
+    auto const& [name, report] = reports[i];
+
+    outputFile << ((i == 0) ? "\n" : ",\n") << "  ";
+    writeJsonString(outputFile, name);
+    outputFile << ": {\n";
+    outputFile << "    \"normalized\": ";
+    writeJsonErrorStatistics(outputFile, report.normalized, columnNames);
+    outputFile << ",\n    \"denormalized\": ";
+    writeJsonErrorStatistics(outputFile, report.denormalized, columnNames);
+    outputFile << "\n  }";
+  }
+  outputFile << "\n}\n";
+
+  outputFile.close();
+}
+
+void FileParser::SaveTelemetryReport(TelemetryReport const& report, std::string const& filePath)
+{
+  std::ofstream outputFile(filePath);
+  outputFile << std::setprecision(std::numeric_limits<double>::max_digits10);
+
+  outputFile << "{\n";
+  outputFile << "  \"totalWallTimeInMS\": " << report.totalWallTimeInMS << ",\n";
+  outputFile << "  \"totalCpuTimeInMS\": " << report.totalCpuTimeInMS << ",\n";
+  outputFile << "  \"peakResidentSetBytes\": " << report.peakResidentSetBytes << ",\n";
+  outputFile << "  \"datasetBytes\": " << report.datasetBytes << ",\n";
+
+  outputFile << "  \"phases\": [";
+  for (size_t i = 0; i < report.phases.size(); ++i) {
+    auto const& phase = report.phases[i];
+    outputFile << ((i == 0) ? "\n" : ",\n") << "    {\"name\": ";
+    writeJsonString(outputFile, phase.name);
+    outputFile << ", \"wallTimeInMS\": " << phase.wallTimeInMS <<
+                  ", \"cpuTimeInMS\": " << phase.cpuTimeInMS << "}";
+  }
+  outputFile << "\n  ],\n";
+
+  outputFile << "  \"epochs\": [";
+  for (size_t i = 0; i < report.epochs.size(); ++i) {
+    auto const& epoch = report.epochs[i];
+    outputFile << ((i == 0) ? "\n" : ",\n") << "    {\"epoch\": " << epoch.epoch << ", \"samples\": " << epoch.numberOfSamples <<
+                  ", \"samplesPerSecond\": ";
+    writeJsonNumber(outputFile, epoch.samplesPerSecond);
+    outputFile << "}";
+  }
+  outputFile << "\n  ]\n";
+
+  outputFile << "}\n";
+  outputFile.close();
+}
+
+std::optional<SweepSpecification> FileParser::ParseSweepSpecification(std::string const& path)
+{
+  std::ifstream inputFile(path);
+  if (!inputFile) {
+    std::cout << "Error: Could not open the sweep specification " << path << std::endl;
+    return std::nullopt;
+  }
+
+  auto specification = SweepSpecification();
+  std::string line;
+  uint32_t lineNumber = 0;
+
+  while (std::getline(inputFile, line)) {
+    ++lineNumber;
+    line = line.substr(0, line.find('#'));
+    if (line.find_first_not_of(" \t\r") == std::string::npos) {
+      continue;
+    }
+
+    auto separator = line.find('=');
+    if (separator == std::string::npos) {
+      std::cout << "Error: Line " << lineNumber << " of the sweep specification has no '='." << std::endl;
+      return std::nullopt;
+    }
+
+    // The values are separated by commas only, a whitespace inside a name or value is an error (e.g. a missing comma):
+    auto name = trimmed(line.substr(0, separator));
+    auto values = splitAtCommas(line.substr(separator + 1));
+    auto isInvalid = [](std::string const& text) { return text.empty() || text.find_first_of(" \t\r,") != std::string::npos; };
+    if (isInvalid(name) || values.empty() || std::any_of(values.begin(), values.end(), isInvalid)) {
+      std::cout << "Error: Line " << lineNumber << " of the sweep specification is not valid: " << line
+                << " (expected: <parameter> = <value>, <value>, ...; parameters: layers, nodes, learnRate, scaling, optimizer, miniBatch)" << std::endl;
+      return std::nullopt;
+    }
+
+    specification.emplace_back(name, values);
+  }
+
+  inputFile.close();
+  return std::make_optional(specification);
+}
+
+void FileParser::SaveSweepResults(SweepResultVector const& results, std::string const& filePath, bool const saveValidationError)
+{
+  std::ofstream outputFile(filePath);
+
+  outputFile << SWEEP_RESULT_FILE_HEADER;
+  if (saveValidationError) {
+    outputFile << SWEEP_RESULT_VALIDATION_HEADER_PART;
+  }
+  outputFile << "\n";
+
+  for (auto const& result : results) {
+    outputFile << result.rank << ", " << result.numberOfLayers << ", " << result.numberOfNodesPerLayer << ", " << result.learnRate << ", " <<
+                  result.scaling << ", " << result.optimizer << ", " << (result.miniBatchSize ? std::to_string(*result.miniBatchSize) : "none") << ", " <<
+                  result.epochs << ", " << result.meanSquaredError;
+    if (saveValidationError) {
+      outputFile << ", " << result.validationMeanSquaredError;
+    }
     outputFile << "\n";
   }
 
   outputFile.close();
 }
 
+std::vector<std::string> FileParser::SplitFileHeader(std::string const& fileHeader)
+{
+  std::vector<std::string> columnNames{};
+  std::istringstream headerStream(fileHeader);
+  std::string columnName;
+
+  // Like the values of the data lines, names without commas between them are separated by whitespaces:
+  if (fileHeader.find(',') == std::string::npos) {
+    while (headerStream >> columnName) {
+      columnNames.push_back(columnName);
+    }
+    return columnNames;
+  }
+
+  return splitAtCommas(fileHeader);
+}
+
 }
@@ -0,0 +1,66 @@
+#include "Utilities/mappedfile.h"
+
+#include <algorithm>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Utilities {
+
+MappedFile::MappedFile(std::string const& path, bool const copyOnWrite)
+{
+  auto fileDescriptor = ::open(path.c_str(), O_RDONLY);
+  if (fileDescriptor < 0) {
+    return;
+  }
+
+  struct stat fileStatus{};
+  if (fstat(fileDescriptor, &fileStatus) != 0) {
+    ::close(fileDescriptor);
+    return;
+  }
+
+  length = static_cast<size_t>(fileStatus.st_size);
+  if (length == 0) { // empty files cannot be mapped
+    open = true;
+    ::close(fileDescriptor);
+    return;
+  }
+
+  auto mapping = mmap(nullptr, length, copyOnWrite ? PROT_READ | PROT_WRITE : PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+  ::close(fileDescriptor); // the mapping keeps the file open
+
+  if (mapping == MAP_FAILED) {
+    length = 0;
+    return;
+  }
+
+  madvise(mapping, length, copyOnWrite ? MADV_WILLNEED : MADV_SEQUENTIAL); // copy-on-write mappings are used like loaded data, not read once
+  address = static_cast<char const*>(mapping);
+  open = true;
+  writable = copyOnWrite;
+}
+
+void MappedFile::release(std::string_view const part) const
+{
+  if (!address || writable || part.empty()) {
+    return;
+  }
+
+  // The pages at both ends may be shared with the neighbouring parts, releasing them only costs a new read:
+  auto const pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  auto const begin = static_cast<size_t>(part.data() - address) / pageSize * pageSize;
+  auto const end = std::min(length, static_cast<size_t>(part.data() - address) + part.size());
+  madvise(const_cast<char*>(address) + begin, end - begin, MADV_DONTNEED);
+}
+
+MappedFile::~MappedFile()
+{
+  if (address) {
+    munmap(const_cast<char*>(address), length);
+  }
+}
+
+}
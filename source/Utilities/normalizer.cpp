@@ -0,0 +1,56 @@
+#include "Utilities/normalizer.h"
+
+namespace Utilities {
+
+Normalizer::Normalizer(MinMaxVector const& minMaxVector, TensorDataType const newMinValue, TensorDataType const newMaxValue) :
+  normalizedMinValue(newMinValue), normalizedMaxValue(newMaxValue)
+{
+  // normalized = (X - min) / (max - min) * (newMax - newMin) + newMin = X * scale + offset:
+  std::vector<TensorDataType> scale{};
+  std::vector<TensorDataType> offset{};
+  std::vector<TensorDataType> inverseScale{};
+  std::vector<TensorDataType> inverseOffset{};
+  for (auto const& [min, max] : minMaxVector) {
+    auto const columnScale = (newMaxValue - newMinValue) / (max - min);
+    scale.push_back(columnScale);
+    offset.push_back(newMinValue - min * columnScale);
+
+    auto const columnInverseScale = (max - min) / (newMaxValue - newMinValue);
+    inverseScale.push_back(columnInverseScale);
+    inverseOffset.push_back(min - newMinValue * columnInverseScale);
+  }
+
+  normalizationScale = torch::tensor(scale, TORCH_DATA_TYPE);
+  normalizationOffset = torch::tensor(offset, TORCH_DATA_TYPE);
+  denormalizationScale = torch::tensor(inverseScale, TORCH_DATA_TYPE);
+  denormalizationOffset = torch::tensor(inverseOffset, TORCH_DATA_TYPE);
+}
+
+void Normalizer::normalize(torch::Tensor& tensor) const
+{
+  if (!isValid() || tensor.size(-1) != normalizationScale.size(0)) {
+    return;
+  }
+
+  multiplyAdd(tensor, normalizationScale, normalizationOffset);
+}
+
+void Normalizer::denormalize(torch::Tensor& tensor, bool const limitValues) const
+{
+  if (!isValid() || tensor.size(-1) != denormalizationScale.size(0)) {
+    return;
+  }
+
+  if (limitValues) {
+    tensor.clamp_(normalizedMinValue, normalizedMaxValue);
+  }
+  multiplyAdd(tensor, denormalizationScale, denormalizationOffset);
+}
+
+void Normalizer::multiplyAdd(torch::Tensor& tensor, torch::Tensor const& scale, torch::Tensor const& offset)
+{
+  // Works column-wise on single data points [columns] as well as on batches [rows, columns], the result is written into the tensor:
+  at::addcmul_out(tensor, offset.to(tensor.scalar_type()), tensor, scale.to(tensor.scalar_type()));
+}
+
+}
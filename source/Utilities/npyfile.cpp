@@ -0,0 +1,225 @@
+#include "Utilities/npyfile.h"
+#include "Utilities/mappedfile.h"
+
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+namespace Utilities {
+
+namespace {
+
+const std::string NPY_FILE_EXTENSION = ".npy";
+const char NPY_MAGIC[6] = {'\x93', 'N', 'U', 'M', 'P', 'Y'};
+const size_t NPY_PREAMBLE_SIZE = 8; // magic and version, followed by the length of the header (2 bytes in version 1, 4 bytes in later versions)
+const size_t NPY_HEADER_ALIGNMENT = 64;
+const std::string NPY_DOUBLE_DESCRIPTION = "<f8";
+
+/*
+ * Element type of an array with its size in bytes.
+ */
+struct ElementType
+{
+  torch::ScalarType scalarType;
+  size_t size;
+};
+
+/*
+ * Parsed header of a .npy file.
+ */
+struct ArrayHeader
+{
+  std::string description;
+  bool fortranOrder;
+  std::vector<int64_t> shape;
+  size_t dataOffset;
+};
+
+[[nodiscard]]
+std::optional<ElementType> elementType(std::string const& description)
+{
+  // Little-endian or native (all supported platforms are little-endian) byte order:
+  if (description.size() != 3 || (description[0] != '<' && description[0] != '=')) {
+    return std::nullopt;
+  }
+
+  auto const type = description.substr(1);
+  if (type == "f8") {
+    return ElementType{torch::kDouble, 8};
+  } else if (type == "f4") {
+    return ElementType{torch::kFloat, 4};
+  } else if (type == "i8") {
+    return ElementType{torch::kLong, 8};
+  } else if (type == "i4") {
+    return ElementType{torch::kInt, 4};
+  }
+  return std::nullopt;
+}
+
+/*
+ * Returns the value of the given key of the header dictionary (everything after the colon), e.g. "'<f8', 'fortran_order': ..." for "descr".
+ */
+[[nodiscard]]
+std::optional<std::string_view> dictionaryValue(std::string_view const dictionary, std::string const& key)
+{
+  auto position = dictionary.find("'" + key + "'");
+  if (position == std::string_view::npos) {
+    position = dictionary.find("\"" + key + "\"");
+  }
+  if (position == std::string_view::npos) {
+    return std::nullopt;
+  }
+
+  position = dictionary.find(':', position + key.size() + 2);
+  if (position == std::string_view::npos) {
+    return std::nullopt;
+  }
+  position = dictionary.find_first_not_of(' ', position + 1);
+  return (position == std::string_view::npos) ? std::nullopt : std::make_optional(dictionary.substr(position));
+}
+
+/*
+ * Parses the header of the given .npy file content. Returns std::nullopt if the content is not a valid .npy file.
+ */
+[[nodiscard]]
+std::optional<ArrayHeader> parseHeader(std::string_view const content)
+{
+  if (content.size() < NPY_PREAMBLE_SIZE + 2 || std::memcmp(content.data(), NPY_MAGIC, sizeof(NPY_MAGIC)) != 0) {
+    return std::nullopt;
+  }
+
+  auto const majorVersion = static_cast<uint8_t>(content[6]);
+  auto const lengthSize = (majorVersion == 1) ? size_t(2) : size_t(4);
+  if (majorVersion < 1 || majorVersion > 3 || content.size() < NPY_PREAMBLE_SIZE + lengthSize) {
+    return std::nullopt;
+  }
+
+  size_t headerLength = 0;
+  for (size_t i = 0; i < lengthSize; ++i) { // little-endian
+    headerLength |= static_cast<size_t>(static_cast<uint8_t>(content[NPY_PREAMBLE_SIZE + i])) << (8 * i);
+  }
+
+  ArrayHeader header{};
+  header.dataOffset = NPY_PREAMBLE_SIZE + lengthSize + headerLength;
+  if (content.size() < header.dataOffset) {
+    return std::nullopt;
+  }
+  auto const dictionary = content.substr(NPY_PREAMBLE_SIZE + lengthSize, headerLength);
+
+  auto const description = dictionaryValue(dictionary, "descr");
+  auto const fortranOrder = dictionaryValue(dictionary, "fortran_order");
+  auto const shape = dictionaryValue(dictionary, "shape");
+  if (!description || !fortranOrder || !shape || description->empty() || shape->front() != '(') {
+    return std::nullopt;
+  }
+
+  auto const quote = description->front();
+  auto const descriptionEnd = description->find(quote, 1);
+  if ((quote != '\'' && quote != '"') || descriptionEnd == std::string_view::npos) {
+    return std::nullopt; // structured arrays are described by a list
+  }
+  header.description = std::string(description->substr(1, descriptionEnd - 1));
+  header.fortranOrder = fortranOrder->substr(0, 4) == "True";
+
+  auto const shapeEnd = shape->find(')');
+  if (shapeEnd == std::string_view::npos) {
+    return std::nullopt;
+  }
+  auto const* position = shape->data() + 1;
+  auto const* const end = shape->data() + shapeEnd;
+  while (position < end) {
+    while (position < end && (*position == ' ' || *position == ',')) {
+      ++position;
+    }
+    if (position == end) {
+      break;
+    }
+
+    int64_t dimension = 0;
+    auto [dimensionEnd, error] = std::from_chars(position, end, dimension);
+    if (error != std::errc() || dimension < 0) {
+      return std::nullopt;
+    }
+    header.shape.push_back(dimension);
+    position = dimensionEnd;
+  }
+
+  return std::make_optional(header);
+}
+
+}
+
+bool NpyFile::HasNpyExtension(FilePath const& path)
+{
+  return path.size() >= NPY_FILE_EXTENSION.size() && path.compare(path.size() - NPY_FILE_EXTENSION.size(), NPY_FILE_EXTENSION.size(), NPY_FILE_EXTENSION) == 0;
+}
+
+std::optional<torch::Tensor> NpyFile::Load(FilePath const& path)
+{
+  auto file = std::make_shared<MappedFile>(path, true);
+  if (!file->isOpen()) {
+    std::cout << "Error: Could not open " << path << "." << std::endl;
+    return std::nullopt;
+  }
+
+  auto const header = parseHeader(file->content());
+  if (!header) {
+    std::cout << "Error: " << path << " is not a valid .npy file." << std::endl;
+    return std::nullopt;
+  }
+
+  auto const type = elementType(header->description);
+  if (!type || header->shape.empty() || header->shape.size() > 2) {
+    std::cout << "Error: The array in " << path << " is not supported (" << header->description << ", " << header->shape.size() << " dimensions). "
+              << "Only one- and two-dimensional little-endian arrays of float64, float32, int64 and int32 values are supported." << std::endl;
+    return std::nullopt;
+  }
+
+  auto const rows = header->shape[0];
+  auto const columns = (header->shape.size() == 2) ? header->shape[1] : int64_t(1);
+  if (file->size() < header->dataOffset + static_cast<size_t>(rows * columns) * type->size) {
+    std::cout << "Error: " << path << " is incomplete, it is smaller than its array." << std::endl;
+    return std::nullopt;
+  }
+
+  auto* data = file->writableData() + header->dataOffset;
+  auto const options = torch::TensorOptions().dtype(type->scalarType);
+
+  // Zero-copy: the tensor uses the mapping directly and releases it when the tensor is destroyed:
+  if (type->scalarType == TORCH_DATA_TYPE && !header->fortranOrder && header->dataOffset % type->size == 0) {
+    return std::make_optional(torch::from_blob(data, {rows, columns}, [file](void*) mutable { file.reset(); }, options));
+  }
+
+  // All other arrays are copied (and converted) while the mapping exists:
+  if (header->fortranOrder) {
+    return std::make_optional(torch::from_blob(data, {columns, rows}, options).t().contiguous().to(TORCH_DATA_TYPE));
+  }
+  return std::make_optional(torch::from_blob(data, {rows, columns}, options).to(TORCH_DATA_TYPE, false, true));
+}
+
+bool NpyFile::Save(torch::Tensor const& values, FilePath const& path)
+{
+  auto const data = values.to(torch::kDouble).contiguous();
+
+  std::ostringstream dictionary;
+  dictionary << "{'descr': '" << NPY_DOUBLE_DESCRIPTION << "', 'fortran_order': False, 'shape': (" << data.size(0) << ", " << data.size(1) << "), }";
+  auto header = dictionary.str();
+
+  // The header is padded with spaces and ends with a newline character, so the data starts at a multiple of NPY_HEADER_ALIGNMENT bytes:
+  auto const unpaddedSize = NPY_PREAMBLE_SIZE + 2 + header.size() + 1;
+  header += std::string((NPY_HEADER_ALIGNMENT - unpaddedSize % NPY_HEADER_ALIGNMENT) % NPY_HEADER_ALIGNMENT, ' ') + "\n";
+  char const preamble[] = {NPY_MAGIC[0], NPY_MAGIC[1], NPY_MAGIC[2], NPY_MAGIC[3], NPY_MAGIC[4], NPY_MAGIC[5], 1, 0,
+                           static_cast<char>(header.size() & 0xff), static_cast<char>(header.size() >> 8)};
+
+  std::ofstream outputFile(path, std::ios::binary);
+  outputFile.write(preamble, sizeof(preamble));
+  outputFile.write(header.data(), static_cast<std::streamsize>(header.size()));
+  outputFile.write(reinterpret_cast<char const*>(data.data_ptr<double>()), static_cast<std::streamsize>(data.nbytes()));
+
+  return static_cast<bool>(outputFile);
+}
+
+}
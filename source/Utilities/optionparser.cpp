@@ -1,5 +1,8 @@
 #include "Utilities/optionparser.h"
+#include "Utilities/fileparser.h"
+#include "Utilities/npyfile.h"
 
+#include <algorithm>
 #include <iostream>
 
 namespace Utilities {
@@ -14,6 +17,8 @@ std::optional<ProgramOptions> OptionParser::ParseCommandLineParameters(int argc,
 {
   auto options = Utilities::ProgramOptions();
   bool validationPercentageSet = false;
+  bool numberOfInputVariablesSet = false;
+  bool numberOfOutputVariablesSet = false;
 
   for (int i = 1; i < argc; ++i) {
     std::string inputString (argv[i]);
@@ -36,6 +41,13 @@ std::optional<ProgramOptions> OptionParser::ParseCommandLineParameters(int argc,
         }
         options.InputDataFilePath = std::string(argv[++i]);
         break;
+      case CLIParameters::TargetFilePath:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        options.TargetDataFilePath = std::string(argv[++i]);
+        break;
       case CLIParameters::NumberOfInputVariables:
         if (i + 1 >= argc) {
           std::cout << "Not enough parameters after " << inputString << std::endl;
@@ -43,6 +55,7 @@ std::optional<ProgramOptions> OptionParser::ParseCommandLineParameters(int argc,
         }
         try {
           options.NumberOfInputVariables = std::stoul(argv[++i]);
+          numberOfInputVariablesSet = true;
         } catch (const std::invalid_argument& e) {
           std::cout << "Could not convert " << std::string(argv[i]) << " to integer. Reason: " << e.what() << std::endl;
           return std::nullopt;
@@ -58,6 +71,39 @@ std::optional<ProgramOptions> OptionParser::ParseCommandLineParameters(int argc,
         }
         try {
           options.NumberOfOutputVariables = std::stoul(argv[++i]);
+          numberOfOutputVariablesSet = true;
+        } catch (const std::invalid_argument& e) {
+          std::cout << "Could not convert " << std::string(argv[i]) << " to integer. Reason: " << e.what() << std::endl;
+          return std::nullopt;
+        } catch (const std::out_of_range& e) {
+          std::cout << std::string(argv[i]) << " is out of range. Error: " << e.what() << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::InputColumns:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        options.InputColumnNames = FileParser::SplitFileHeader(argv[++i]);
+        break;
+      case CLIParameters::OutputColumns:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        options.OutputColumnNames = FileParser::SplitFileHeader(argv[++i]);
+        break;
+      case CLIParameters::Cache:
+        options.UseDatasetCache = true;
+        break;
+      case CLIParameters::MemoryBudget:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.MemoryBudgetInMB = std::stoull(argv[++i]);
         } catch (const std::invalid_argument& e) {
           std::cout << "Could not convert " << std::string(argv[i]) << " to integer. Reason: " << e.what() << std::endl;
           return std::nullopt;
@@ -193,6 +239,51 @@ std::optional<ProgramOptions> OptionParser::ParseCommandLineParameters(int argc,
           return std::nullopt;
         }
         break;
+      case CLIParameters::ValidateEvery:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.ValidationInterval = std::stoul(argv[++i]);
+        } catch (const std::invalid_argument& e) {
+          std::cout << "Could not convert " << std::string(argv[i]) << " to integer. Reason: " << e.what() << std::endl;
+          return std::nullopt;
+        } catch (const std::out_of_range& e) {
+          std::cout << std::string(argv[i]) << " is out of range. Error: " << e.what() << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::ValidationPatience:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.ValidationPatience = std::stoul(argv[++i]);
+        } catch (const std::invalid_argument& e) {
+          std::cout << "Could not convert " << std::string(argv[i]) << " to integer. Reason: " << e.what() << std::endl;
+          return std::nullopt;
+        } catch (const std::out_of_range& e) {
+          std::cout << std::string(argv[i]) << " is out of range. Error: " << e.what() << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::KFold:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.NumberOfFolds = std::stoul(argv[++i]);
+        } catch (const std::invalid_argument& e) {
+          std::cout << "Could not convert " << std::string(argv[i]) << " to integer. Reason: " << e.what() << std::endl;
+          return std::nullopt;
+        } catch (const std::out_of_range& e) {
+          std::cout << std::string(argv[i]) << " is out of range. Error: " << e.what() << std::endl;
+          return std::nullopt;
+        }
+        break;
       case CLIParameters::OutValues:
         if (i + 1 >= argc) {
           std::cout << "Not enough parameters after " << inputString << std::endl;
@@ -217,6 +308,20 @@ std::optional<ProgramOptions> OptionParser::ParseCommandLineParameters(int argc,
       case CLIParameters::PrintBehaviour:
         options.PrintBehaviour = true;
         break;
+      case CLIParameters::OutReport:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        options.OutputReportFilePath = std::string(argv[++i]);
+        break;
+      case CLIParameters::Metrics:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        options.MetricsFilePath = std::string(argv[++i]);
+        break;
       case CLIParameters::Threads:
         if (i + 1 >= argc) {
           std::cout << "Not enough parameters after " << inputString << std::endl;
@@ -232,6 +337,19 @@ std::optional<ProgramOptions> OptionParser::ParseCommandLineParameters(int argc,
           return std::nullopt;
         }
         break;
+      case CLIParameters::Precision: {
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        auto precision = PrecisionMap.find(argv[++i]);
+        if (precision == PrecisionMap.end()) {
+          std::cout << "Unknown precision: " << std::string(argv[i]) << ". Available precisions: double, float" << std::endl;
+          return std::nullopt;
+        }
+        options.Precision = precision->second;
+        break;
+      }
       case CLIParameters::InputMinMax:
         if (i + 1 >= argc) {
           std::cout << "Not enough parameters after " << inputString << std::endl;
@@ -253,11 +371,186 @@ std::optional<ProgramOptions> OptionParser::ParseCommandLineParameters(int argc,
         }
         try {
           options.LearnRate = std::stod(std::string(argv[++i]));
+          options.LearnRateSet = true;
+        } catch (std::exception const&) {
+          std::cout << "Could not parse " << std::string(argv[i]) << " to double." << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::Optimizer: {
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        auto optimizer = OptimizerTypeMap.find(argv[++i]);
+        if (optimizer == OptimizerTypeMap.end()) {
+          std::cout << "Unknown optimizer: " << std::string(argv[i]) << ". Available optimizers: sgd, momentum, adam, rmsprop, lbfgs" << std::endl;
+          return std::nullopt;
+        }
+        options.Optimizer = optimizer->second;
+        break;
+      }
+      case CLIParameters::Momentum:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.Momentum = std::stod(std::string(argv[++i]));
+        } catch (std::exception const&) {
+          std::cout << "Could not parse " << std::string(argv[i]) << " to double." << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::WeightDecay:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.WeightDecay = std::stod(std::string(argv[++i]));
         } catch (std::exception const&) {
           std::cout << "Could not parse " << std::string(argv[i]) << " to double." << std::endl;
           return std::nullopt;
         }
         break;
+      case CLIParameters::AdamBetas:
+        if (i + 2 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.AdamBeta1 = std::stod(std::string(argv[++i]));
+          options.AdamBeta2 = std::stod(std::string(argv[++i]));
+        } catch (std::exception const&) {
+          std::cout << "Could not parse " << std::string(argv[i]) << " to double." << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::RMSpropAlpha:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.RMSpropAlpha = std::stod(std::string(argv[++i]));
+        } catch (std::exception const&) {
+          std::cout << "Could not parse " << std::string(argv[i]) << " to double." << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::LBFGSMaxIterations:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.LBFGSMaxIterations = std::stoul(argv[++i]);
+        } catch (const std::invalid_argument& e) {
+          std::cout << "Could not convert " << std::string(argv[i]) << " to integer. Reason: " << e.what() << std::endl;
+          return std::nullopt;
+        } catch (const std::out_of_range& e) {
+          std::cout << std::string(argv[i]) << " is out of range. Error: " << e.what() << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::LBFGSHistorySize:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.LBFGSHistorySize = std::stoul(argv[++i]);
+        } catch (const std::invalid_argument& e) {
+          std::cout << "Could not convert " << std::string(argv[i]) << " to integer. Reason: " << e.what() << std::endl;
+          return std::nullopt;
+        } catch (const std::out_of_range& e) {
+          std::cout << std::string(argv[i]) << " is out of range. Error: " << e.what() << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::LearnRateSchedule: {
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        auto schedule = LearnRateScheduleTypeMap.find(argv[++i]);
+        if (schedule == LearnRateScheduleTypeMap.end()) {
+          std::cout << "Unknown learning rate schedule: " << std::string(argv[i]) << ". Available schedules: constant, step, cosine, exponential, plateau" << std::endl;
+          return std::nullopt;
+        }
+        options.LearnRateSchedule = schedule->second;
+        break;
+      }
+      case CLIParameters::WarmupEpochs:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.WarmupEpochs = std::stoul(argv[++i]);
+        } catch (const std::invalid_argument& e) {
+          std::cout << "Could not convert " << std::string(argv[i]) << " to integer. Reason: " << e.what() << std::endl;
+          return std::nullopt;
+        } catch (const std::out_of_range& e) {
+          std::cout << std::string(argv[i]) << " is out of range. Error: " << e.what() << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::LearnRateStepSize:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.LearnRateStepSize = std::stoul(argv[++i]);
+        } catch (const std::invalid_argument& e) {
+          std::cout << "Could not convert " << std::string(argv[i]) << " to integer. Reason: " << e.what() << std::endl;
+          return std::nullopt;
+        } catch (const std::out_of_range& e) {
+          std::cout << std::string(argv[i]) << " is out of range. Error: " << e.what() << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::LearnRateGamma:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.LearnRateGamma = std::stod(std::string(argv[++i]));
+        } catch (std::exception const&) {
+          std::cout << "Could not parse " << std::string(argv[i]) << " to double." << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::MinLearnRate:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.MinLearnRate = std::stod(std::string(argv[++i]));
+        } catch (std::exception const&) {
+          std::cout << "Could not parse " << std::string(argv[i]) << " to double." << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::LearnRatePatience:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.LearnRatePatience = std::stoul(argv[++i]);
+        } catch (const std::invalid_argument& e) {
+          std::cout << "Could not convert " << std::string(argv[i]) << " to integer. Reason: " << e.what() << std::endl;
+          return std::nullopt;
+        } catch (const std::out_of_range& e) {
+          std::cout << std::string(argv[i]) << " is out of range. Error: " << e.what() << std::endl;
+          return std::nullopt;
+        }
+        break;
       case CLIParameters::TimeoutMinutes:
         if (i + 1 >= argc) {
           std::cout << "Not enough parameters after " << inputString << std::endl;
@@ -312,6 +605,50 @@ std::optional<ProgramOptions> OptionParser::ParseCommandLineParameters(int argc,
         }
         options.SaveProgressFilePath = std::string(argv[++i]);
         break;
+      case CLIParameters::ProgressEvery:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.ProgressInterval = std::stoul(argv[++i]);
+        } catch (const std::invalid_argument& e) {
+          std::cout << "Could not convert " << std::string(argv[i]) << " to integer. Reason: " << e.what() << std::endl;
+          return std::nullopt;
+        } catch (const std::out_of_range& e) {
+          std::cout << std::string(argv[i]) << " is out of range. Error: " << e.what() << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::CheckpointEvery:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.CheckpointInterval = std::stoul(argv[++i]);
+        } catch (const std::invalid_argument& e) {
+          std::cout << "Could not convert " << std::string(argv[i]) << " to integer. Reason: " << e.what() << std::endl;
+          return std::nullopt;
+        } catch (const std::out_of_range& e) {
+          std::cout << std::string(argv[i]) << " is out of range. Error: " << e.what() << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::CheckpointDirectory:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        options.CheckpointDirectory = std::string(argv[++i]);
+        break;
+      case CLIParameters::Resume:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        options.ResumeDirectory = std::string(argv[++i]);
+        break;
       case CLIParameters::Seed:
         if (i + 1 >= argc) {
           std::cout << "Not enough parameters after " << inputString << std::endl;
@@ -372,13 +709,175 @@ std::optional<ProgramOptions> OptionParser::ParseCommandLineParameters(int argc,
           return std::nullopt;
         }
         break;
+      case CLIParameters::MiniBatch:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.MiniBatchSize = std::stoul(argv[++i]);
+        } catch (const std::invalid_argument& e) {
+          std::cout << "Could not convert " << std::string(argv[i]) << " to integer. Reason: " << e.what() << std::endl;
+          return std::nullopt;
+        } catch (const std::out_of_range& e) {
+          std::cout << std::string(argv[i]) << " is out of range. Error: " << e.what() << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::LossEvaluationInterval:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.LossEvaluationInterval = std::stoul(argv[++i]);
+        } catch (const std::invalid_argument& e) {
+          std::cout << "Could not convert " << std::string(argv[i]) << " to integer. Reason: " << e.what() << std::endl;
+          return std::nullopt;
+        } catch (const std::out_of_range& e) {
+          std::cout << std::string(argv[i]) << " is out of range. Error: " << e.what() << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::Shuffle:
+        options.ShuffleData = true;
+        break;
+      case CLIParameters::Prefetch:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.PrefetchBatches = std::stoul(argv[++i]);
+        } catch (const std::invalid_argument& e) {
+          std::cout << "Could not convert " << std::string(argv[i]) << " to integer. Reason: " << e.what() << std::endl;
+          return std::nullopt;
+        } catch (const std::out_of_range& e) {
+          std::cout << std::string(argv[i]) << " is out of range. Error: " << e.what() << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::DataParallel:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.DataParallelWorkers = std::stoul(argv[++i]);
+        } catch (const std::invalid_argument& e) {
+          std::cout << "Could not convert " << std::string(argv[i]) << " to integer. Reason: " << e.what() << std::endl;
+          return std::nullopt;
+        } catch (const std::out_of_range& e) {
+          std::cout << std::string(argv[i]) << " is out of range. Error: " << e.what() << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::ParallelMode: {
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        auto parallelMode = ParallelModeTypeMap.find(argv[++i]);
+        if (parallelMode == ParallelModeTypeMap.end()) {
+          std::cout << "Unknown parallel mode: " << std::string(argv[i]) << ". Available modes: allreduce, hogwild" << std::endl;
+          return std::nullopt;
+        }
+        options.ParallelMode = parallelMode->second;
+        break;
+      }
+      case CLIParameters::Sweep:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        options.SweepSpecificationFilePath = std::string(argv[++i]);
+        break;
+      case CLIParameters::SweepParallel:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.SweepParallelTrials = std::stoul(argv[++i]);
+        } catch (const std::invalid_argument& e) {
+          std::cout << "Could not convert " << std::string(argv[i]) << " to integer. Reason: " << e.what() << std::endl;
+          return std::nullopt;
+        } catch (const std::out_of_range& e) {
+          std::cout << std::string(argv[i]) << " is out of range. Error: " << e.what() << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::SweepRungEpochs:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.SweepRungEpochs = std::stoul(argv[++i]);
+        } catch (const std::invalid_argument& e) {
+          std::cout << "Could not convert " << std::string(argv[i]) << " to integer. Reason: " << e.what() << std::endl;
+          return std::nullopt;
+        } catch (const std::out_of_range& e) {
+          std::cout << std::string(argv[i]) << " is out of range. Error: " << e.what() << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::SweepOut:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        options.SweepResultFilePath = std::string(argv[++i]);
+        break;
       case CLIParameters::DebugOutput:
         options.DebugOutput = true;
         break;
     }
   }
 
+  // The line search of L-BFGS scales its steps, the default learning rate of the other optimizers would only shorten them:
+  if (options.Optimizer == OptimizerType::LBFGS && !options.LearnRateSet) {
+    options.LearnRate = DefaultValues::LBFGS_LEARN_RATE;
+  }
+
+  // The all-reduce workers wait for each other after every step, single data points would spend most of the time in the synchronization:
+  bool const allReduceMiniBatchDefaulted = options.DataParallelWorkers > 1 && options.ParallelMode == ParallelModeType::AllReduce &&
+                                           !options.MiniBatchSize.has_value() && !options.BatchVariable.has_value() &&
+                                           options.Optimizer != OptimizerType::LBFGS;
+  if (allReduceMiniBatchDefaulted) {
+    options.MiniBatchSize = DefaultValues::ALL_REDUCE_MINI_BATCH_SIZE;
+  }
+
   // Sanity checks:
+  if (options.InputColumnNames.empty() != options.OutputColumnNames.empty()) {
+    std::cout << "The input and output columns have to be selected together with --inputColumns and --outputColumns." << std::endl;
+    return std::nullopt;
+  }
+
+  if (!options.InputColumnNames.empty()) {
+    std::vector<std::string> selectedColumnNames(options.InputColumnNames);
+    selectedColumnNames.insert(selectedColumnNames.end(), options.OutputColumnNames.begin(), options.OutputColumnNames.end());
+    std::sort(selectedColumnNames.begin(), selectedColumnNames.end());
+
+    if (std::find(selectedColumnNames.begin(), selectedColumnNames.end(), std::string()) != selectedColumnNames.end()) {
+      std::cout << "The selected column names must not be empty." << std::endl;
+      return std::nullopt;
+    }
+    auto duplicate = std::adjacent_find(selectedColumnNames.begin(), selectedColumnNames.end());
+    if (duplicate != selectedColumnNames.end()) {
+      std::cout << "The column " << *duplicate << " is selected more than once." << std::endl;
+      return std::nullopt;
+    }
+    if ((numberOfInputVariablesSet && options.NumberOfInputVariables != options.InputColumnNames.size()) ||
+        (numberOfOutputVariablesSet && options.NumberOfOutputVariables != options.OutputColumnNames.size())) {
+      std::cout << "The number of input or output variables does not match the number of selected columns." << std::endl;
+      return std::nullopt;
+    }
+
+    options.NumberOfInputVariables = static_cast<uint32_t>(options.InputColumnNames.size());
+    options.NumberOfOutputVariables = static_cast<uint32_t>(options.OutputColumnNames.size());
+  }
+
   if (options.MixedScalingInputVariable > options.NumberOfInputVariables) {
     std::cout << "Input variable " << options.MixedScalingInputVariable << " is not usable for mixed scaling, because there are only " << options.NumberOfInputVariables << " variables available." << std::endl;
     return std::nullopt;
@@ -404,6 +903,51 @@ std::optional<ProgramOptions> OptionParser::ParseCommandLineParameters(int argc,
     return std::nullopt;
   }
 
+  if (options.MiniBatchSize.has_value() && options.MiniBatchSize.value() == 0) {
+    std::cout << "Invalid mini-batch size: " << options.MiniBatchSize.value() << ". Please input a number > 0." << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.MiniBatchSize.has_value() && options.BatchVariable.has_value()) {
+    std::cout << "Mini-batch training can not be combined with batch training over an input variable." << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.LossEvaluationInterval == 0) {
+    std::cout << "Invalid loss evaluation interval: " << options.LossEvaluationInterval << ". Please input a number > 0." << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.ValidationInterval.has_value() && options.ValidationInterval.value() == 0) {
+    std::cout << "Invalid validation interval: " << options.ValidationInterval.value() << ". Please input a number > 0." << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.ValidationInterval.has_value() && !options.ValidateAfterTraining && !options.NumberOfFolds.has_value()) {
+    std::cout << "Early stopping with --validateEvery needs a validation set. Activate validation with --validate or --kFold" << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.ValidationPatience == 0) {
+    std::cout << "Invalid validation patience: " << options.ValidationPatience << ". Please input a number > 0." << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.ProgressInterval == 0) {
+    std::cout << "Invalid progress interval: " << options.ProgressInterval << ". Please input a number > 0." << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.CheckpointInterval.has_value() && options.CheckpointInterval.value() == 0) {
+    std::cout << "Invalid checkpoint interval: " << options.CheckpointInterval.value() << ". Please input a number > 0." << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.CheckpointInterval.has_value() && options.CheckpointDirectory == DefaultValues::CHECKPOINT_DIRECTORY) {
+    std::cout << "Checkpoints need a directory. Set it with --checkpointDir" << std::endl;
+    return std::nullopt;
+  }
+
   if (options.NumberOfThreads < 1) {
     std::cout << "Invalid number of threads: " << options.NumberOfThreads << ". Please input a number > 0." << std::endl;
     return std::nullopt;
@@ -414,14 +958,181 @@ std::optional<ProgramOptions> OptionParser::ParseCommandLineParameters(int argc,
     return std::nullopt;
   }
 
+  if (options.Momentum < 0.0 || options.WeightDecay < 0.0 || options.RMSpropAlpha < 0.0) {
+    std::cout << "Momentum, weight decay and rmsprop alpha should be >= 0." << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.AdamBeta1 < 0.0 || options.AdamBeta1 >= 1.0 || options.AdamBeta2 < 0.0 || options.AdamBeta2 >= 1.0) {
+    std::cout << "Invalid adam betas: " << options.AdamBeta1 << " " << options.AdamBeta2 << ". Both values should be in [0, 1)." << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.LBFGSMaxIterations == 0 || options.LBFGSHistorySize == 0) {
+    std::cout << "The maximum number of L-BFGS iterations and the L-BFGS history size should be > 0." << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.PrefetchBatches == 0) {
+    std::cout << "The number of prefetched batches should be > 0." << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.DataParallelWorkers == 0) {
+    std::cout << "The number of data parallel workers should be > 0." << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.DataParallelWorkers > 1 && (options.BatchVariable.has_value() || options.Optimizer == OptimizerType::LBFGS)) {
+    std::cout << "Data parallel training can not be combined with batch training or the lbfgs optimizer." << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.LearnRateStepSize == 0) {
+    std::cout << "The learning rate step size should be > 0." << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.LearnRateGamma <= 0.0 || options.LearnRateGamma > 1.0) {
+    std::cout << "Invalid learning rate gamma: " << options.LearnRateGamma << ". The value should be in (0, 1]." << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.MinLearnRate < 0.0 || options.MinLearnRate > options.LearnRate) {
+    std::cout << "Invalid minimum learning rate: " << options.MinLearnRate << ". The value should be between 0 and the learning rate." << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.Optimizer == OptimizerType::LBFGS && (options.MiniBatchSize.has_value() || options.BatchVariable.has_value())) {
+    std::cout << "The lbfgs optimizer always trains on the full data set and can not be combined with mini-batch or batch training." << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.SweepParallelTrials == 0 || options.SweepRungEpochs == 0) {
+    std::cout << "The number of parallel sweep trials and the number of epochs of the first sweep round should be > 0." << std::endl;
+    return std::nullopt;
+  }
+
+  bool sweepActive = options.SweepSpecificationFilePath != DefaultValues::SWEEP_SPECIFICATION_FILE_PATH;
+  if (sweepActive && (options.CheckpointInterval.has_value() || options.ResumeDirectory != DefaultValues::RESUME_DIRECTORY)) {
+    std::cout << "A sweep can not be combined with checkpoints or a resumed training." << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.NumberOfFolds.has_value() && options.NumberOfFolds.value() < 2) {
+    std::cout << "Invalid number of folds: " << options.NumberOfFolds.value() << ". Please input a number > 1." << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.NumberOfFolds.has_value() && (sweepActive || options.CheckpointInterval.has_value() || options.ResumeDirectory != DefaultValues::RESUME_DIRECTORY)) {
+    std::cout << "A cross-validation can not be combined with a sweep, checkpoints or a resumed training." << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.MemoryBudgetInMB.has_value() && options.MemoryBudgetInMB.value() == 0) {
+    std::cout << "Invalid memory budget: " << options.MemoryBudgetInMB.value() << ". Please input a number > 0." << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.MemoryBudgetInMB.has_value() && (options.ValidateAfterTraining || options.NumberOfFolds.has_value() || sweepActive ||
+      options.BatchVariable.has_value() || options.DataParallelWorkers > 1 || options.Optimizer == OptimizerType::LBFGS ||
+      options.LogLinScaling || options.LogSqrtScaling || options.SaveProgressFilePath != DefaultValues::PROGRESS_FILE_PATH ||
+      options.InteractiveMode || options.PrintBehaviour || options.OutputValuesFilePath != DefaultValues::OUTPUT_VALUE ||
+      options.OutputDiffFilePath != DefaultValues::OUTPUT_DIFF || options.OutputRelativeDiffFilePath != DefaultValues::OUTPUT_RELATIVE_DIFF ||
+      options.OutputReportFilePath != DefaultValues::OUTPUT_REPORT)) {
+    std::cout << "A streamed training (--memoryBudget) can only be combined with the training options, checkpoints and the outputs of the weights, "
+                 "the min/max values and the metrics. It does not support --validate, --kFold, --sweep, --batchVariable, --dataParallel, the lbfgs optimizer, "
+                 "--logLinScaling, --logSqrtScaling, --saveProgress, --interactive, --printBehaviour, --outValues, --outDiff, --outRelativeDiff or --outReport."
+              << std::endl;
+    return std::nullopt;
+  }
+
+  auto const npyInput = NpyFile::HasNpyExtension(options.InputDataFilePath);
+  if (options.TargetDataFilePath != DefaultValues::TARGET_DATA_FILE_PATH && (!npyInput || !NpyFile::HasNpyExtension(options.TargetDataFilePath))) {
+    std::cout << "Separate targets (--targets) are only supported for NumPy arrays: the input and the target file have to be .npy files." << std::endl;
+    return std::nullopt;
+  }
+
+  if (npyInput && (!options.InputColumnNames.empty() || options.MemoryBudgetInMB.has_value())) {
+    std::cout << "NumPy arrays (.npy files) have no column names and are loaded completely, they can not be combined with --inputColumns, --outputColumns or --memoryBudget." << std::endl;
+    return std::nullopt;
+  }
+
   // Warnings:
+  if (allReduceMiniBatchDefaulted) {
+    std::cout << "[Warning] No mini-batch size was set, the allreduce workers train on mini-batches of " << DefaultValues::ALL_REDUCE_MINI_BATCH_SIZE
+              << " data points. Set the size with --miniBatch" << std::endl;
+  }
+
+  if (options.LossEvaluationInterval > 1) {
+    std::cout << "[Warning] The stopping criteria (--epsilon, --numberOfDeteriorations) and the plateau schedule only use the exact mean squared errors, "
+                 "a deterioration is counted at most every " << options.LossEvaluationInterval << " epochs." << std::endl;
+  }
+
+  if (options.MemoryBudgetInMB.has_value() && options.LossEvaluationInterval == DefaultValues::LOSS_EVALUATION_INTERVAL) {
+    std::cout << "[Warning] Every exact mean squared error of a streamed training reads the input file again. Reduce this with --lossEvaluationInterval" << std::endl;
+  }
+
+  if (npyInput && options.UseDatasetCache) {
+    std::cout << "[Warning] NumPy arrays (.npy files) are loaded without parsing, the dataset cache (--cache) is not used." << std::endl;
+  }
+
   if (validationPercentageSet && !options.ValidateAfterTraining) {
     std::cout << "[Warning] A validation percentage was set, but the validation mode is not active! Activate validation with --validate" << std::endl;
   }
 
-  if (!options.InteractiveMode && !options.PrintBehaviour && options.OutputDiffFilePath == DefaultValues::OUTPUT_DIFF &&
+  if (options.ShuffleData && (options.BatchVariable.has_value() || options.Optimizer == OptimizerType::LBFGS)) {
+    std::cout << "[Warning] Shuffling has no effect on batch training and on the lbfgs optimizer." << std::endl;
+  }
+
+  if (options.ProgressInterval != DefaultValues::PROGRESS_INTERVAL && options.SaveProgressFilePath == DefaultValues::PROGRESS_FILE_PATH) {
+    std::cout << "[Warning] A progress interval was set, but the progress is not saved. Save the progress with --saveProgress" << std::endl;
+  }
+
+  if (options.CheckpointDirectory != DefaultValues::CHECKPOINT_DIRECTORY && !options.CheckpointInterval.has_value()) {
+    std::cout << "[Warning] A checkpoint directory was set, but no checkpoint interval. Set the interval with --checkpointEvery" << std::endl;
+  }
+
+  if (options.ResumeDirectory != DefaultValues::RESUME_DIRECTORY && options.InputNetworkParameters != DefaultValues::INPUT_NETWORK_PARAMETERS) {
+    std::cout << "[Warning] The weights of --inWeights are replaced by the weights of the resumed checkpoint." << std::endl;
+  }
+
+  if (options.Optimizer == OptimizerType::LBFGS && options.LearnRateSet && options.LearnRate != DefaultValues::LBFGS_LEARN_RATE) {
+    std::cout << "[Warning] The line search of the lbfgs optimizer scales its steps, a learning rate other than " << DefaultValues::LBFGS_LEARN_RATE
+              << " only shortens or lengthens them." << std::endl;
+  }
+
+  if (options.ResumeDirectory != DefaultValues::RESUME_DIRECTORY && options.DataParallelWorkers > 1 && options.ParallelMode == ParallelModeType::Hogwild) {
+    std::cout << "[Warning] A resumed hogwild training is only approximately the same as an uninterrupted one: the updates of the workers interleave randomly "
+                 "and only the optimizer state of the first worker is saved." << std::endl;
+  }
+
+  if (!sweepActive && options.SweepResultFilePath != DefaultValues::SWEEP_RESULT_FILE_PATH) {
+    std::cout << "[Warning] A sweep result file was set, but no sweep is active. Start a sweep with --sweep" << std::endl;
+  }
+
+  if (sweepActive && (options.InteractiveMode || options.PrintBehaviour || options.OutputValuesFilePath != DefaultValues::OUTPUT_VALUE ||
+      options.OutputDiffFilePath != DefaultValues::OUTPUT_DIFF || options.OutputRelativeDiffFilePath != DefaultValues::OUTPUT_RELATIVE_DIFF ||
+      options.OutputReportFilePath != DefaultValues::OUTPUT_REPORT || options.SaveProgressFilePath != DefaultValues::PROGRESS_FILE_PATH ||
+      options.MetricsFilePath != DefaultValues::METRICS_FILE_PATH)) {
+    std::cout << "[Warning] A sweep only saves the weights (--outWeights), the min/max values (--outMinMax) and the results (--sweepOut) of the trials. Other outputs are ignored." << std::endl;
+  }
+
+  if (options.NumberOfFolds.has_value() && (options.ValidateAfterTraining || validationPercentageSet)) {
+    std::cout << "[Warning] The cross-validation uses its folds as validation sets. The options --validate and --validatePercentage are ignored." << std::endl;
+  }
+
+  if (options.NumberOfFolds.has_value() && (options.InteractiveMode || options.PrintBehaviour || options.OutputValuesFilePath != DefaultValues::OUTPUT_VALUE ||
+      options.OutputDiffFilePath != DefaultValues::OUTPUT_DIFF || options.OutputRelativeDiffFilePath != DefaultValues::OUTPUT_RELATIVE_DIFF ||
+      options.OutputReportFilePath != DefaultValues::OUTPUT_REPORT || options.SaveProgressFilePath != DefaultValues::PROGRESS_FILE_PATH ||
+      options.OutputNetworkParameters != DefaultValues::OUTPUT_NETWORK_PARAMETERS || options.MetricsFilePath != DefaultValues::METRICS_FILE_PATH)) {
+    std::cout << "[Warning] A cross-validation only reports the metrics of the folds and saves the min/max values (--outMinMax). Other outputs are ignored." << std::endl;
+  }
+
+  if (!sweepActive && !options.NumberOfFolds.has_value() && !options.InteractiveMode && !options.PrintBehaviour && options.OutputDiffFilePath == DefaultValues::OUTPUT_DIFF &&
       options.OutputRelativeDiffFilePath == DefaultValues::OUTPUT_RELATIVE_DIFF && options.OutputMinMaxFilePath == DefaultValues::OUTPUT_MIN_MAX_FILE_PATH &&
-      options.OutputNetworkParameters == DefaultValues::OUTPUT_NETWORK_PARAMETERS && options.OutputValuesFilePath == DefaultValues::OUTPUT_VALUE) {
+      options.OutputNetworkParameters == DefaultValues::OUTPUT_NETWORK_PARAMETERS && options.OutputValuesFilePath == DefaultValues::OUTPUT_VALUE &&
+      options.OutputReportFilePath == DefaultValues::OUTPUT_REPORT && options.MetricsFilePath == DefaultValues::METRICS_FILE_PATH) {
     std::cout << "[Warning] No option was set to output something. For available commands try --help" << std::endl;
   }
 
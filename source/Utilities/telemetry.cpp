@@ -0,0 +1,89 @@
+#include "Utilities/telemetry.h"
+
+#include <sys/resource.h>
+
+namespace Utilities {
+
+namespace {
+
+[[nodiscard]]
+double cpuTimeInMS(std::clock_t const start, std::clock_t const end)
+{
+  return 1000.0 * static_cast<double>(end - start) / CLOCKS_PER_SEC;
+}
+
+[[nodiscard]]
+double wallTimeInMS(std::chrono::steady_clock::time_point const start, std::chrono::steady_clock::time_point const end)
+{
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+[[nodiscard]]
+uint64_t peakResidentSetBytes()
+{
+  rusage usage{};
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+
+#ifdef __APPLE__
+  return static_cast<uint64_t>(usage.ru_maxrss); // bytes on macOS
+#else
+  return static_cast<uint64_t>(usage.ru_maxrss) * 1024; // kilobytes on Linux
+#endif
+}
+
+}
+
+Telemetry::Telemetry() :
+  wallStart(std::chrono::steady_clock::now()), cpuStart(std::clock())
+{
+}
+
+void Telemetry::startPhase(std::string const& name)
+{
+  endPhase();
+  runningPhase = RunningPhase{name, std::chrono::steady_clock::now(), std::clock()};
+}
+
+void Telemetry::endPhase()
+{
+  if (!runningPhase) {
+    return;
+  }
+
+  phases.emplace_back(PhaseTiming{
+    runningPhase->name,
+    wallTimeInMS(runningPhase->wallStart, std::chrono::steady_clock::now()),
+    cpuTimeInMS(runningPhase->cpuStart, std::clock())
+  });
+  runningPhase.reset();
+}
+
+void Telemetry::recordEpoch(uint32_t const epoch, uint64_t const numberOfSamples, std::chrono::steady_clock::duration const duration)
+{
+  auto seconds = std::chrono::duration<double>(duration).count();
+  epochs.emplace_back(EpochThroughput{epoch, numberOfSamples, (seconds > 0.0) ? numberOfSamples / seconds : 0.0});
+}
+
+void Telemetry::recordDatasetBytes(DataVector const& data)
+{
+  datasetBytes = 0;
+  for (auto const& [inputTensor, outputTensor] : data) {
+    datasetBytes += inputTensor.nbytes() + outputTensor.nbytes();
+  }
+}
+
+TelemetryReport Telemetry::createReport() const
+{
+  return TelemetryReport{
+    wallTimeInMS(wallStart, std::chrono::steady_clock::now()),
+    cpuTimeInMS(cpuStart, std::clock()),
+    peakResidentSetBytes(),
+    datasetBytes,
+    phases,
+    epochs
+  };
+}
+
+}
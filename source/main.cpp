@@ -1,4 +1,6 @@
+#include "NeuralNetwork/crossvalidation.h"
 #include "NeuralNetwork/logic.h"
+#include "NeuralNetwork/sweep.h"
 #include "Utilities/optionparser.h"
 
 int main(int argc, char* argv[]) {
@@ -7,6 +9,30 @@ int main(int argc, char* argv[]) {
     return 1;
   }
 
+  if (options->SweepSpecificationFilePath != Utilities::DefaultValues::SWEEP_SPECIFICATION_FILE_PATH) {
+    NeuralNetwork::Sweep sweep{};
+    if (!sweep.performSweep(*options)) {
+      return 2;
+    }
+    return 0;
+  }
+
+  if (options->NumberOfFolds.has_value()) {
+    NeuralNetwork::CrossValidation crossValidation{};
+    if (!crossValidation.performCrossValidation(*options)) {
+      return 2;
+    }
+    return 0;
+  }
+
+  if (options->MemoryBudgetInMB.has_value()) {
+    NeuralNetwork::Logic logic{};
+    if (!logic.performStreamingRequest(*options)) {
+      return 2;
+    }
+    return 0;
+  }
+
   NeuralNetwork::Logic logic{};
   if (!logic.performUserRequest(*options)) {
     return 2;